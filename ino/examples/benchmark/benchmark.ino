@@ -0,0 +1,153 @@
+/**
+ ********************************************************************************
+ * @file    benchmark.ino
+ * @author  Carlos Egea
+ * @date    18/10/2026
+ * @brief   Per-operation cycle counts of the TEA5767 class, printed as JSON.
+ *
+ * Same report as the SDK benchmark firmware (schema tea5767-bench/1), measured
+ * through the public class API against the module on the default I2C pins.
+ * Operations with the same name measure the same thing in both reports, see
+ * sdk/benchmark.c. Encode, decode and read are private to the class and only
+ * appear in the SDK report.
+ ********************************************************************************
+ */
+
+/************************************
+ * INCLUDES
+ ************************************/
+#include <tea5767_i2c.h>
+
+/************************************
+ * PRIVATE MACROS AND DEFINES
+ ************************************/
+#define BENCH_ITERATIONS 200 // Calls per operation
+#define BENCH_SCANS 3 // Full band scans
+#define BENCH_STABLE_READS 3 // Equal level readings needed to call the tuner settled
+#define BENCH_SETTLE_TIMEOUT_US 200000 // Give up waiting for the lock after this
+
+/************************************
+ * PRIVATE TYPEDEFS
+ ************************************/
+typedef void (*bench_op_fn)(int i);
+
+typedef struct {
+    const char *name;   // Operation name in the report
+    bench_op_fn fn;     // Wrapper exercising the operation
+    uint32_t n;         // Calls
+    uint64_t min;       // Cycles
+    uint64_t max;
+    uint64_t total;
+    uint64_t total_us;
+} bench_entry_t;
+
+tea5767_i2c radio(EU_BAND);
+TEA5767_status_t status;
+
+/************************************
+ * STATIC FUNCTIONS
+ ************************************/
+static float bench_freq(int i) {
+    return 88.0 + (i % 200) * 0.1;
+}
+
+static void op_write(int i) {
+    radio.tea5767_setStation(bench_freq(i));
+}
+
+static void op_status(int i) {
+    radio.tea5767_getStatus(&status);
+}
+
+static void op_mute(int i) {
+    radio.tea5767_setMute(i & 1);
+}
+
+static void op_profile(int i) {
+    radio.tea5767_setAudioProfile((i & 1) ? TEA5767_AUDIO_PROFILE_WEAK : TEA5767_AUDIO_PROFILE_DEFAULT);
+}
+
+// Tune, then poll the status until the IF counter is in range and the level reads the same a few times
+static void op_settle(int i) {
+    uint8_t last_level = 0xff;
+    uint8_t stable = 0;
+
+    uint32_t start = micros();
+    radio.tea5767_setStation(bench_freq(i * 37));
+    while (stable < BENCH_STABLE_READS && micros() - start < BENCH_SETTLE_TIMEOUT_US) {
+        radio.tea5767_getStatus(&status);
+        bool if_valid = status.ifCounter >= TEA5767_IF_MIN && status.ifCounter <= TEA5767_IF_MAX;
+        stable = if_valid && status.level == last_level ? stable + 1 : 1;
+        last_level = if_valid ? status.level : 0xff;
+    }
+}
+
+static void op_scan(int i) {
+    for (int channel = 0; MIN_FREQ_EU + channel * 0.1 <= MAX_FREQ_EU; channel++) {
+        radio.tea5767_setStation(MIN_FREQ_EU + channel * 0.1);
+        radio.tea5767_getStatus(&status);
+    }
+}
+
+static bench_entry_t entries[] = {
+    { "write", op_write, BENCH_ITERATIONS },
+    { "status", op_status, BENCH_ITERATIONS },
+    { "mute", op_mute, BENCH_ITERATIONS },
+    { "profile", op_profile, BENCH_ITERATIONS },
+    { "settle", op_settle, 10 },
+    { "scan", op_scan, BENCH_SCANS },
+};
+
+#define BENCH_ENTRIES (sizeof(entries) / sizeof(entries[0]))
+
+static void bench_measure(bench_entry_t *entry) {
+    entry->min = UINT64_MAX;
+    for (uint32_t i = 0; i < entry->n; i++) {
+        uint32_t start_us = micros();
+        uint64_t start = rp2040.getCycleCount64();
+        entry->fn(i);
+        uint64_t cycles = rp2040.getCycleCount64() - start;
+        uint32_t elapsed_us = micros() - start_us;
+
+        if (cycles < entry->min) {
+            entry->min = cycles;
+        }
+        if (cycles > entry->max) {
+            entry->max = cycles;
+        }
+        entry->total += cycles;
+        entry->total_us += elapsed_us;
+    }
+}
+
+static void bench_report() {
+    char line[160];
+
+    snprintf(line, sizeof(line), "{\"schema\":\"tea5767-bench/1\",\"target\":\"rp2040-arduino\","
+             "\"transport\":\"i2c\",\"clk_hz\":%lu,\"iterations\":%d,\"results\":[",
+             (unsigned long)F_CPU, BENCH_ITERATIONS);
+    Serial.print(line);
+    for (size_t e = 0; e < BENCH_ENTRIES; e++) {
+        bench_entry_t *entry = &entries[e];
+        snprintf(line, sizeof(line), "%s{\"op\":\"%s\",\"n\":%lu,\"min_cycles\":%llu,\"mean_cycles\":%llu,"
+                 "\"max_cycles\":%llu,\"mean_us\":%llu}", e ? "," : "", entry->name, (unsigned long)entry->n,
+                 (unsigned long long)entry->min, (unsigned long long)(entry->total / entry->n),
+                 (unsigned long long)entry->max, (unsigned long long)(entry->total_us / entry->n));
+        Serial.print(line);
+    }
+    Serial.println("]}");
+}
+
+void setup(){
+    radio.begin();
+    Serial.begin(115200);
+    delay(5000);
+
+    for (size_t e = 0; e < BENCH_ENTRIES; e++) {
+        bench_measure(&entries[e]);
+    }
+    bench_report();
+}
+
+void loop(){
+}
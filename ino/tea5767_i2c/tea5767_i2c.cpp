@@ -36,6 +36,7 @@ tea5767_i2c::tea5767_i2c(uint8_t band_mode){ // Constructor
     _softMuteMode = false;
     _hpfMode = true;
     _stereoNoiseCancelling = true;
+    _deemphasis = false;
 }
 
 void tea5767_i2c::tea5767_read_raw(uint8_t *buffer) {
@@ -75,7 +76,7 @@ void tea5767_i2c::tea5767_write_registers() {
             | _muteRmode << 2 | _muteLmode << 1;
     registers[3] = _standby << 6 | _band_mode << 5 | 1 << 4 | _softMuteMode << 3 | _hpfMode << 2;
     registers[3] = registers[3] | _stereoNoiseCancelling << 1;
-    registers[4] = 0x00;
+    registers[4] = _deemphasis << 6;
     
     Wire.beginTransmission(_address); 
 
@@ -130,6 +131,7 @@ void tea5767_i2c::printStatus(){
     Serial.print("_softMuteMode ");Serial.println(_softMuteMode);
     Serial.print("_hpfMode ");Serial.println(_hpfMode);
     Serial.print("_stereoNoiseCancelling ");Serial.println(_stereoNoiseCancelling);
+    Serial.print("_deemphasis ");Serial.println(_deemphasis);
 }
 
 float tea5767_i2c::tea5767_getStation() {
@@ -145,6 +147,19 @@ float tea5767_i2c::tea5767_getStation() {
     return freq;
 }
 
+void tea5767_i2c::tea5767_getStatus(TEA5767_status_t *status) {
+    uint8_t buf[TEA5767_REGISTERS];
+    tea5767_read_raw(buf);
+
+    status->ready = buf[0] >> 7;
+    status->bandLimit = (buf[0] >> 6) & 0x01;
+    status->pll = (buf[0] & 0x3f) << 8 | buf[1];
+    status->stereo = buf[2] >> 7;
+    status->ifCounter = buf[2] & 0x7f;
+    status->level = buf[3] >> 4;
+    status->frequency = ((float)status->pll*32768/4 - 225000) / 1000000;
+}
+
 int tea5767_i2c::tea5767_getReady() {
     uint8_t buf[TEA5767_REGISTERS];
     tea5767_read_raw(buf);
@@ -215,6 +230,26 @@ void tea5767_i2c::tea5767_setMute(bool mute) {
     tea5767_write_registers();
 }
 
+void tea5767_i2c::tea5767_setSoftMute(bool mute) {
+    _softMuteMode = mute;
+    tea5767_write_registers();
+}
+
+void tea5767_i2c::tea5767_setAudioProfile(uint16_t profile) {
+    _softMuteMode = (profile & TEA5767_AUDIO_SOFT_MUTE) != 0;
+    _hpfMode = (profile & TEA5767_AUDIO_HIGH_CUT) != 0;
+    _stereoNoiseCancelling = (profile & TEA5767_AUDIO_SNC) != 0;
+    _deemphasis = (profile & TEA5767_AUDIO_DEEMPHASIS_75US) != 0;
+    tea5767_write_registers();
+}
+
+uint16_t tea5767_i2c::tea5767_getAudioProfile() {
+    return (_softMuteMode ? TEA5767_AUDIO_SOFT_MUTE : 0)
+            | (_hpfMode ? TEA5767_AUDIO_HIGH_CUT : 0)
+            | (_stereoNoiseCancelling ? TEA5767_AUDIO_SNC : 0)
+            | (_deemphasis ? TEA5767_AUDIO_DEEMPHASIS_75US : 0);
+}
+
 void tea5767_i2c::tea5767_setMuteLeft(bool mute) {
     _muteLmode = mute;
     tea5767_write_registers();
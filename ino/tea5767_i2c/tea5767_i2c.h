@@ -29,6 +29,31 @@
 #define ADC_MID 7 // Constant for the medium level of ADC readings
 #define ADC_HIGH 10 // Constant for the high level of ADC readings
 #define TEA5767_REGISTERS 5 // Number of registers in the TEA5767 chip
+#define TEA5767_AUDIO_SOFT_MUTE 0x0008 // Soft mute, SMUTE bit of the fourth byte
+#define TEA5767_AUDIO_HIGH_CUT 0x0004 // High cut control, HCC bit of the fourth byte
+#define TEA5767_AUDIO_SNC 0x0002 // Stereo noise cancelling, SNC bit of the fourth byte
+#define TEA5767_AUDIO_DEEMPHASIS_75US 0x4000 // 75 us de-emphasis instead of 50 us, DTC bit of the fifth byte
+#define TEA5767_AUDIO_PROFILE_HIFI (TEA5767_AUDIO_SNC) // Strong stations, full audio bandwidth
+#define TEA5767_AUDIO_PROFILE_DEFAULT (TEA5767_AUDIO_HIGH_CUT | TEA5767_AUDIO_SNC) // Settings after init
+#define TEA5767_AUDIO_PROFILE_WEAK (TEA5767_AUDIO_SOFT_MUTE | TEA5767_AUDIO_HIGH_CUT | TEA5767_AUDIO_SNC) // Noisy stations
+#define TEA5767_AUDIO_PROFILE_US (TEA5767_AUDIO_PROFILE_DEFAULT | TEA5767_AUDIO_DEEMPHASIS_75US) // Americas de-emphasis
+#define TEA5767_IF_MIN 0x31 // Lowest IF counter value of a correctly tuned station
+#define TEA5767_IF_MAX 0x3E // Highest IF counter value of a correctly tuned station
+
+/************************************
+ * TYPEDEFS
+ ************************************/
+/*! @brief Decoded content of the five bytes read from the TEA5767
+*/
+typedef struct {
+uint8_t ready;                  // Ready flag, station found or band limit reached
+uint8_t bandLimit;              // Band limit flag
+uint16_t pll;                   // PLL word
+uint8_t stereo;                 // Stereo reception
+uint8_t ifCounter;              // IF counter result
+uint8_t level;                  // ADC level output, 0 to 15
+float frequency;                // Frequency in MHz computed from the PLL word
+} TEA5767_status_t;
 
 class tea5767_i2c
 {
@@ -64,6 +89,11 @@ public:
     */
     float tea5767_getStation();
 
+    /*! @brief Reads and decodes the status of the TEA5757 tuner in one transaction.
+    * @param status Filled with the decoded fields.
+    */
+    void tea5767_getStatus(TEA5767_status_t *status);
+
     /*! @brief Configures the search mode and direction of the TEA5757 tuner.
     * This function sets the search mode and direction of the TEA5757 tuner. It updates the values of the TEA5757_t structure
     * with the given search mode and search direction and then writes them to the tuner using the tea5767_write_registers() function.
@@ -118,6 +148,17 @@ public:
     */
     void tea5767_setSoftMute(bool mute);
 
+    /*! @brief Sets soft mute, high cut control, stereo noise cancelling and de-emphasis in one register write.
+    * @param profile OR of TEA5767_AUDIO_* bits, or one of the TEA5767_AUDIO_PROFILE_* presets.
+    * @note Switching profile costs exactly one bus transaction, whatever the number of settings changed.
+    */
+    void tea5767_setAudioProfile(uint16_t profile);
+
+    /*! @brief Returns the current audio settings as TEA5767_AUDIO_* bits.
+    * @return uint16_t Profile that tea5767_setAudioProfile() would restore.
+    */
+    uint16_t tea5767_getAudioProfile();
+
     /*! @brief Sets the left channel mute mode for the TEA5767 radio.
     * @param mute Boolean value indicating whether the left channel should be muted.
     */
@@ -196,6 +237,7 @@ public:
     uint8_t _stereoNoiseCancelling;  // Stereo noise cancelling mode
     uint8_t _softMuteMode;           // Soft mute mode
     uint8_t _hpfMode;                // High pass filter mode
+    uint8_t _deemphasis;             // De-emphasis time constant, 1 for 75 us, 0 for 50 us
     uint8_t _isReady;                // Radio is ready flag
     uint8_t _isStereo;               // Stereo mode flag
     uint8_t _stationLevel;           // Station level
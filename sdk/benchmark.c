@@ -0,0 +1,274 @@
+/**
+ ********************************************************************************
+ * @file    benchmark.c
+ * @author  Carlos Egea
+ * @date    18/10/2026
+ * @brief   Per-operation cycle counts of the TEA5767 driver, printed as JSON.
+ *
+ * The tuner is emulated by I2C1 in slave mode at the TEA5767 address, so the
+ * numbers do not depend on a module being fitted. Wire GP4 to GP6 and GP5 to
+ * GP7, pull-ups are enabled on both sides. Build with BENCH_LOOPBACK=0 to
+ * measure a real module on I2C0 instead.
+ *
+ * Operations, named and measured as in the Arduino example so that both reports compare:
+ *   write    encode and write the registers, no settle wait
+ *   status   read and decode the status
+ *   mute     mute on or off, one write
+ *   profile  audio profile switch, one write
+ *   settle   tune, then poll the status until the IF counter is in range and the
+ *            level reads the same BENCH_STABLE_READS times
+ *   scan     one write and one status read per 100 kHz channel of the European band
+ * encode, decode and read are SDK only, the class keeps them private.
+ *
+ * Report, one JSON object per run on a single line:
+ * {"schema":"tea5767-bench/1","target":"rp2040-sdk","transport":"loopback",
+ *  "clk_hz":125000000,"iterations":200,"results":[{"op":"encode","n":200,
+ *  "min_cycles":..,"mean_cycles":..,"max_cycles":..,"mean_us":..},...]}
+ ********************************************************************************
+ */
+
+/************************************
+ * INCLUDES
+ ************************************/
+#include <stdio.h>
+#include <string.h>
+#include "pico/stdlib.h"
+#include "pico/i2c_slave.h"
+#include "hardware/clocks.h"
+#include "hardware/structs/systick.h"
+#include "tea5767_i2c.h"
+
+/************************************
+ * PRIVATE MACROS AND DEFINES
+ ************************************/
+#ifndef BENCH_LOOPBACK
+#define BENCH_LOOPBACK 1 // Emulate the tuner on I2C1
+#endif
+#define BENCH_ITERATIONS 200 // Calls per operation
+#define BENCH_SCANS 3 // Full band scans
+#define BENCH_STABLE_READS 3 // Equal level readings needed to call the tuner settled
+#define BENCH_SETTLE_TIMEOUT_US 200000 // Give up waiting for the lock after this
+#define BENCH_SLAVE_SDA 6 // I2C1 pins of the emulated tuner
+#define BENCH_SLAVE_SCL 7
+#define BENCH_SYSTICK_MAX 0x00ffffff // SysTick is a 24 bit down counter
+
+/************************************
+ * PRIVATE TYPEDEFS
+ ************************************/
+typedef void (*bench_op_fn)(TEA5757_t *radio, int i);
+
+typedef struct {
+    const char *name;   // Operation name in the report
+    bench_op_fn fn;     // Wrapper exercising the operation
+    uint32_t n;         // Calls
+    uint64_t min;       // Cycles
+    uint64_t max;
+    uint64_t total;
+    uint64_t total_us;
+} bench_entry_t;
+
+/************************************
+ * STATIC VARIABLES
+ ************************************/
+static uint8_t registers[TEA5767_REGISTERS];
+static TEA5767_status_t status;
+static uint64_t systick_us; // Above this the count may have wrapped, cycles come from the timer
+
+#if BENCH_LOOPBACK
+// Emulated tuner: keeps the last write, answers reads with a locked station on the written PLL word
+static uint8_t slave_written[TEA5767_REGISTERS];
+static uint8_t slave_index;
+#endif
+
+/************************************
+ * STATIC FUNCTIONS
+ ************************************/
+#if BENCH_LOOPBACK
+static void bench_slave_handler(i2c_inst_t *i2c, i2c_slave_event_t event) {
+    switch (event) {
+        case I2C_SLAVE_RECEIVE:
+            if (slave_index < TEA5767_REGISTERS) {
+                slave_written[slave_index] = i2c_read_byte_raw(i2c);
+            } else {
+                i2c_read_byte_raw(i2c);
+            }
+            slave_index++;
+            break;
+
+        case I2C_SLAVE_REQUEST: {
+            uint8_t answer[TEA5767_REGISTERS] = {
+                0x80 | (slave_written[0] & 0x3f), slave_written[1], TEA5767_IF_CENTER, 10 << 4, 0
+            };
+            i2c_write_byte_raw(i2c, answer[slave_index % TEA5767_REGISTERS]);
+            slave_index++;
+            break;
+        }
+
+        case I2C_SLAVE_FINISH:
+            slave_index = 0;
+            break;
+
+        default:
+            break;
+    }
+}
+
+static void bench_slave_init(void) {
+    gpio_set_function(BENCH_SLAVE_SDA, GPIO_FUNC_I2C);
+    gpio_set_function(BENCH_SLAVE_SCL, GPIO_FUNC_I2C);
+    gpio_pull_up(BENCH_SLAVE_SDA);
+    gpio_pull_up(BENCH_SLAVE_SCL);
+    i2c_init(i2c1, 400 * 1000);
+    i2c_slave_init(i2c1, 0x60, &bench_slave_handler);
+}
+#endif
+
+static float bench_freq(int i) {
+    return 88.0 + (i % 200) * 0.1;
+}
+
+// Settings applied without the settle wait, the operations time the bus and the driver only
+static TEA5757_t bench_nosettle(const TEA5757_t *radio) {
+    TEA5757_t nosettle = *radio;
+    nosettle.settle_ms = 0;
+    return nosettle;
+}
+
+static void op_encode(TEA5757_t *radio, int i) {
+    radio->frequency = bench_freq(i);
+    tea5767_encode_registers(*radio, registers);
+}
+
+static void op_decode(TEA5757_t *radio, int i) {
+    registers[0] = 0x80 | (i & 0x3f);
+    tea5767_decode_status(registers, radio->pll_offset, &status);
+}
+
+static void op_read(TEA5757_t *radio, int i) {
+    tea5767_read_raw(*radio, registers);
+}
+
+static void op_write(TEA5757_t *radio, int i) {
+    TEA5757_t nosettle = bench_nosettle(radio);
+    nosettle.frequency = bench_freq(i);
+    tea5767_write_registers(nosettle);
+}
+
+static void op_status(TEA5757_t *radio, int i) {
+    tea5767_getStatus(*radio, &status);
+}
+
+static void op_mute(TEA5757_t *radio, int i) {
+    TEA5757_t nosettle = bench_nosettle(radio);
+    tea5767_setMute(&nosettle, i & 1);
+}
+
+static void op_profile(TEA5757_t *radio, int i) {
+    TEA5757_t nosettle = bench_nosettle(radio);
+    tea5767_setAudioProfile(&nosettle, (i & 1) ? TEA5767_AUDIO_PROFILE_WEAK : TEA5767_AUDIO_PROFILE_DEFAULT);
+}
+
+static void op_settle(TEA5757_t *radio, int i) {
+    TEA5757_t tuning = bench_nosettle(radio);
+    uint8_t last_level = 0xff;
+    uint8_t stable = 0;
+
+    tuning.frequency = bench_freq(i * 37);
+    uint64_t start = time_us_64();
+    tea5767_write_registers(tuning);
+    while (stable < BENCH_STABLE_READS && time_us_64() - start < BENCH_SETTLE_TIMEOUT_US) {
+        tea5767_getStatus(tuning, &status);
+        bool if_valid = status.ifCounter >= TEA5767_IF_MIN && status.ifCounter <= TEA5767_IF_MAX;
+        stable = if_valid && status.level == last_level ? stable + 1 : 1;
+        last_level = if_valid ? status.level : 0xff;
+    }
+}
+
+static void op_scan(TEA5757_t *radio, int i) {
+    TEA5757_t scanning = bench_nosettle(radio);
+    for (int channel = 0; MIN_FREQ_EU + channel * 0.1 <= MAX_FREQ_EU; channel++) {
+        scanning.frequency = MIN_FREQ_EU + channel * 0.1;
+        tea5767_write_registers(scanning);
+        tea5767_getStatus(scanning, &status);
+    }
+}
+
+static bench_entry_t entries[] = {
+    { "encode", op_encode, BENCH_ITERATIONS },
+    { "decode", op_decode, BENCH_ITERATIONS },
+    { "read", op_read, BENCH_ITERATIONS },
+    { "write", op_write, BENCH_ITERATIONS },
+    { "status", op_status, BENCH_ITERATIONS },
+    { "mute", op_mute, BENCH_ITERATIONS },
+    { "profile", op_profile, BENCH_ITERATIONS },
+    { "settle", op_settle, 10 },
+    { "scan", op_scan, BENCH_SCANS },
+};
+
+#define BENCH_ENTRIES (sizeof(entries) / sizeof(entries[0]))
+
+static void bench_measure(bench_entry_t *entry, TEA5757_t *radio, uint32_t clk_mhz) {
+    entry->min = UINT64_MAX;
+    for (uint32_t i = 0; i < entry->n; i++) {
+        uint64_t start_us = time_us_64();
+        uint32_t start = systick_hw->cvr;
+        entry->fn(radio, i);
+        uint32_t end = systick_hw->cvr;
+        uint64_t elapsed_us = time_us_64() - start_us;
+
+        uint64_t cycles = elapsed_us < systick_us ? (start - end) & BENCH_SYSTICK_MAX : elapsed_us * clk_mhz;
+        if (cycles < entry->min) {
+            entry->min = cycles;
+        }
+        if (cycles > entry->max) {
+            entry->max = cycles;
+        }
+        entry->total += cycles;
+        entry->total_us += elapsed_us;
+    }
+}
+
+static void bench_report(uint32_t clk_hz) {
+    printf("{\"schema\":\"tea5767-bench/1\",\"target\":\"rp2040-sdk\",\"transport\":\"%s\","
+           "\"clk_hz\":%lu,\"iterations\":%d,\"results\":[",
+           BENCH_LOOPBACK ? "loopback" : "i2c", (unsigned long)clk_hz, BENCH_ITERATIONS);
+    for (size_t e = 0; e < BENCH_ENTRIES; e++) {
+        bench_entry_t *entry = &entries[e];
+        printf("%s{\"op\":\"%s\",\"n\":%lu,\"min_cycles\":%llu,\"mean_cycles\":%llu,\"max_cycles\":%llu,"
+               "\"mean_us\":%llu}", e ? "," : "", entry->name, (unsigned long)entry->n,
+               (unsigned long long)entry->min, (unsigned long long)(entry->total / entry->n),
+               (unsigned long long)entry->max, (unsigned long long)(entry->total_us / entry->n));
+    }
+    printf("]}\n");
+}
+
+/************************************
+ * GLOBAL FUNCTIONS
+ ************************************/
+int main() {
+    stdio_init_all();
+    sleep_ms(5000);
+
+#if BENCH_LOOPBACK
+    bench_slave_init();
+#endif
+    TEA5757_t radio = tea5767_init();
+
+    // SysTick free running on the processor clock, the M0+ has no cycle counter
+    systick_hw->rvr = BENCH_SYSTICK_MAX;
+    systick_hw->cvr = 0;
+    systick_hw->csr = 0x5;
+
+    // The counter wraps every 2^24 cycles, 84 ms at 200 MHz. Half of that leaves room for the timer resolution.
+    uint32_t clk_hz = clock_get_hz(clk_sys);
+    systick_us = ((uint64_t)BENCH_SYSTICK_MAX + 1) * 1000000 / clk_hz / 2;
+    for (size_t e = 0; e < BENCH_ENTRIES; e++) {
+        bench_measure(&entries[e], &radio, clk_hz / 1000000);
+    }
+    bench_report(clk_hz);
+
+    while (true) {
+        sleep_ms(1000);
+    }
+    return 0;
+}
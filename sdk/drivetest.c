@@ -0,0 +1,128 @@
+/**
+ ********************************************************************************
+ * @file    drivetest.c
+ * @author  Carlos Egea
+ * @date    18/10/2026
+ * @brief   Drive-test firmware: station levels tagged with the GPS position.
+ ********************************************************************************
+ */
+
+/************************************
+ * INCLUDES
+ ************************************/
+#include <stdio.h>
+#include "pico/stdlib.h"
+#include "hardware/uart.h"
+#include "hardware/irq.h"
+#include "tea5767_i2c.h"
+#include "tea5767_scan.h"
+#include "tea5767_nmea.h"
+
+/************************************
+ * PRIVATE MACROS AND DEFINES
+ ************************************/
+#define GPS_UART uart1
+#define GPS_UART_IRQ UART1_IRQ
+#define GPS_TX_PIN 8
+#define GPS_RX_PIN 9
+#define GPS_BAUD_DEFAULT 9600 // Receiver rate after power up
+#define GPS_BAUD 115200 // RMC and GGA at 10 Hz take 1.4 to 1.6 kB/s, more than 9600 baud carries
+#define GPS_RATE_MS 100 // Fix interval asked to the receiver
+#define DRIVE_MIN_LEVEL ADC_LOW // Lowest level kept as a station by the initial scan
+
+/************************************
+ * STATIC VARIABLES
+ ************************************/
+static TEA5767_nmea_t nmea;
+static TEA5767_stations_t db;
+static TEA5767_scan_t scan;
+static volatile uint32_t overruns; // Characters lost because the UART FIFO was full
+
+/************************************
+ * STATIC FUNCTIONS
+ ************************************/
+// The parser does constant work per character, so it runs in the IRQ and never
+// falls behind the GPS, however long a tune blocks the main loop.
+static void gps_rx_irq() {
+    while (uart_is_readable(GPS_UART)) {
+        uint32_t dr = uart_get_hw(GPS_UART)->dr;
+        if (dr & UART_UARTDR_OE_BITS) {
+            overruns++;
+        }
+        tea5767_nmea_feed(&nmea, (char)dr);
+    }
+}
+
+// Sends a MediaTek PMTK command, body without '$' nor checksum
+static void gps_command(const char *body) {
+    char sentence[TEA5767_NMEA_MAX + 1];
+    uint8_t checksum = 0;
+
+    for (const char *p = body; *p; p++) {
+        checksum ^= *p;
+    }
+    snprintf(sentence, sizeof(sentence), "$%s*%02X\r\n", body, checksum);
+    uart_puts(GPS_UART, sentence);
+    uart_tx_wait_blocking(GPS_UART);
+}
+
+static TEA5767_position_t gps_position() {
+    TEA5767_position_t position;
+    irq_set_enabled(GPS_UART_IRQ, false);
+    position = nmea.position;
+    irq_set_enabled(GPS_UART_IRQ, true);
+    return position;
+}
+
+static void gps_init() {
+    char command[32];
+
+    tea5767_nmea_init(&nmea);
+    uart_init(GPS_UART, GPS_BAUD_DEFAULT);
+    gpio_set_function(GPS_TX_PIN, GPIO_FUNC_UART);
+    gpio_set_function(GPS_RX_PIN, GPIO_FUNC_UART);
+
+    // Raise the receiver baud rate first, then only RMC and GGA, at the fix rate
+    snprintf(command, sizeof(command), "PMTK251,%u", GPS_BAUD);
+    gps_command(command);
+    sleep_ms(100);
+    uart_set_baudrate(GPS_UART, GPS_BAUD);
+    gps_command("PMTK314,0,1,0,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0");
+    snprintf(command, sizeof(command), "PMTK220,%u", GPS_RATE_MS);
+    gps_command(command);
+
+    irq_set_exclusive_handler(GPS_UART_IRQ, gps_rx_irq);
+    irq_set_enabled(GPS_UART_IRQ, true);
+    uart_set_irq_enables(GPS_UART, true, false);
+}
+
+/************************************
+ * GLOBAL FUNCTIONS
+ ************************************/
+int main() {
+    stdio_init_all();
+    gps_init();
+    sleep_ms(5000);
+
+    TEA5757_t radio = tea5767_init();
+    tea5767_stations_init(&db);
+    tea5767_scanHardware(&radio, &scan, &db, DRIVE_MIN_LEVEL, NULL, NULL, NULL);
+
+    printf("time_ms,lat_e7,lon_e7,fix,channel,level,stereo,if,overruns,nmea_errors\n");
+    while (true) {
+        for (uint8_t i = 0; i < db.count; i++) {
+            TEA5767_status_t status;
+            uint16_t channel = db.channel[i];
+
+            if (db.flags[i] & TEA5767_STATION_REMOVED) {
+                continue;
+            }
+            tea5767_scan_probe(&radio, channel, 0, &status);
+            TEA5767_position_t position = gps_position();
+            printf("%lu,%ld,%ld,%u,%u,%u,%u,%u,%lu,%lu\n", (unsigned long)position.time_ms, (long)position.lat_e7,
+                   (long)position.lon_e7, position.fix, channel, status.level, status.stereo, status.ifCounter,
+                   (unsigned long)overruns, (unsigned long)nmea.errors);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,438 @@
+/**
+ ********************************************************************************
+ * @file    tea5767_audio.c
+ * @author  Carlos Egea
+ * @date    18/10/2026
+ * @brief   Fixed-point audio feature kernels for ADC captures of the TEA5767 output.
+ ********************************************************************************
+ */
+
+/************************************
+ * INCLUDES
+ ************************************/
+#include <math.h>
+#include <string.h>
+#include "tea5767_audio.h"
+
+/************************************
+ * PRIVATE MACROS AND DEFINES
+ ************************************/
+#define AUDIO_PI 3.14159265f
+
+#if defined(__SSE2__) && !defined(TEA5767_AUDIO_SCALAR)
+#include <emmintrin.h>
+#define AUDIO_SSE2
+#endif
+
+/************************************
+ * STATIC FUNCTIONS
+ ************************************/
+static int16_t saturate16(int32_t value) {
+    if (value > INT16_MAX) {
+        return INT16_MAX;
+    }
+    if (value < INT16_MIN) {
+        return INT16_MIN;
+    }
+    return value;
+}
+
+// value * coeff (Q15), split so that no product overflows 32 bits
+static int32_t mul_q15(int32_t value, int32_t coeff) {
+    return (value >> 15) * coeff + (((value & 0x7fff) * coeff) >> 15);
+}
+
+// Moves a Q15 envelope towards a level by coeff (Q15)
+static int32_t smooth_q15(int32_t envelope, int32_t level, int32_t coeff) {
+    return envelope + mul_q15((level << 15) - envelope, coeff);
+}
+
+// In place radix-2 FFT of Q15 data. The forward transform halves every stage, so it is scaled by 1/N
+// and cannot overflow. The inverse is not scaled: applied to a forward transform it gives the input back.
+static void fft_q15(const TEA5767_gate_t *gate, int16_t *re, int16_t *im, bool inverse) {
+    const unsigned n = TEA5767_GATE_FFT;
+
+    for (unsigned i = 1, j = 0; i < n; i++) {
+        unsigned bit = n >> 1;
+        for (; j & bit; bit >>= 1) {
+            j ^= bit;
+        }
+        j |= bit;
+        if (i < j) {
+            int16_t t = re[i];
+            re[i] = re[j];
+            re[j] = t;
+            t = im[i];
+            im[i] = im[j];
+            im[j] = t;
+        }
+    }
+
+    for (unsigned size = 2; size <= n; size <<= 1) {
+        unsigned half = size / 2;
+        unsigned step = n / size;
+        for (unsigned k = 0; k < half; k++) {
+            int32_t wr = gate->cos[k * step];
+            int32_t wi = inverse ? gate->sin[k * step] : -gate->sin[k * step];
+            for (unsigned a = k; a < n; a += size) {
+                unsigned b = a + half;
+                int32_t tr = (wr * re[b] - wi * im[b]) >> 15;
+                int32_t ti = (wr * im[b] + wi * re[b]) >> 15;
+                if (inverse) {
+                    re[b] = saturate16(re[a] - tr);
+                    im[b] = saturate16(im[a] - ti);
+                    re[a] = saturate16(re[a] + tr);
+                    im[a] = saturate16(im[a] + ti);
+                } else {
+                    re[b] = (re[a] - tr) >> 1;
+                    im[b] = (im[a] - ti) >> 1;
+                    re[a] = (re[a] + tr) >> 1;
+                    im[a] = (im[a] + ti) >> 1;
+                }
+            }
+        }
+    }
+}
+
+// Gain of one bin from its smoothed power and noise floor, power subtraction bounded below by min_gain
+static int16_t gate_gain(const TEA5767_gate_t *gate, uint32_t power, uint32_t floor) {
+    uint64_t over = (uint64_t)floor * gate->over;
+
+    if (over >= power) {
+        return gate->min_gain;
+    }
+    uint32_t noise = over;
+    // Both scaled down until the power fits 16 bits, so that noise << 15 fits 32
+    uint8_t shift = 0;
+    while ((power >> shift) >= 1u << 16) {
+        shift++;
+    }
+    uint32_t den = power >> shift;
+    int32_t gain = 32767 - (int32_t)(((noise >> shift) << 15) / den);
+    return gain < gate->min_gain ? gate->min_gain : gain;
+}
+
+static void gate_frame(TEA5767_gate_t *gate, int16_t *out) {
+    int16_t re[TEA5767_GATE_FFT];
+    int16_t im[TEA5767_GATE_FFT];
+    int32_t peak = 0;
+    bool unity = true;
+
+    for (uint16_t i = 0; i < TEA5767_GATE_FFT; i++) {
+        re[i] = (gate->history[i] * gate->window[i]) >> 15;
+        im[i] = 0;
+        peak |= re[i] < 0 ? -re[i] : re[i];
+    }
+    // Block floating point, quiet frames are scaled up to use the 16 bits before the 1/N scaling
+    uint8_t scale = 0;
+    while (peak && peak < 0x4000 >> scale) {
+        scale++;
+    }
+    for (uint16_t i = 0; i < TEA5767_GATE_FFT; i++) {
+        re[i] <<= scale;
+    }
+
+    fft_q15(gate, re, im, false);
+
+    for (uint16_t k = 0; k < TEA5767_GATE_BINS; k++) {
+        uint32_t power = ((uint32_t)(re[k] * re[k]) + (uint32_t)(im[k] * im[k])) >> (2 * scale);
+        gate->power[k] = gate->power[k] - (gate->power[k] >> 2) + (power >> 2);
+        if (gate->power[k] < gate->floor[k]) {
+            gate->floor[k] = gate->power[k];
+        } else {
+            gate->floor[k] += (gate->floor[k] >> 9) + 1;
+        }
+
+        int32_t target = gate->engaged ? gate_gain(gate, gate->power[k], gate->floor[k]) : 32767;
+        // Opening is immediate so that onsets are not cut, closing is smoothed against musical noise
+        gate->gain[k] = target > gate->gain[k] ? target : (gate->gain[k] + target) / 2;
+        unity = unity && gate->gain[k] >= 32767;
+
+        re[k] = (re[k] * gate->gain[k]) >> 15;
+        im[k] = (im[k] * gate->gain[k]) >> 15;
+        if (k > 0 && k < TEA5767_GATE_FFT / 2) {
+            re[TEA5767_GATE_FFT - k] = re[k];
+            im[TEA5767_GATE_FFT - k] = -im[k];
+        }
+    }
+    gate->transparent = !gate->engaged && unity;
+    gate->frames++;
+
+    fft_q15(gate, re, im, true);
+
+    for (uint16_t i = 0; i < TEA5767_GATE_FFT; i++) {
+        re[i] = ((re[i] >> scale) * gate->window[i]) >> 15;
+    }
+    for (uint16_t i = 0; i < TEA5767_GATE_HOP; i++) {
+        out[i] = saturate16(gate->overlap[i] + re[i]);
+        gate->overlap[i] = re[TEA5767_GATE_HOP + i];
+    }
+}
+
+// Per sample coefficient of a one-pole smoother with the given time constant, Q15
+static int32_t pole_q15(float ms, float rate) {
+    if (ms <= 0) {
+        return 32767;
+    }
+    return lroundf((1.0f - expf(-1000.0f / (ms * rate))) * 32767);
+}
+
+static uint32_t isqrt64(uint64_t value) {
+    uint64_t root = 0;
+    uint64_t bit = (uint64_t)1 << 62;
+
+    while (bit > value) {
+        bit >>= 2;
+    }
+    while (bit) {
+        if (value >= root + bit) {
+            value -= root + bit;
+            root = (root >> 1) + bit;
+        } else {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+    return root;
+}
+
+#ifdef AUDIO_SSE2
+// Sum and sum of squares of 12-bit samples, eight at a time. Squares of 12-bit
+// values fit pmaddwd, and 32-bit lanes are flushed to 64 bits every 64 samples.
+static size_t moments_sse2(const uint16_t *x, size_t n, uint64_t *sum, uint64_t *sum_sq) {
+    size_t i = 0;
+    uint64_t s = 0, q = 0;
+
+    while (n - i >= 8) {
+        __m128i acc_s = _mm_setzero_si128();
+        __m128i acc_q = _mm_setzero_si128();
+        size_t end = i + 64 <= n ? i + 64 : n - ((n - i) & 7);
+        for (; i < end; i += 8) {
+            __m128i v = _mm_loadu_si128((const __m128i *)&x[i]);
+            acc_q = _mm_add_epi32(acc_q, _mm_madd_epi16(v, v));
+            acc_s = _mm_add_epi32(acc_s, _mm_madd_epi16(v, _mm_set1_epi16(1)));
+        }
+        uint32_t lanes_s[4], lanes_q[4];
+        _mm_storeu_si128((__m128i *)lanes_s, acc_s);
+        _mm_storeu_si128((__m128i *)lanes_q, acc_q);
+        for (int l = 0; l < 4; l++) {
+            s += lanes_s[l];
+            q += lanes_q[l];
+        }
+    }
+    *sum = s;
+    *sum_sq = q;
+    return i;
+}
+#endif
+
+static void moments(const uint16_t *x, size_t n, size_t stride, uint64_t *sum, uint64_t *sum_sq) {
+    size_t i = 0;
+    uint32_t s = 0;
+    uint64_t q = 0;
+
+    *sum = 0;
+    *sum_sq = 0;
+#ifdef AUDIO_SSE2
+    if (stride == 1) {
+        i = moments_sse2(x, n, sum, sum_sq);
+    }
+#endif
+    for (; i < n; i++) {
+        uint32_t v = x[i * stride];
+        s += v;
+        q += v * v;
+    }
+    *sum += s;
+    *sum_sq += q;
+}
+
+static uint16_t mean(const uint16_t *x, size_t n, size_t stride) {
+    uint64_t sum, sum_sq;
+    moments(x, n, stride, &sum, &sum_sq);
+    return n ? sum / n : 0;
+}
+
+/************************************
+ * GLOBAL FUNCTIONS
+ ************************************/
+uint16_t tea5767_audio_rms(const uint16_t *x, size_t n, size_t stride) {
+    uint64_t sum, sum_sq;
+
+    if (n == 0) {
+        return 0;
+    }
+    moments(x, n, stride, &sum, &sum_sq);
+    // n * sum(x^2) - sum(x)^2 = n^2 * variance, exact in integers
+    return isqrt64((n * sum_sq - sum * sum) / ((uint64_t)n * n));
+}
+
+uint32_t tea5767_audio_zeroCrossings(const uint16_t *x, size_t n, size_t stride) {
+    uint16_t m = mean(x, n, stride);
+    uint32_t crossings = 0;
+
+    if (n == 0) {
+        return 0;
+    }
+    int above = x[0] >= m;
+    for (size_t i = 1; i < n; i++) {
+        int now = x[i * stride] >= m;
+        crossings += now != above;
+        above = now;
+    }
+    return crossings;
+}
+
+uint16_t tea5767_audio_noise(const uint16_t *x, size_t n, size_t stride) {
+    uint64_t sum_sq = 0;
+
+    if (n < 2) {
+        return 0;
+    }
+    for (size_t i = 1; i < n; i++) {
+        int32_t d = (int32_t)x[i * stride] - x[(i - 1) * stride];
+        sum_sq += (uint32_t)(d * d);
+    }
+    return isqrt64(sum_sq / (2 * (n - 1)));
+}
+
+int32_t tea5767_audio_goertzelCoeff(float freq, float rate) {
+    return lroundf(2.0f * cosf(2.0f * AUDIO_PI * freq / rate) * (1 << TEA5767_AUDIO_Q));
+}
+
+uint64_t tea5767_audio_goertzel(const uint16_t *x, size_t n, size_t stride, int32_t coeff) {
+    int32_t m = mean(x, n, stride);
+    int64_t s1 = 0, s2 = 0;
+
+    for (size_t i = 0; i < n; i++) {
+        int64_t s = (int32_t)x[i * stride] - m + ((coeff * s1) >> TEA5767_AUDIO_Q) - s2;
+        s2 = s1;
+        s1 = s;
+    }
+    // |X|^2 = s1^2 + s2^2 - coeff * s1 * s2, every term within 62 bits as |s| < 2^30 up to TEA5767_GOERTZEL_MAX
+    int64_t power = s1 * s1 + s2 * s2 - ((coeff * s1) >> TEA5767_AUDIO_Q) * s2;
+    return power > 0 ? power : 0;
+}
+
+void tea5767_audio_toPcm(const uint16_t *x, size_t n, size_t stride, int16_t *out, size_t out_stride) {
+    for (size_t i = 0; i < n; i++) {
+        out[i * out_stride] = ((int32_t)x[i * stride] - 2048) * 16;
+    }
+}
+
+void tea5767_audio_hpfInit(TEA5767_hpf_t *hpf, float cutoff, float rate) {
+    hpf->coeff = lroundf(expf(-2 * AUDIO_PI * cutoff / rate) * 32767);
+    hpf->x1 = 0;
+    hpf->y1 = 0;
+}
+
+void tea5767_audio_hpf(TEA5767_hpf_t *hpf, int16_t *x, size_t n, size_t stride) {
+    int32_t x1 = hpf->x1;
+    int32_t y1 = hpf->y1;
+
+    // y[n] = x[n] - x[n-1] + a * y[n-1]. y carries fraction bits: rounded to whole units, a * y gives y back
+    // for |y| below 0.5 / (1 - a), and a DC offset that small would never decay.
+    for (size_t i = 0; i < n; i++) {
+        int32_t in = x[i * stride];
+        y1 = ((in - x1) << TEA5767_AUDIO_HPF_Q) + mul_q15(y1, hpf->coeff);
+        x1 = in;
+        x[i * stride] = saturate16((y1 + (1 << (TEA5767_AUDIO_HPF_Q - 1))) >> TEA5767_AUDIO_HPF_Q);
+    }
+    hpf->x1 = x1;
+    hpf->y1 = y1;
+}
+
+void tea5767_audio_agcInit(TEA5767_agc_t *agc, uint16_t target, float max_gain, float attack_ms, float release_ms,
+                           float rate) {
+    agc->envelope = (int32_t)target << 15;
+    agc->gain = 1 << TEA5767_AUDIO_GAIN_Q;
+    agc->max_gain = lroundf(max_gain * (1 << TEA5767_AUDIO_GAIN_Q));
+    agc->target = target;
+    agc->attack = pole_q15(attack_ms, rate);
+    agc->release = pole_q15(release_ms, rate);
+}
+
+void tea5767_audio_agc(TEA5767_agc_t *agc, int16_t *x, size_t n, size_t stride) {
+    int32_t envelope = agc->envelope;
+
+    if (n == 0) {
+        return;
+    }
+    // Envelope of the whole block first, the gain then reacts to a peak before it is played
+    for (size_t i = 0; i < n; i++) {
+        int32_t level = x[i * stride] < 0 ? -x[i * stride] : x[i * stride];
+        envelope = smooth_q15(envelope, level, (level << 15) > envelope ? agc->attack : agc->release);
+    }
+    agc->envelope = envelope;
+
+    int32_t peak = envelope >> 15;
+    int32_t gain = peak > 0 ? ((int32_t)agc->target << TEA5767_AUDIO_GAIN_Q) / peak : agc->max_gain;
+    if (gain > agc->max_gain) {
+        gain = agc->max_gain;
+    }
+
+    // Linear ramp from the previous gain, with 8 extra fraction bits so short blocks still move
+    int32_t ramp = agc->gain << 8;
+    int32_t step = ((gain - agc->gain) << 8) / (int32_t)n;
+    for (size_t i = 0; i < n; i++) {
+        ramp += step;
+        x[i * stride] = saturate16((x[i * stride] * (ramp >> 8)) >> TEA5767_AUDIO_GAIN_Q);
+    }
+    agc->gain = gain;
+}
+
+void tea5767_audio_gateInit(TEA5767_gate_t *gate, float min_gain, uint8_t over) {
+    memset(gate, 0, sizeof(*gate));
+    for (uint16_t i = 0; i < TEA5767_GATE_FFT; i++) {
+        gate->window[i] = lroundf(sinf(AUDIO_PI * (i + 0.5f) / TEA5767_GATE_FFT) * 32767);
+    }
+    for (uint16_t i = 0; i < TEA5767_GATE_FFT / 2; i++) {
+        gate->cos[i] = lroundf(cosf(2 * AUDIO_PI * i / TEA5767_GATE_FFT) * 32767);
+        gate->sin[i] = lroundf(sinf(2 * AUDIO_PI * i / TEA5767_GATE_FFT) * 32767);
+    }
+    for (uint16_t k = 0; k < TEA5767_GATE_BINS; k++) {
+        gate->floor[k] = UINT32_MAX / 2;
+        gate->gain[k] = 32767;
+    }
+    gate->min_gain = lroundf(min_gain * 32767);
+    gate->over = over;
+    gate->transparent = true;
+}
+
+void tea5767_audio_gateLevel(TEA5767_gate_t *gate, uint8_t level) {
+    gate->engaged = level < TEA5767_GATE_LEVEL;
+    if (gate->engaged) {
+        gate->transparent = false;
+    }
+}
+
+bool tea5767_audio_gate(TEA5767_gate_t *gate, int16_t *x, size_t n, size_t stride) {
+    int16_t out[TEA5767_GATE_HOP];
+
+    if (n % TEA5767_GATE_HOP) {
+        return false;
+    }
+    for (size_t hop = 0; hop + TEA5767_GATE_HOP <= n; hop += TEA5767_GATE_HOP) {
+        int16_t *in = x + hop * stride;
+        memmove(gate->history, gate->history + TEA5767_GATE_HOP, TEA5767_GATE_HOP * sizeof(int16_t));
+        for (uint16_t i = 0; i < TEA5767_GATE_HOP; i++) {
+            gate->history[TEA5767_GATE_HOP + i] = in[i * stride];
+        }
+
+        if (gate->transparent) {
+            // Same delay as a frame, the first half of the history is the previous hop. The overlap is
+            // kept as a frame would leave it, so that engaging again does not dip.
+            memcpy(out, gate->history, sizeof(out));
+            for (uint16_t i = 0; i < TEA5767_GATE_HOP; i++) {
+                int32_t w = gate->window[TEA5767_GATE_HOP + i];
+                gate->overlap[i] = (((gate->history[TEA5767_GATE_HOP + i] * w) >> 15) * w) >> 15;
+            }
+        } else {
+            gate_frame(gate, out);
+        }
+        for (uint16_t i = 0; i < TEA5767_GATE_HOP; i++) {
+            in[i * stride] = out[i];
+        }
+    }
+    return true;
+}
@@ -0,0 +1,213 @@
+/**
+ ********************************************************************************
+ * @file    tea5767_audio.h
+ * @author  Carlos Egea
+ * @date    18/10/2026
+ * @brief   Fixed-point audio feature kernels for ADC captures of the TEA5767 output.
+ ********************************************************************************
+ */
+
+#ifndef _HARDWARE_TEA5767_AUDIO_H
+#define _HARDWARE_TEA5767_AUDIO_H
+
+/************************************
+ * INCLUDES
+ ************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/************************************
+ * MACROS AND DEFINES
+ ************************************/
+#define TEA5767_AUDIO_Q 14 // Fraction bits of the Goertzel coefficient
+#define TEA5767_AUDIO_GAIN_Q 8 // Fraction bits of the AGC gain
+#define TEA5767_AUDIO_HPF_Q 8 // Fraction bits of the high-pass filter output state
+#define TEA5767_GOERTZEL_MAX 723 // Longest block the Goertzel bin is exact for at any frequency
+#ifndef TEA5767_GATE_FFT_BITS
+#define TEA5767_GATE_FFT_BITS 6 // Noise gate frame length, log2, 2 to 9
+#endif
+#if TEA5767_GATE_FFT_BITS < 2 || TEA5767_GATE_FFT_BITS > 9
+// A frame takes 4 bytes per point of stack in the gate, and the 16 bit transforms lose 3 dB per doubling
+#error "TEA5767_GATE_FFT_BITS must be 2 to 9"
+#endif
+#define TEA5767_GATE_FFT (1 << TEA5767_GATE_FFT_BITS) // Noise gate frame length
+#define TEA5767_GATE_HOP (TEA5767_GATE_FFT / 2) // Frames overlap by half, the gate delays by one hop
+#define TEA5767_GATE_BINS (TEA5767_GATE_FFT / 2 + 1) // Bins of a real frame
+#define TEA5767_GATE_LEVEL 8 // Tuner ADC level below which the gate engages
+
+/*
+ * All kernels take raw 12-bit ADC samples. The DC offset is removed internally.
+ * stride is the distance in samples between two consecutive samples of the channel,
+ * so an interleaved multi-channel capture is processed in place: pass &buf[channel]
+ * and the number of channels as stride.
+ * Results are integers and identical on every platform. On x86 hosts with SSE2 the
+ * contiguous (stride 1) case is vectorised; define TEA5767_AUDIO_SCALAR to disable it.
+ * test/test_audio.c checks both builds against a plain reference.
+ */
+
+/*
+ * The streaming stages below work in place on signed 16-bit PCM, made from ADC samples
+ * by tea5767_audio_toPcm(). They keep their state between calls so a stream can be
+ * processed block by block, and stride works as for the kernels.
+ */
+
+/************************************
+ * TYPEDEFS
+ ************************************/
+/*! @brief One-pole high-pass filter state
+*/
+typedef struct {
+int32_t coeff;                  // Pole, Q15
+int32_t x1;                     // Previous input
+int32_t y1;                     // Previous output, Q8 (TEA5767_AUDIO_HPF_Q)
+} TEA5767_hpf_t;
+
+/*! @brief Automatic gain control state. The gain is set once per block from the block's envelope
+* and ramped across the next block, so it never steps inside a block.
+*/
+typedef struct {
+int32_t envelope;               // Peak envelope, PCM units in Q15
+int32_t gain;                   // Current gain, Q8
+int32_t max_gain;               // Gain ceiling, Q8, keeps silence from being pumped up to the noise floor
+uint16_t target;                // Envelope aimed at, PCM units
+int32_t attack;                 // Envelope rise coefficient per sample, Q15
+int32_t release;                // Envelope decay coefficient per sample, Q15
+} TEA5767_agc_t;
+
+/*! @brief Spectral noise gate state. Frames are sine windowed on analysis and synthesis, which
+* overlap-adds back to the input when every gain is one.
+*/
+typedef struct {
+int16_t window[TEA5767_GATE_FFT];       // Sine window, Q15
+int16_t cos[TEA5767_GATE_FFT / 2];      // Twiddles, Q15
+int16_t sin[TEA5767_GATE_FFT / 2];
+int16_t history[TEA5767_GATE_FFT];      // Last frame of input
+int16_t overlap[TEA5767_GATE_HOP];      // Second half of the previous output frame
+uint32_t power[TEA5767_GATE_BINS];      // Smoothed bin power
+uint32_t floor[TEA5767_GATE_BINS];      // Noise floor per bin, tracked as a slowly rising minimum
+int16_t gain[TEA5767_GATE_BINS];        // Smoothed bin gain, Q15
+int16_t min_gain;                       // Deepest attenuation, Q15
+uint8_t over;                           // Noise floor multiple subtracted
+bool engaged;                           // Suppressing, set from the tuner level
+bool transparent;                       // Disengaged and every gain back at one, frames are skipped
+uint32_t frames;                        // Frames transformed
+} TEA5767_gate_t;
+
+/************************************
+ * GLOBAL FUNCTION PROTOTYPES
+ ************************************/
+
+/*! @brief Root mean square of the signal around its mean.
+* @param x First sample.
+* @param n Number of samples.
+* @param stride Distance between samples.
+* @return uint16_t RMS in ADC counts.
+*/
+uint16_t tea5767_audio_rms(const uint16_t *x, size_t n, size_t stride);
+
+/*! @brief Number of times the signal crosses its mean.
+* @param x First sample.
+* @param n Number of samples.
+* @param stride Distance between samples.
+* @return uint32_t Crossings in the block.
+*/
+uint32_t tea5767_audio_zeroCrossings(const uint16_t *x, size_t n, size_t stride);
+
+/*! @brief Noise estimate from the first difference of the signal.
+* Programme audio has little energy near Nyquist, white noise has it all over the band,
+* so the RMS of x[i] - x[i-1] divided by sqrt(2) tracks the noise floor.
+* @param x First sample.
+* @param n Number of samples.
+* @param stride Distance between samples.
+* @return uint16_t Noise RMS in ADC counts.
+*/
+uint16_t tea5767_audio_noise(const uint16_t *x, size_t n, size_t stride);
+
+/*! @brief Computes the Goertzel coefficient 2 * cos(2 * pi * freq / rate) in Q14.
+* Meant to be called once at setup, it uses floating point.
+* @param freq Frequency of interest in Hz.
+* @param rate Sample rate in Hz.
+* @return int32_t Coefficient for tea5767_audio_goertzel().
+*/
+int32_t tea5767_audio_goertzelCoeff(float freq, float rate);
+
+/*! @brief Power of the signal at a single frequency.
+* @param x First sample.
+* @param n Number of samples, up to \ref TEA5767_GOERTZEL_MAX. The filter state grows by up to n times the
+* sample every step near 0 Hz and Nyquist, longer blocks can overflow there.
+* @param stride Distance between samples.
+* @param coeff Value returned by tea5767_audio_goertzelCoeff().
+* @return uint64_t Squared magnitude of the bin, in ADC counts squared.
+*/
+uint64_t tea5767_audio_goertzel(const uint16_t *x, size_t n, size_t stride, int32_t coeff);
+
+/*! @brief Converts raw 12-bit ADC samples to signed 16-bit PCM.
+* @param x First sample.
+* @param n Number of samples.
+* @param stride Distance between input samples.
+* @param out First output sample.
+* @param out_stride Distance between output samples.
+*/
+void tea5767_audio_toPcm(const uint16_t *x, size_t n, size_t stride, int16_t *out, size_t out_stride);
+
+/*! @brief Sets up a high-pass filter. Meant to be called once at setup, it uses floating point.
+* @param hpf Filter state.
+* @param cutoff Cutoff frequency in Hz.
+* @param rate Sample rate in Hz.
+*/
+void tea5767_audio_hpfInit(TEA5767_hpf_t *hpf, float cutoff, float rate);
+
+/*! @brief High-pass filters PCM in place, removing DC and rumble.
+* @param hpf Filter state.
+* @param x First sample.
+* @param n Number of samples.
+* @param stride Distance between samples.
+*/
+void tea5767_audio_hpf(TEA5767_hpf_t *hpf, int16_t *x, size_t n, size_t stride);
+
+/*! @brief Sets up an AGC. Meant to be called once at setup, it uses floating point.
+* @param agc AGC state.
+* @param target Peak level aimed at, PCM units.
+* @param max_gain Highest gain applied, linear.
+* @param attack_ms Envelope rise time constant.
+* @param release_ms Envelope decay time constant.
+* @param rate Sample rate in Hz.
+*/
+void tea5767_audio_agcInit(TEA5767_agc_t *agc, uint16_t target, float max_gain, float attack_ms, float release_ms,
+                           float rate);
+
+/*! @brief Applies automatic gain control to PCM in place. Output saturates rather than wraps.
+* @param agc AGC state.
+* @param x First sample.
+* @param n Number of samples.
+* @param stride Distance between samples.
+*/
+void tea5767_audio_agc(TEA5767_agc_t *agc, int16_t *x, size_t n, size_t stride);
+
+/*! @brief Sets up a noise gate, disengaged. Meant to be called once at setup, it uses floating point.
+* @param gate Gate state.
+* @param min_gain Deepest attenuation of a bin, linear, 0.1 is -20 dB.
+* @param over Multiple of the noise floor subtracted, higher is stronger and more prone to artefacts. 4 is a good start.
+*/
+void tea5767_audio_gateInit(TEA5767_gate_t *gate, float min_gain, uint8_t over);
+
+/*! @brief Engages the gate on weak stations, from the level the tuner reports.
+* @param gate Gate state.
+* @param level Tuner ADC level, 0 to 15.
+*/
+void tea5767_audio_gateLevel(TEA5767_gate_t *gate, uint8_t level);
+
+/*! @brief Suppresses stationary noise in place. The output is delayed by \ref TEA5767_GATE_HOP samples.
+* Each hop is windowed with the previous one, transformed, each bin is scaled by its gain, and the frame
+* is transformed back and overlap-added. While disengaged and settled, only the delay is applied.
+* @param gate Gate state.
+* @param x First sample.
+* @param n Number of samples, a multiple of \ref TEA5767_GATE_HOP. A partial hop cannot be carried over without
+* delaying the output by a further hop, so other block sizes are refused.
+* @param stride Distance between samples.
+* @return bool false if n is not a multiple of \ref TEA5767_GATE_HOP, x is then unchanged.
+*/
+bool tea5767_audio_gate(TEA5767_gate_t *gate, int16_t *x, size_t n, size_t stride);
+
+#endif
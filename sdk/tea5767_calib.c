@@ -0,0 +1,141 @@
+/**
+ ********************************************************************************
+ * @file    tea5767_calib.c
+ * @author  Carlos Egea
+ * @date    18/10/2026
+ * @brief   Timing calibration of the TEA5767 from measurements on real hardware.
+ ********************************************************************************
+ */
+
+/************************************
+ * INCLUDES
+ ************************************/
+#include "pico/time.h"
+#include "tea5767_calib.h"
+
+/************************************
+ * STATIC VARIABLES
+ ************************************/
+// Jumps towards the station, in MHz. Clamped to the band by tea5767_checkFreqLimits().
+static const float steps[] = { 0.1, 0.5, 2.0, 5.0, 10.0, 32.0 };
+
+#define CALIB_STEPS (sizeof(steps) / sizeof(steps[0]))
+
+/************************************
+ * STATIC FUNCTIONS
+ ************************************/
+static bool tea5767_measureLock(TEA5757_t radio, uint32_t *lock_us) {
+    TEA5767_status_t status;
+    uint8_t last_level = 0xff;
+    uint8_t stable = 0;
+    uint64_t stable_since = 0;
+
+    uint64_t start = time_us_64();
+    tea5767_write_registers(radio);
+
+    while (time_us_64() - start < TEA5767_CALIB_TIMEOUT_US) {
+        uint64_t now = time_us_64();
+        tea5767_getStatus(radio, &status);
+        bool if_valid = status.ifCounter >= TEA5767_IF_MIN && status.ifCounter <= TEA5767_IF_MAX;
+
+        if (if_valid && status.level == last_level) {
+            if (++stable >= TEA5767_CALIB_STABLE_READS) {
+                *lock_us = stable_since - start;
+                return true;
+            }
+        } else {
+            stable = 1;
+            stable_since = now;
+        }
+        last_level = if_valid ? status.level : 0xff;
+    }
+    return false;
+}
+
+/************************************
+ * GLOBAL FUNCTIONS
+ ************************************/
+bool tea5767_calibrate(TEA5757_t *radio, float station, TEA5767_calibration_t *calibration) {
+    TEA5757_t probe = *radio;
+    uint8_t buf[TEA5767_REGISTERS];
+    uint64_t start;
+
+    probe.searchMode = false;
+    probe.settle_ms = 0;
+    probe.frequency = tea5767_checkFreqLimits(probe, station);
+
+    // Per transaction overhead
+    start = time_us_64();
+    for (int i = 0; i < TEA5767_CALIB_TRANSACTIONS; i++) {
+        tea5767_read_raw(probe, buf);
+    }
+    calibration->read_us = (time_us_64() - start) / TEA5767_CALIB_TRANSACTIONS;
+
+    start = time_us_64();
+    for (int i = 0; i < TEA5767_CALIB_TRANSACTIONS; i++) {
+        tea5767_write_registers(probe);
+    }
+    calibration->write_us = (time_us_64() - start) / TEA5767_CALIB_TRANSACTIONS;
+
+    // Lock time against step size, least squares fit of lock = a + b * step
+    float sum_x = 0, sum_y = 0, sum_xx = 0, sum_xy = 0;
+    calibration->lock_max_us = 0;
+    calibration->samples = 0;
+
+    for (size_t i = 0; i < CALIB_STEPS; i++) {
+        TEA5757_t from = probe;
+        uint32_t lock_us;
+
+        from.frequency = tea5767_checkFreqLimits(probe, station - steps[i]);
+        if (from.frequency == probe.frequency) {
+            from.frequency = tea5767_checkFreqLimits(probe, station + steps[i]);
+        }
+        from.settle_ms = radio->settle_ms;
+        tea5767_write_registers(from);
+
+        if (!tea5767_measureLock(probe, &lock_us)) {
+            // Off the probe frequencies, back to the settings the caller had
+            tea5767_write_registers(*radio);
+            return false;
+        }
+
+        float x = from.frequency > probe.frequency ? from.frequency - probe.frequency : probe.frequency - from.frequency;
+        sum_x += x;
+        sum_y += lock_us;
+        sum_xx += x * x;
+        sum_xy += x * lock_us;
+        calibration->samples++;
+        if (lock_us > calibration->lock_max_us) {
+            calibration->lock_max_us = lock_us;
+        }
+    }
+
+    float n = calibration->samples;
+    float den = n * sum_xx - sum_x * sum_x;
+    float slope = den != 0 ? (n * sum_xy - sum_x * sum_y) / den : 0;
+    if (slope < 0) {
+        slope = 0;
+    }
+    float base = (sum_y - slope * sum_x) / n;
+    calibration->lock_base_us = base > 0 ? base : 0;
+    calibration->lock_us_per_mhz = slope;
+
+    // Worst case jump is the whole band
+    float span = (radio->band_mode == JP_BAND) ? MAX_FREQ_JP - MIN_FREQ_JP : MAX_FREQ_EU - MIN_FREQ_EU;
+    uint32_t worst_us = tea5767_predictLock(calibration, span);
+    if (worst_us < calibration->lock_max_us) {
+        worst_us = calibration->lock_max_us;
+    }
+    radio->settle_ms = (worst_us + 999) / 1000;
+    radio->frequency = probe.frequency;
+    radio->searchMode = false;
+
+    return true;
+}
+
+uint32_t tea5767_predictLock(const TEA5767_calibration_t *calibration, float step_mhz) {
+    if (step_mhz < 0) {
+        step_mhz = -step_mhz;
+    }
+    return calibration->lock_base_us + (uint32_t)(calibration->lock_us_per_mhz * step_mhz);
+}
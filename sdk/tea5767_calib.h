@@ -0,0 +1,64 @@
+/**
+ ********************************************************************************
+ * @file    tea5767_calib.h
+ * @author  Carlos Egea
+ * @date    18/10/2026
+ * @brief   Timing calibration of the TEA5767 from measurements on real hardware.
+ ********************************************************************************
+ */
+
+#ifndef _HARDWARE_TEA5767_CALIB_H
+#define _HARDWARE_TEA5767_CALIB_H
+
+/************************************
+ * INCLUDES
+ ************************************/
+#include "tea5767_i2c.h"
+
+/************************************
+ * MACROS AND DEFINES
+ ************************************/
+#define TEA5767_CALIB_TRANSACTIONS 8 // Transactions averaged for the bus overhead
+#define TEA5767_CALIB_STABLE_READS 3 // Equal level readings needed to call the tuner settled
+#define TEA5767_CALIB_TIMEOUT_US 500000 // Give up on a lock measurement after this long
+
+/************************************
+ * TYPEDEFS
+ ************************************/
+/*! @brief Timing model fitted by tea5767_calibrate().
+* Lock time is modelled as lock_base_us + lock_us_per_mhz * step, step being the tuning jump in MHz.
+*/
+typedef struct {
+uint32_t read_us;               // Mean duration of one read transaction
+uint32_t write_us;              // Mean duration of one write transaction, without settle
+uint32_t lock_base_us;          // Lock time for a zero step
+uint32_t lock_us_per_mhz;       // Extra lock time per MHz of step
+uint32_t lock_max_us;           // Longest lock observed
+uint8_t samples;                // Lock measurements used in the fit
+} TEA5767_calibration_t;
+
+/************************************
+ * GLOBAL FUNCTION PROTOTYPES
+ ************************************/
+
+/*! @brief Measures bus overhead and lock time of the tuner and fits the timing model.
+* Jumps of increasing size are made towards a known station. After each jump the status is polled without
+* waiting until the IF counter is in range and the level is stable, which gives the lock and level settle time.
+* On success radio->settle_ms is set to the predicted lock time of a full band jump and the radio is left
+* tuned to the station.
+* @param radio Pointer to the TEA5757_t structure.
+* @param station Frequency in MHz of a station that can be received well.
+* @param calibration Filled with the fitted model.
+* @return bool false if the station never settled. radio is then left untouched and its settings are written back
+* to the tuner.
+*/
+bool tea5767_calibrate(TEA5757_t *radio, float station, TEA5767_calibration_t *calibration);
+
+/*! @brief Predicts the lock time of a tuning jump from a fitted model.
+* @param calibration Model filled by tea5767_calibrate().
+* @param step_mhz Size of the jump in MHz.
+* @return uint32_t Predicted lock time in microseconds.
+*/
+uint32_t tea5767_predictLock(const TEA5767_calibration_t *calibration, float step_mhz);
+
+#endif
@@ -0,0 +1,183 @@
+/**
+ ********************************************************************************
+ * @file    tea5767_capture.c
+ * @author  Carlos Egea
+ * @date    18/10/2026
+ * @brief   Round-robin ADC capture of the audio outputs of up to two TEA5767 tuners.
+ ********************************************************************************
+ */
+
+/************************************
+ * INCLUDES
+ ************************************/
+#include "hardware/adc.h"
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+#include "tea5767_audio.h"
+#include "tea5767_capture.h"
+
+/************************************
+ * STATIC VARIABLES
+ ************************************/
+static TEA5767_capture_t *active;
+
+/************************************
+ * STATIC FUNCTIONS
+ ************************************/
+// Re-arms whichever buffer just completed, its DMA channel is started again by the other one's chain
+static void capture_irq(void) {
+    for (uint8_t i = 0; i < 2; i++) {
+        if (dma_channel_get_irq0_status(active->dma[i])) {
+            dma_channel_acknowledge_irq0(active->dma[i]);
+            dma_channel_set_write_addr(active->dma[i], active->buffers[i], false);
+            active->blocks++;
+        }
+    }
+}
+
+/************************************
+ * GLOBAL FUNCTIONS
+ ************************************/
+bool tea5767_capture_init(TEA5767_capture_t *capture, uint8_t inputs, uint32_t rate) {
+    capture->inputs = inputs & ((1 << TEA5767_CAPTURE_INPUTS) - 1);
+    capture->channels = 0;
+    capture->blocks = 0;
+    capture->consumed = 0;
+    capture->overruns = 0;
+    for (uint8_t input = 0; input < TEA5767_CAPTURE_INPUTS; input++) {
+        capture->channels += (capture->inputs >> input) & 1;
+    }
+    if (capture->channels == 0 || rate == 0) {
+        return false;
+    }
+
+    // The ADC is shared, it is only touched once nothing else can fail
+    capture->dma[0] = dma_claim_unused_channel(false);
+    capture->dma[1] = dma_claim_unused_channel(false);
+    if (capture->dma[0] < 0 || capture->dma[1] < 0) {
+        if (capture->dma[0] >= 0) {
+            dma_channel_unclaim(capture->dma[0]);
+        }
+        if (capture->dma[1] >= 0) {
+            dma_channel_unclaim(capture->dma[1]);
+        }
+        return false;
+    }
+
+    // One conversion every period ADC clocks, never faster than a conversion takes. Whole clocks only,
+    // so period tells the exact rate the output side has to lock to.
+    uint32_t total = rate * capture->channels;
+    capture->period = (TEA5767_CAPTURE_ADC_HZ + total / 2) / total;
+    if (capture->period < TEA5767_CAPTURE_ADC_CYCLES) {
+        capture->period = TEA5767_CAPTURE_ADC_CYCLES;
+    }
+    capture->rate = TEA5767_CAPTURE_ADC_HZ / (capture->period * capture->channels);
+
+    for (uint8_t input = 0; input < TEA5767_CAPTURE_INPUTS; input++) {
+        if (capture->inputs & (1 << input)) {
+            adc_gpio_init(26 + input);
+        }
+    }
+    adc_init();
+    adc_set_clkdiv(capture->period - 1);
+    adc_fifo_setup(true, true, 1, false, false);
+
+    for (uint8_t i = 0; i < 2; i++) {
+        dma_channel_config config = dma_channel_get_default_config(capture->dma[i]);
+        channel_config_set_transfer_data_size(&config, DMA_SIZE_16);
+        channel_config_set_read_increment(&config, false);
+        channel_config_set_write_increment(&config, true);
+        channel_config_set_dreq(&config, DREQ_ADC);
+        channel_config_set_chain_to(&config, capture->dma[!i]);
+        dma_channel_configure(capture->dma[i], &config, capture->buffers[i], &adc_hw->fifo,
+                              TEA5767_CAPTURE_BLOCK * capture->channels, false);
+        dma_channel_set_irq0_enabled(capture->dma[i], true);
+    }
+    active = capture;
+    return true;
+}
+
+bool tea5767_capture_running(void) {
+    return active != 0;
+}
+
+void tea5767_capture_start(TEA5767_capture_t *capture) {
+    uint8_t first = 0;
+    while (!(capture->inputs & (1 << first))) {
+        first++;
+    }
+
+    irq_add_shared_handler(DMA_IRQ_0, capture_irq, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+    irq_set_enabled(DMA_IRQ_0, true);
+
+    // The round robin goes up from the selected input, starting at the lowest keeps blocks in input order
+    adc_select_input(first);
+    adc_set_round_robin(capture->inputs);
+    adc_fifo_drain();
+    dma_channel_start(capture->dma[0]);
+    adc_run(true);
+}
+
+void tea5767_capture_stop(TEA5767_capture_t *capture) {
+    adc_run(false);
+    adc_set_round_robin(0);
+    for (uint8_t i = 0; i < 2; i++) {
+        dma_channel_set_irq0_enabled(capture->dma[i], false);
+    }
+    tea5767_capture_abortChain(capture->dma);
+    for (uint8_t i = 0; i < 2; i++) {
+        dma_channel_unclaim(capture->dma[i]);
+    }
+    irq_remove_handler(DMA_IRQ_0, capture_irq);
+    adc_fifo_drain();
+    active = 0;
+}
+
+void tea5767_capture_abortChain(const int dma[2]) {
+    uint32_t mask = 0;
+
+    for (uint8_t i = 0; i < 2; i++) {
+        dma_channel_config config = dma_get_channel_config(dma[i]);
+        channel_config_set_chain_to(&config, dma[i]);
+        dma_channel_set_config(dma[i], &config, false);
+        mask |= 1u << dma[i];
+    }
+    dma_hw->abort = mask;
+    while (dma_hw->abort & mask) {
+        tight_loop_contents();
+    }
+    dma_hw->intr = mask;
+}
+
+const uint16_t *tea5767_capture_block(TEA5767_capture_t *capture) {
+    uint32_t blocks = capture->blocks;
+
+    if (blocks == capture->consumed) {
+        return 0;
+    }
+    capture->overruns += blocks - capture->consumed - 1;
+    capture->consumed = blocks;
+    return capture->buffers[(blocks - 1) & 1];
+}
+
+const uint16_t *tea5767_capture_channel(const TEA5767_capture_t *capture, const uint16_t *block, uint8_t input) {
+    uint8_t position = 0;
+
+    if (input >= TEA5767_CAPTURE_INPUTS || !(capture->inputs & (1 << input))) {
+        return 0;
+    }
+    for (uint8_t i = 0; i < input; i++) {
+        position += (capture->inputs >> i) & 1;
+    }
+    return block + position;
+}
+
+void tea5767_capture_levels(const TEA5767_capture_t *capture, const uint16_t *block,
+                            TEA5767_capture_levels_t *levels) {
+    for (uint8_t c = 0; c < capture->channels; c++) {
+        const uint16_t *x = block + c;
+        levels[c].rms = tea5767_audio_rms(x, TEA5767_CAPTURE_BLOCK, capture->channels);
+        levels[c].noise = tea5767_audio_noise(x, TEA5767_CAPTURE_BLOCK, capture->channels);
+        levels[c].crossings = tea5767_audio_zeroCrossings(x, TEA5767_CAPTURE_BLOCK, capture->channels);
+    }
+}
@@ -0,0 +1,118 @@
+/**
+ ********************************************************************************
+ * @file    tea5767_capture.h
+ * @author  Carlos Egea
+ * @date    18/10/2026
+ * @brief   Round-robin ADC capture of the audio outputs of up to two TEA5767 tuners.
+ ********************************************************************************
+ */
+
+#ifndef _HARDWARE_TEA5767_CAPTURE_H
+#define _HARDWARE_TEA5767_CAPTURE_H
+
+/************************************
+ * INCLUDES
+ ************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/************************************
+ * MACROS AND DEFINES
+ ************************************/
+#define TEA5767_CAPTURE_INPUTS 4 // ADC inputs on GPIO 26 to 29, L and R of two tuners
+#define TEA5767_CAPTURE_BLOCK 256 // Frames per block, one sample of every input each
+#define TEA5767_CAPTURE_ADC_HZ 48000000 // ADC clock
+#define TEA5767_CAPTURE_ADC_CYCLES 96 // ADC clock cycles per conversion, 500 ksps in total
+
+/*
+ * Blocks are stored interleaved in round-robin order, lowest input first. They are never
+ * copied apart: the audio kernels take the sample stride, so a channel of a block is
+ * processed in place with tea5767_capture_channel() as first sample and channels as stride.
+ */
+
+/************************************
+ * TYPEDEFS
+ ************************************/
+/*! @brief Capture engine. Two DMA channels chained to each other fill two block buffers in turn.
+*/
+typedef struct {
+uint8_t inputs;                 // ADC inputs captured, bit n for input n
+uint8_t channels;               // Number of inputs captured, the stride of a block
+uint32_t rate;                  // Sample rate per channel actually achieved, Hz, rounded down
+uint32_t period;                // ADC clocks per conversion, the exact rate is ADC_HZ / (period * channels)
+int dma[2];                     // DMA channel filling each buffer
+volatile uint32_t blocks;       // Blocks completed since start
+uint32_t consumed;              // Blocks handed out by tea5767_capture_block()
+uint32_t overruns;              // Blocks completed and overwritten before they were handed out
+uint16_t buffers[2][TEA5767_CAPTURE_BLOCK * TEA5767_CAPTURE_INPUTS];
+} TEA5767_capture_t;
+
+/*! @brief Audio figures of one channel of a block
+*/
+typedef struct {
+uint16_t rms;                   // Programme level, ADC counts
+uint16_t noise;                 // Noise floor estimate, ADC counts
+uint32_t crossings;             // Zero crossings in the block
+} TEA5767_capture_levels_t;
+
+/************************************
+ * GLOBAL FUNCTION PROTOTYPES
+ ************************************/
+
+/*! @brief Sets up the ADC and two DMA channels for a round-robin capture. Does not start it.
+* Only one capture can exist, there is a single ADC.
+* @param capture Capture to initialize.
+* @param inputs ADC inputs to capture, bit n for input n (GPIO 26 + n).
+* @param rate Requested sample rate per channel in Hz. The ADC is shared, so at most 500 kHz / channels.
+* @return bool false if no input is selected or no DMA channel is free. The ADC and its pins are then left
+* untouched.
+*/
+bool tea5767_capture_init(TEA5767_capture_t *capture, uint8_t inputs, uint32_t rate);
+
+/*! @brief Tells whether a capture owns the ADC, from tea5767_capture_init() to tea5767_capture_stop().
+* @return bool true while the ADC must not be reconfigured by anyone else.
+*/
+bool tea5767_capture_running(void);
+
+/*! @brief Starts capturing, from the lowest input.
+* @param capture Capture.
+*/
+void tea5767_capture_start(TEA5767_capture_t *capture);
+
+/*! @brief Stops capturing and releases the DMA channels.
+* @param capture Capture.
+*/
+void tea5767_capture_stop(TEA5767_capture_t *capture);
+
+/*! @brief Stops two DMA channels chained to each other. Each is chained to itself first and both are
+* aborted at once, as aborting them one at a time can let the other one retrigger it (RP2040-E13).
+* The completion flags the abort raises are cleared. Their interrupts should be disabled beforehand.
+* @param dma The two channels.
+*/
+void tea5767_capture_abortChain(const int dma[2]);
+
+/*! @brief Returns the newest complete block not handed out yet. Older ones left behind count as overruns.
+* The block stays valid for one block period, until the DMA comes back to its buffer.
+* @param capture Capture.
+* @return const uint16_t* Interleaved block, or NULL if no new block is complete.
+*/
+const uint16_t *tea5767_capture_block(TEA5767_capture_t *capture);
+
+/*! @brief First sample of an input in a block. Consecutive samples are capture->channels apart.
+* @param capture Capture.
+* @param block Block returned by tea5767_capture_block().
+* @param input ADC input, one of the captured ones.
+* @return const uint16_t* First sample, or NULL if the input is not captured.
+*/
+const uint16_t *tea5767_capture_channel(const TEA5767_capture_t *capture, const uint16_t *block, uint8_t input);
+
+/*! @brief Runs the audio kernels over every channel of a block, in place.
+* @param capture Capture.
+* @param block Block returned by tea5767_capture_block().
+* @param levels One entry per captured channel, lowest input first.
+*/
+void tea5767_capture_levels(const TEA5767_capture_t *capture, const uint16_t *block,
+                            TEA5767_capture_levels_t *levels);
+
+#endif
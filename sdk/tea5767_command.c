@@ -0,0 +1,252 @@
+/**
+ ********************************************************************************
+ * @file    tea5767_command.c
+ * @author  Carlos Egea
+ * @date    18/10/2026
+ * @brief   Compact binary command protocol and broker sharing one TEA5767 between several clients.
+ ********************************************************************************
+ */
+
+/************************************
+ * INCLUDES
+ ************************************/
+#include <string.h>
+#include "pico/time.h"
+#include "tea5767_command.h"
+
+/************************************
+ * STATIC FUNCTIONS
+ ************************************/
+static uint8_t command_check(const uint8_t *frame, size_t len) {
+    uint8_t check = 0;
+    for (size_t i = 0; i < len; i++) {
+        check ^= frame[i];
+    }
+    return check;
+}
+
+static void broker_reply(TEA5767_broker_t *broker, uint8_t type, uint8_t client, uint8_t seq,
+                         const uint8_t *payload, uint16_t len) {
+    uint8_t frame[TEA5767_CMD_FRAME_MAX];
+    size_t size = tea5767_command_encode(frame, type, client, seq, payload, len);
+    if (size) {
+        broker->send(client, frame, size, broker->user);
+    }
+}
+
+static void broker_error(TEA5767_broker_t *broker, uint8_t client, uint8_t seq, uint8_t code) {
+    broker->errors++;
+    broker_reply(broker, TEA5767_CMD_ERROR, client, seq, &code, 1);
+}
+
+// Applies one field to a copy of the settings, false if the field or its value is not valid
+static bool broker_field(TEA5757_t *radio, uint8_t field, uint16_t value) {
+    float freq;
+
+    switch (field) {
+        case TEA5767_FIELD_CHANNEL:
+            freq = value / 100.0f;
+            if (tea5767_checkFreqLimits(*radio, freq) != freq) {
+                return false;
+            }
+            radio->frequency = freq;
+            radio->searchMode = false;
+            return true;
+
+        case TEA5767_FIELD_MUTE:
+            radio->mute_mode = value != 0;
+            return true;
+
+        case TEA5767_FIELD_SOFT_MUTE:
+            radio->softMuteMode = value != 0;
+            return true;
+
+        case TEA5767_FIELD_STEREO:
+            radio->stereoMode = value == 0;
+            return true;
+
+        case TEA5767_FIELD_STANDBY:
+            radio->standby = value != 0;
+            return true;
+
+        case TEA5767_FIELD_PROFILE:
+            radio->softMuteMode = (value & TEA5767_AUDIO_SOFT_MUTE) != 0;
+            radio->hpfMode = (value & TEA5767_AUDIO_HIGH_CUT) != 0;
+            radio->stereoNoiseCancelling = (value & TEA5767_AUDIO_SNC) != 0;
+            radio->deemphasis = (value & TEA5767_AUDIO_DEEMPHASIS_75US) != 0;
+            return true;
+
+        case TEA5767_FIELD_MUTE_LEFT:
+            radio->muteLmode = value != 0;
+            return true;
+
+        case TEA5767_FIELD_MUTE_RIGHT:
+            radio->muteRmode = value != 0;
+            return true;
+
+        default:
+            return false;
+    }
+}
+
+static void broker_set(TEA5767_broker_t *broker, uint8_t client, uint8_t seq, const uint8_t *payload,
+                       uint16_t len) {
+    // All or nothing, the request is applied to a copy first
+    TEA5757_t staged = broker->staged;
+    if (len % 3) {
+        broker_error(broker, client, seq, TEA5767_ERR_FIELD);
+        return;
+    }
+    for (uint16_t i = 0; i < len; i += 3) {
+        if (!broker_field(&staged, payload[i], payload[i + 1] | payload[i + 2] << 8)) {
+            broker_error(broker, client, seq, TEA5767_ERR_FIELD);
+            return;
+        }
+    }
+    if (broker->waiting_count == TEA5767_BROKER_WAITING) {
+        tea5767_broker_flush(broker);
+    }
+    broker->staged = staged;
+    broker->waiting[broker->waiting_count].client = client;
+    broker->waiting[broker->waiting_count].seq = seq;
+    broker->waiting_count++;
+}
+
+static void broker_status(TEA5767_broker_t *broker, uint8_t client, uint8_t seq, const uint8_t *payload,
+                          uint16_t len) {
+    uint32_t max_age_us = (len >= 2 ? (payload[0] | payload[1] << 8) : TEA5767_BROKER_STATUS_AGE_MS) * 1000;
+    uint64_t now = time_us_64();
+
+    if (broker->status_us == 0 || now - broker->status_us > max_age_us) {
+        tea5767_getStatus(*broker->radio, &broker->status);
+        broker->status_us = now = time_us_64();
+        broker->status_reads++;
+    } else {
+        broker->status_hits++;
+    }
+
+    uint32_t age_ms = (now - broker->status_us) / 1000;
+    uint8_t reply[9] = {
+        broker->status.ready, broker->status.bandLimit, broker->status.stereo, broker->status.ifCounter,
+        broker->status.level, broker->status.pll & 0xff, broker->status.pll >> 8,
+        age_ms > 0xffff ? 0xff : age_ms & 0xff, age_ms > 0xffff ? 0xff : age_ms >> 8
+    };
+    broker_reply(broker, TEA5767_CMD_STATUS | TEA5767_CMD_REPLY, client, seq, reply, sizeof(reply));
+}
+
+static void broker_stations(TEA5767_broker_t *broker, uint8_t client, uint8_t seq, const uint8_t *payload,
+                            uint16_t len) {
+    uint8_t message[TEA5767_CMD_PAYLOAD_MAX];
+
+    if (!broker->db || len < 4) {
+        broker_error(broker, client, seq, broker->db ? TEA5767_ERR_FRAME : TEA5767_ERR_TYPE);
+        return;
+    }
+    uint32_t since = payload[0] | payload[1] << 8 | payload[2] << 16 | (uint32_t)payload[3] << 24;
+    size_t size = tea5767_stations_delta(broker->db, since, message, sizeof(message));
+    broker_reply(broker, TEA5767_CMD_STATIONS | TEA5767_CMD_REPLY, client, seq, message, size);
+}
+
+/************************************
+ * GLOBAL FUNCTIONS
+ ************************************/
+size_t tea5767_command_encode(uint8_t *frame, uint8_t type, uint8_t client, uint8_t seq,
+                              const uint8_t *payload, uint16_t len) {
+    if (len > TEA5767_CMD_PAYLOAD_MAX) {
+        return 0;
+    }
+    frame[0] = type;
+    frame[1] = client;
+    frame[2] = seq;
+    frame[3] = len & 0xff;
+    frame[4] = len >> 8;
+    if (len) {
+        memcpy(frame + TEA5767_CMD_HEADER, payload, len);
+    }
+    frame[TEA5767_CMD_HEADER + len] = command_check(frame, TEA5767_CMD_HEADER + len);
+    return TEA5767_CMD_HEADER + len + TEA5767_CMD_TRAILER;
+}
+
+bool tea5767_command_decode(const uint8_t *frame, size_t len, const uint8_t **payload, uint16_t *payload_len) {
+    if (len < TEA5767_CMD_HEADER + TEA5767_CMD_TRAILER) {
+        return false;
+    }
+    uint16_t size = frame[3] | frame[4] << 8;
+    if (size > TEA5767_CMD_PAYLOAD_MAX || len != (size_t)TEA5767_CMD_HEADER + size + TEA5767_CMD_TRAILER
+            || command_check(frame, len) != 0) {
+        return false;
+    }
+    *payload = frame + TEA5767_CMD_HEADER;
+    *payload_len = size;
+    return true;
+}
+
+void tea5767_broker_init(TEA5767_broker_t *broker, TEA5757_t *radio, TEA5767_stations_t *db,
+                         TEA5767_command_send_cb send, void *user) {
+    memset(broker, 0, sizeof(*broker));
+    broker->radio = radio;
+    broker->staged = *radio;
+    broker->db = db;
+    broker->send = send;
+    broker->user = user;
+    tea5767_encode_registers(*radio, broker->written);
+}
+
+void tea5767_broker_handle(TEA5767_broker_t *broker, const uint8_t *frame, size_t len) {
+    const uint8_t *payload;
+    uint16_t payload_len;
+
+    broker->requests++;
+    if (!tea5767_command_decode(frame, len, &payload, &payload_len)) {
+        // The client and sequence are echoed as received, they may be garbage too
+        broker_error(broker, len > 1 ? frame[1] : 0, len > 2 ? frame[2] : 0, TEA5767_ERR_FRAME);
+        return;
+    }
+    switch (frame[0]) {
+        case TEA5767_CMD_SET:
+            broker_set(broker, frame[1], frame[2], payload, payload_len);
+            break;
+
+        case TEA5767_CMD_STATUS:
+            broker_status(broker, frame[1], frame[2], payload, payload_len);
+            break;
+
+        case TEA5767_CMD_STATIONS:
+            broker_stations(broker, frame[1], frame[2], payload, payload_len);
+            break;
+
+        default:
+            broker_error(broker, frame[1], frame[2], TEA5767_ERR_TYPE);
+            break;
+    }
+}
+
+bool tea5767_broker_flush(TEA5767_broker_t *broker) {
+    uint8_t registers[TEA5767_REGISTERS];
+    bool written = false;
+
+    if (broker->waiting_count == 0) {
+        return false;
+    }
+    // Requests that cancel each other out leave the image unchanged and cost no bus traffic
+    tea5767_encode_registers(broker->staged, registers);
+    if (memcmp(registers, broker->written, TEA5767_REGISTERS) != 0) {
+        *broker->radio = broker->staged;
+        tea5767_write_registers(*broker->radio);
+        memcpy(broker->written, registers, TEA5767_REGISTERS);
+        broker->status_us = 0;
+        broker->writes++;
+        broker->coalesced += broker->waiting_count - 1;
+        written = true;
+    } else {
+        broker->coalesced += broker->waiting_count;
+    }
+
+    uint8_t result = 0;
+    for (uint8_t i = 0; i < broker->waiting_count; i++) {
+        broker_reply(broker, TEA5767_CMD_SET | TEA5767_CMD_REPLY, broker->waiting[i].client,
+                     broker->waiting[i].seq, &result, 1);
+    }
+    broker->waiting_count = 0;
+    return written;
+}
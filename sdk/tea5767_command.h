@@ -0,0 +1,136 @@
+/**
+ ********************************************************************************
+ * @file    tea5767_command.h
+ * @author  Carlos Egea
+ * @date    18/10/2026
+ * @brief   Compact binary command protocol and broker sharing one TEA5767 between several clients.
+ ********************************************************************************
+ */
+
+#ifndef _HARDWARE_TEA5767_COMMAND_H
+#define _HARDWARE_TEA5767_COMMAND_H
+
+/************************************
+ * INCLUDES
+ ************************************/
+#include "tea5767_i2c.h"
+#include "tea5767_stations.h"
+
+/************************************
+ * MACROS AND DEFINES
+ ************************************/
+#define TEA5767_CMD_HEADER 5 // Frame header: type (1), client (1), sequence (1), payload length (2)
+#define TEA5767_CMD_TRAILER 1 // Frame trailer: XOR of every previous byte
+#define TEA5767_CMD_PAYLOAD_MAX (TEA5767_SYNC_HEADER + TEA5767_STATIONS_MAX * TEA5767_SYNC_ENTRY)
+#define TEA5767_CMD_FRAME_MAX (TEA5767_CMD_HEADER + TEA5767_CMD_PAYLOAD_MAX + TEA5767_CMD_TRAILER)
+
+#define TEA5767_CMD_SET 0x10 // Stage settings: pairs of field (1) and value (2), acknowledged after the write
+#define TEA5767_CMD_STATUS 0x11 // Read status: optional oldest acceptable age in ms (2)
+#define TEA5767_CMD_STATIONS 0x12 // Station database changes since a version (4)
+#define TEA5767_CMD_REPLY 0x80 // Set in the type of a reply to the request type
+#define TEA5767_CMD_ERROR 0xff // Error reply: code (1)
+
+#define TEA5767_FIELD_CHANNEL 0x01 // Tuned channel, station database units (10 kHz)
+#define TEA5767_FIELD_MUTE 0x02
+#define TEA5767_FIELD_SOFT_MUTE 0x03
+#define TEA5767_FIELD_STEREO 0x04
+#define TEA5767_FIELD_STANDBY 0x05
+#define TEA5767_FIELD_PROFILE 0x06 // TEA5767_AUDIO_* bits, as tea5767_setAudioProfile()
+#define TEA5767_FIELD_MUTE_LEFT 0x07
+#define TEA5767_FIELD_MUTE_RIGHT 0x08
+
+#define TEA5767_ERR_FRAME 0x01 // Truncated frame, bad length or checksum
+#define TEA5767_ERR_TYPE 0x02 // Unknown request type
+#define TEA5767_ERR_FIELD 0x03 // Unknown field or value out of range, nothing of the request was staged
+
+#define TEA5767_BROKER_WAITING 64 // Set requests waiting for the next write, a full queue forces one
+#define TEA5767_BROKER_STATUS_AGE_MS 50 // Default oldest cached status served
+
+/************************************
+ * TYPEDEFS
+ ************************************/
+/*! @brief Sends a reply frame back to a client, over whatever transport it came from
+*/
+typedef void (*TEA5767_command_send_cb)(uint8_t client, const uint8_t *frame, size_t len, void *user);
+
+/*! @brief Set request waiting for its write
+*/
+typedef struct {
+uint8_t client;
+uint8_t seq;
+} TEA5767_waiting_t;
+
+/*! @brief Broker. The only owner of the tuner, clients go through it with command frames.
+* Settings from any number of requests are staged and written together, status is served from a cache.
+* Frames must be handed to the broker from one context only, which serialises them.
+*/
+typedef struct {
+TEA5757_t *radio;               // Tuner, written only by tea5767_broker_flush()
+TEA5757_t staged;               // Settings requested since the last write
+uint8_t written[TEA5767_REGISTERS]; // Register image last written
+TEA5767_stations_t *db;         // Station database served, or NULL
+TEA5767_status_t status;        // Cached status
+uint64_t status_us;             // Time of the cached status, 0 if none
+TEA5767_command_send_cb send;
+void *user;
+uint8_t waiting_count;
+TEA5767_waiting_t waiting[TEA5767_BROKER_WAITING];
+uint32_t requests;              // Frames handled
+uint32_t errors;                // Error replies sent
+uint32_t writes;                // Register writes issued
+uint32_t coalesced;             // Set requests acknowledged without a write of their own
+uint32_t status_reads;          // Status requests that read the tuner
+uint32_t status_hits;           // Status requests served from the cache
+} TEA5767_broker_t;
+
+/************************************
+ * GLOBAL FUNCTION PROTOTYPES
+ ************************************/
+
+/*! @brief Builds a frame.
+* @param frame Output buffer, at least \ref TEA5767_CMD_FRAME_MAX bytes or the frame size.
+* @param type Request or reply type.
+* @param client Client identifier, echoed in the reply.
+* @param seq Sequence number, echoed in the reply.
+* @param payload Payload, or NULL if len is 0.
+* @param len Payload length, up to \ref TEA5767_CMD_PAYLOAD_MAX.
+* @return size_t Frame size, 0 if the payload is too long.
+*/
+size_t tea5767_command_encode(uint8_t *frame, uint8_t type, uint8_t client, uint8_t seq,
+                              const uint8_t *payload, uint16_t len);
+
+/*! @brief Checks a frame and locates its payload.
+* @param frame Frame.
+* @param len Frame size.
+* @param payload Set to the payload.
+* @param payload_len Set to the payload length.
+* @return bool false if the frame is truncated or its checksum does not match.
+*/
+bool tea5767_command_decode(const uint8_t *frame, size_t len, const uint8_t **payload, uint16_t *payload_len);
+
+/*! @brief Initializes a broker for a tuner.
+* @param broker Broker.
+* @param radio Tuner, owned by the broker from now on.
+* @param db Station database served to TEA5767_CMD_STATIONS, or NULL.
+* @param send Reply callback.
+* @param user Passed to send.
+*/
+void tea5767_broker_init(TEA5767_broker_t *broker, TEA5757_t *radio, TEA5767_stations_t *db,
+                         TEA5767_command_send_cb send, void *user);
+
+/*! @brief Handles one request frame. Status and station requests are answered at once, settings are
+* staged and acknowledged by the next tea5767_broker_flush().
+* @param broker Broker.
+* @param frame Request frame.
+* @param len Frame size.
+*/
+void tea5767_broker_handle(TEA5767_broker_t *broker, const uint8_t *frame, size_t len);
+
+/*! @brief Writes the staged settings to the tuner in one write, if they changed the register image,
+* and acknowledges every set request waiting. Call once per poll of the transports.
+* @param broker Broker.
+* @return bool true if the tuner was written.
+*/
+bool tea5767_broker_flush(TEA5767_broker_t *broker);
+
+#endif
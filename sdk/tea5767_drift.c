@@ -0,0 +1,112 @@
+/**
+ ********************************************************************************
+ * @file    tea5767_drift.c
+ * @author  Carlos Egea
+ * @date    18/10/2026
+ * @brief   Reference crystal drift tracking and predictive PLL correction.
+ ********************************************************************************
+ */
+
+/************************************
+ * INCLUDES
+ ************************************/
+#include <string.h>
+#include "hardware/adc.h"
+#include "tea5767_capture.h"
+#include "tea5767_drift.h"
+
+/************************************
+ * PRIVATE MACROS AND DEFINES
+ ************************************/
+#define TEMPERATURE_INPUT 4 // ADC input of the on-chip sensor
+
+/************************************
+ * STATIC FUNCTIONS
+ ************************************/
+static bool if_valid(const TEA5767_status_t *status) {
+    return status->ifCounter >= TEA5767_IF_MIN && status->ifCounter <= TEA5767_IF_MAX;
+}
+
+/************************************
+ * GLOBAL FUNCTIONS
+ ************************************/
+uint8_t tea5767_afc(TEA5757_t *radio, uint8_t max_iterations) {
+    TEA5767_status_t status;
+    uint8_t iterations = 0;
+
+    tea5767_getStatus(*radio, &status);
+    while (iterations < max_iterations && if_valid(&status)) {
+        int error = (int)status.ifCounter - TEA5767_IF_CENTER;
+        if (error <= TEA5767_AFC_TOLERANCE && error >= -TEA5767_AFC_TOLERANCE) {
+            break;
+        }
+        // High side injection: a high IF means the LO is high, lower the PLL word
+        radio->pll_offset -= error / 2;
+        tea5767_write_registers(*radio);
+        tea5767_getStatus(*radio, &status);
+        iterations++;
+    }
+    return iterations;
+}
+
+void tea5767_drift_init(TEA5767_drift_t *drift) {
+    memset(drift, 0, sizeof(*drift));
+}
+
+bool tea5767_drift_observe(TEA5767_drift_t *drift, TEA5757_t radio, const TEA5767_status_t *status, float x) {
+    if (status->level < TEA5767_DRIFT_MIN_LEVEL || !if_valid(status)) {
+        return false;
+    }
+    // Correction that would have centred this reading
+    float y = radio.pll_offset - ((int)status->ifCounter - TEA5767_IF_CENTER) / 2.0f;
+
+    drift->weight = drift->weight * TEA5767_DRIFT_DECAY + 1;
+    drift->sum_x = drift->sum_x * TEA5767_DRIFT_DECAY + x;
+    drift->sum_y = drift->sum_y * TEA5767_DRIFT_DECAY + y;
+    drift->sum_xx = drift->sum_xx * TEA5767_DRIFT_DECAY + x * x;
+    drift->sum_xy = drift->sum_xy * TEA5767_DRIFT_DECAY + x * y;
+    return true;
+}
+
+int16_t tea5767_drift_predict(const TEA5767_drift_t *drift, float x) {
+    if (drift->weight <= 0) {
+        return 0;
+    }
+    float den = drift->weight * drift->sum_xx - drift->sum_x * drift->sum_x;
+    // Too little spread in x for a slope yet, use the mean correction
+    float slope = den > 1e-3f * drift->weight * drift->weight
+            ? (drift->weight * drift->sum_xy - drift->sum_x * drift->sum_y) / den : 0;
+    float offset = (drift->sum_y - slope * drift->sum_x) / drift->weight;
+    float y = offset + slope * x;
+    return (int16_t)(y < 0 ? y - 0.5f : y + 0.5f);
+}
+
+uint8_t tea5767_tunePredicted(TEA5757_t *radio, TEA5767_drift_t *drift, float x, float freq, uint8_t max_iterations) {
+    TEA5767_status_t status;
+
+    radio->pll_offset = tea5767_drift_predict(drift, x);
+    tea5767_setStation(radio, freq);
+    uint8_t iterations = tea5767_afc(radio, max_iterations);
+
+    tea5767_getStatus(*radio, &status);
+    tea5767_drift_observe(drift, *radio, &status, x);
+    drift->tunes++;
+    drift->afc_iterations += iterations;
+    return iterations;
+}
+
+bool tea5767_drift_readTemperature(float *celsius) {
+    if (tea5767_capture_running()) {
+        return false;
+    }
+    // adc_init() resets the whole block, only do it the first time
+    if (!(adc_hw->cs & ADC_CS_EN_BITS)) {
+        adc_init();
+    }
+    // 12-bit conversion, 3.3 V reference. Sensor: 0.706 V at 27 C, -1.721 mV/C (RP2040 datasheet).
+    adc_set_temp_sensor_enabled(true);
+    adc_select_input(TEMPERATURE_INPUT);
+    float voltage = adc_read() * 3.3f / (1 << 12);
+    *celsius = 27.0f - (voltage - 0.706f) / 0.001721f;
+    return true;
+}
@@ -0,0 +1,96 @@
+/**
+ ********************************************************************************
+ * @file    tea5767_drift.h
+ * @author  Carlos Egea
+ * @date    18/10/2026
+ * @brief   Reference crystal drift tracking and predictive PLL correction.
+ ********************************************************************************
+ */
+
+#ifndef _HARDWARE_TEA5767_DRIFT_H
+#define _HARDWARE_TEA5767_DRIFT_H
+
+/************************************
+ * INCLUDES
+ ************************************/
+#include "tea5767_i2c.h"
+
+/************************************
+ * MACROS AND DEFINES
+ ************************************/
+#define TEA5767_AFC_TOLERANCE 1 // IF counter error accepted by the AFC, in counts
+#define TEA5767_DRIFT_DECAY 0.98f // Weight kept by older observations at each new one
+#define TEA5767_DRIFT_MIN_LEVEL ADC_MID // Only stations this strong are used to track the drift
+
+/************************************
+ * TYPEDEFS
+ ************************************/
+/*! @brief Linear drift model, PLL correction = offset + slope * x.
+* x is whatever the drift follows: the RP2040 temperature from tea5767_drift_readTemperature(),
+* or the uptime in hours. The fit is a least squares one with exponential forgetting, so it follows ageing.
+*/
+typedef struct {
+float weight;                   // Sum of the observation weights
+float sum_x;                    // Weighted sums of the least squares fit
+float sum_y;
+float sum_xx;
+float sum_xy;
+uint32_t tunes;                 // Tunes done by tea5767_tunePredicted()
+uint32_t afc_iterations;        // AFC iterations those tunes needed
+} TEA5767_drift_t;
+
+/************************************
+ * GLOBAL FUNCTION PROTOTYPES
+ ************************************/
+
+/*! @brief Nudges radio->pll_offset until the IF counter is centred.
+* The IF counter counts in steps of about 4 kHz and the PLL in steps of about 8 kHz, so half the IF error
+* is taken off the PLL word at each iteration. Each iteration is one write and one read.
+* @param radio Pointer to the TEA5757_t structure, tuned to a station.
+* @param max_iterations Maximum corrections tried.
+* @return uint8_t Corrections that were needed, 0 if the tuner was already centred.
+*/
+uint8_t tea5767_afc(TEA5757_t *radio, uint8_t max_iterations);
+
+/*! @brief Initializes an empty drift model. It predicts no correction until it has observations.
+* @param drift Model to initialize.
+*/
+void tea5767_drift_init(TEA5767_drift_t *drift);
+
+/*! @brief Adds an observation of the IF offset on the current station.
+* Weak stations and readings with the IF counter out of range are ignored.
+* @param drift Model.
+* @param radio The TEA5757_t structure the reading was taken with, for its current pll_offset.
+* @param status Reading taken on the station.
+* @param x Value of the drift variable when the reading was taken.
+* @return bool true if the observation was used.
+*/
+bool tea5767_drift_observe(TEA5767_drift_t *drift, TEA5757_t radio, const TEA5767_status_t *status, float x);
+
+/*! @brief Predicts the PLL correction for a value of the drift variable.
+* @param drift Model.
+* @param x Value of the drift variable.
+* @return int16_t Value for radio->pll_offset.
+*/
+int16_t tea5767_drift_predict(const TEA5767_drift_t *drift, float x);
+
+/*! @brief Tunes a station with the predicted correction already applied, then runs the AFC and learns
+* from the result. drift->afc_iterations / drift->tunes gives the AFC iterations per tune.
+* @param radio Pointer to the TEA5757_t structure.
+* @param drift Model.
+* @param x Current value of the drift variable.
+* @param freq Frequency in MHz.
+* @param max_iterations Maximum AFC corrections tried.
+* @return uint8_t AFC iterations that were still needed.
+*/
+uint8_t tea5767_tunePredicted(TEA5757_t *radio, TEA5767_drift_t *drift, float x, float freq, uint8_t max_iterations);
+
+/*! @brief Reads the RP2040 on-chip temperature sensor with a single conversion.
+* The ADC is only initialized if nothing else did, and it is left alone while a tea5767_capture owns it:
+* a conversion would then break the round robin and the DMA pacing of the audio.
+* @param celsius Filled with the temperature in degrees Celsius.
+* @return bool false if a capture is using the ADC, celsius is then unchanged.
+*/
+bool tea5767_drift_readTemperature(float *celsius);
+
+#endif
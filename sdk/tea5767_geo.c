@@ -0,0 +1,88 @@
+/**
+ ********************************************************************************
+ * @file    tea5767_geo.c
+ * @author  Carlos Egea
+ * @date    18/10/2026
+ * @brief   Location indexed frequency selection for mobile units.
+ ********************************************************************************
+ */
+
+/************************************
+ * INCLUDES
+ ************************************/
+#include "tea5767_geo.h"
+#include "tea5767_stations.h"
+
+/************************************
+ * PRIVATE MACROS AND DEFINES
+ ************************************/
+#define GEO_LAT_MAX_E7 900000000 // 90 degrees
+#define GEO_LON_MAX_E7 1800000000 // 180 degrees
+
+/************************************
+ * STATIC FUNCTIONS
+ ************************************/
+// Extrapolates a coordinate in 64 bits, a difference between two int32 may not fit one
+static int32_t geo_ahead(int32_t current, int32_t previous, int64_t max, bool wraps) {
+    int64_t step = (int64_t)current - previous;
+    if (wraps) {
+        // Across the antimeridian the short way round is the real movement
+        if (step > max) {
+            step -= 2 * max;
+        } else if (step < -max) {
+            step += 2 * max;
+        }
+    }
+    int64_t ahead = current + step * TEA5767_GEO_LOOKAHEAD;
+    if (wraps) {
+        ahead = ((ahead + max) % (2 * max) + 2 * max) % (2 * max) - max;
+    }
+    return ahead > max ? max : ahead < -max ? -max : ahead;
+}
+
+/************************************
+ * GLOBAL FUNCTIONS
+ ************************************/
+const uint8_t *tea5767_geo_lookup(const TEA5767_geo_t *index, int32_t lat_e7, int32_t lon_e7) {
+    if (lat_e7 < index->lat_e7 || lon_e7 < index->lon_e7) {
+        return NULL;
+    }
+    // Unsigned, a grid can span more than 2^31 units of 1e-7 degrees
+    uint32_t row = ((uint32_t)lat_e7 - (uint32_t)index->lat_e7) / index->cell_e7;
+    uint32_t col = ((uint32_t)lon_e7 - (uint32_t)index->lon_e7) / index->cell_e7;
+    if (row >= index->rows || col >= index->cols) {
+        return NULL;
+    }
+    return &index->cells[(row * index->cols + col) * TEA5767_GEO_RANKS];
+}
+
+uint16_t tea5767_geo_channel(const TEA5767_geo_t *index, uint8_t rank) {
+    return rank ? index->first_channel + (rank - 1) * 10 : 0;
+}
+
+bool tea5767_geo_follow(TEA5757_t *radio, const TEA5767_geo_t *index, const TEA5767_position_t *previous,
+                        const TEA5767_position_t *current) {
+    if (!current->fix) {
+        return false;
+    }
+    int32_t lat_e7 = current->lat_e7;
+    int32_t lon_e7 = current->lon_e7;
+    if (previous->fix) {
+        lat_e7 = geo_ahead(current->lat_e7, previous->lat_e7, GEO_LAT_MAX_E7, false);
+        lon_e7 = geo_ahead(current->lon_e7, previous->lon_e7, GEO_LON_MAX_E7, true);
+    }
+
+    const uint8_t *ranks = tea5767_geo_lookup(index, lat_e7, lon_e7);
+    if (ranks == NULL || ranks[0] == 0) {
+        return false;
+    }
+    // Nearest 100 kHz channel, the frequency may come from a PLL readout
+    uint16_t tuned = (tea5767_stations_channel(radio->frequency) + 5) / 10 * 10;
+    for (int i = 0; i < TEA5767_GEO_RANKS && ranks[i]; i++) {
+        if (tea5767_geo_channel(index, ranks[i]) == tuned) {
+            return false;
+        }
+    }
+    tea5767_setStation(radio, tea5767_geo_channel(index, ranks[0]) / 100.0f);
+    return true;
+}
@@ -0,0 +1,76 @@
+/**
+ ********************************************************************************
+ * @file    tea5767_geo.h
+ * @author  Carlos Egea
+ * @date    18/10/2026
+ * @brief   Location indexed frequency selection for mobile units.
+ ********************************************************************************
+ */
+
+#ifndef _HARDWARE_TEA5767_GEO_H
+#define _HARDWARE_TEA5767_GEO_H
+
+/************************************
+ * INCLUDES
+ ************************************/
+#include "tea5767_i2c.h"
+#include "tea5767_nmea.h"
+
+/************************************
+ * MACROS AND DEFINES
+ ************************************/
+#define TEA5767_GEO_RANKS 4 // Frequencies kept per cell, best first
+#define TEA5767_GEO_LOOKAHEAD 2 // Position updates extrapolated ahead when following
+
+/************************************
+ * TYPEDEFS
+ ************************************/
+/*! @brief Grid of cells over an area, each listing the best frequencies of one programme there.
+* Cells are stored row by row from the south west corner, \ref TEA5767_GEO_RANKS bytes each. A byte is
+* a channel number counted in 100 kHz steps from first_channel, plus one; 0 marks an empty rank.
+* The table is const so it stays in flash. With 0.01 degree cells a cell is about 0.8 km^2 at
+* mid latitudes, that is about 5 bytes per km^2.
+*/
+typedef struct {
+int32_t lat_e7;                 // Latitude of the south west corner, degrees * 1e7
+int32_t lon_e7;                 // Longitude of the south west corner, degrees * 1e7
+int32_t cell_e7;                // Cell side, degrees * 1e7
+uint16_t rows;                  // Cells from south to north
+uint16_t cols;                  // Cells from west to east
+uint16_t first_channel;         // Channel of rank byte 1, station database units
+const uint8_t *cells;           // rows * cols * TEA5767_GEO_RANKS bytes
+} TEA5767_geo_t;
+
+/************************************
+ * GLOBAL FUNCTION PROTOTYPES
+ ************************************/
+
+/*! @brief Returns the ranked frequencies of the cell containing a position. Constant time.
+* @param index Grid.
+* @param lat_e7 Latitude, degrees * 1e7.
+* @param lon_e7 Longitude, degrees * 1e7.
+* @return const uint8_t* \ref TEA5767_GEO_RANKS rank bytes, or NULL outside the grid.
+*/
+const uint8_t *tea5767_geo_lookup(const TEA5767_geo_t *index, int32_t lat_e7, int32_t lon_e7);
+
+/*! @brief Converts a rank byte to a channel.
+* @param index Grid.
+* @param rank Rank byte from tea5767_geo_lookup().
+* @return uint16_t Channel in station database units, 0 for an empty rank.
+*/
+uint16_t tea5767_geo_channel(const TEA5767_geo_t *index, uint8_t rank);
+
+/*! @brief Retunes ahead of the unit's movement.
+* The position is extrapolated \ref TEA5767_GEO_LOOKAHEAD updates ahead from the last two fixes, the short
+* way round across the antimeridian, and kept within +-90 degrees of latitude. If the current frequency is
+* not listed for the cell there, the radio is tuned to that cell's best one, before the current signal fades.
+* @param radio Pointer to the TEA5757_t structure.
+* @param index Grid of the programme listened to.
+* @param previous Previous fix.
+* @param current Latest fix.
+* @return bool true if the radio was retuned.
+*/
+bool tea5767_geo_follow(TEA5757_t *radio, const TEA5767_geo_t *index, const TEA5767_position_t *previous,
+                        const TEA5767_position_t *current);
+
+#endif
@@ -10,10 +10,12 @@
 /************************************
  * INCLUDES
  ************************************/
+#include <string.h>
 #include <hardware/gpio.h>
 #include "pico/binary_info.h"
 #include "hardware/i2c.h"
 #include "tea5767_i2c.h"
+#include "tea5767_profile.h"
 
 /************************************
  * EXTERN VARIABLES
@@ -30,6 +32,9 @@
 /************************************
  * STATIC VARIABLES
  ************************************/
+// Last mux and channel mask selected on each I2C controller, to skip redundant selects
+static uint8_t mux_address[2];
+static uint8_t mux_mask[2];
 
 /************************************
  * GLOBAL VARIABLES
@@ -42,34 +47,141 @@
 /************************************
  * STATIC FUNCTIONS
  ************************************/
+// Returns false if a mux did not acknowledge. The cache then only holds what is known to be selected, so the
+// next call selects again instead of writing through a path that was never opened.
+static bool tea5767_mux_select(i2c_inst_t *i2c, uint8_t address, uint8_t mask) {
+    uint index = i2c_hw_index(i2c);
+    if (mux_address[index] == address && (address == 0 || mux_mask[index] == mask)) {
+        return true;
+    }
+    // Tuners share one address, a different mux must close its channels before another path opens
+    if (mux_address[index] != 0 && mux_address[index] != address) {
+        uint8_t none = 0;
+        if (i2c_write_blocking(i2c, mux_address[index], &none, 1, false) != 1) {
+            return false;
+        }
+        mux_address[index] = 0;
+    }
+    if (address != 0 && i2c_write_blocking(i2c, address, &mask, 1, false) != 1) {
+        return false;
+    }
+    mux_address[index] = address;
+    mux_mask[index] = mask;
+    return true;
+}
 
 /************************************
  * GLOBAL FUNCTIONS
  ************************************/
 void tea5767_read_raw(TEA5757_t radio,uint8_t *buffer) {
-    i2c_read_blocking(i2c_default, radio.address, buffer, TEA5767_REGISTERS, false);
+    TEA5767_PROFILE_ENTER(TEA5767_REGION_BUS_READ);
+    if (tea5767_mux_select(radio.i2c, radio.mux_address, 1 << radio.mux_channel)) {
+        i2c_read_blocking(radio.i2c, radio.address, buffer, TEA5767_REGISTERS, false);
+    } else {
+        memset(buffer, 0, TEA5767_REGISTERS);
+    }
+    TEA5767_PROFILE_EXIT();
 }
 
-void tea5767_write_registers(TEA5757_t radio) {
-    uint8_t registers[TEA5767_REGISTERS];
+void tea5767_encode_registers(TEA5757_t radio, uint8_t *registers) {
+    TEA5767_PROFILE_ENTER(TEA5767_REGION_ENCODE);
     // Calculate the frequency value to be written to the TEA5767 register based on the current radio frequency in MHz. 
     // The calculation takes into account the fixed offset of 225kHz and the 4:1 prescaler used by the TEA5767 module.
     float freq = 4*(radio.frequency * 1000000 + 225000) / 32768; 
-    int integer_freq = freq;
+    int integer_freq = (int)freq + radio.pll_offset;
     registers[0] = integer_freq >> 8 | radio.mute_mode << 7 | radio.searchMode << 6;
     registers[1] = integer_freq & 0xff;
     registers[2] = radio.searchUpDown << 7 | radio.searchLevel << 5 | 1 << 4 | radio.stereoMode << 3
             | radio.muteRmode << 2 | radio.muteLmode << 1;
     registers[3] = radio.standby << 6 | radio.band_mode << 5 | 1 << 4 | radio.softMuteMode << 3 | radio.hpfMode << 2;
     registers[3] = registers[3] | radio.stereoNoiseCancelling << 1;
-    registers[4] = 0x00;
-    i2c_write_blocking(i2c_default, radio.address, registers, TEA5767_REGISTERS, false);
+    registers[4] = radio.deemphasis << 6;
+    TEA5767_PROFILE_EXIT();
+}
+
+void tea5767_write_registers(TEA5757_t radio) {
+    uint8_t registers[TEA5767_REGISTERS];
+    tea5767_encode_registers(radio, registers);
+    TEA5767_PROFILE_ENTER(TEA5767_REGION_BUS_WRITE);
+    if (tea5767_mux_select(radio.i2c, radio.mux_address, 1 << radio.mux_channel)) {
+        i2c_write_blocking(radio.i2c, radio.address, registers, TEA5767_REGISTERS, false);
+    }
+    TEA5767_PROFILE_SWITCH(TEA5767_REGION_SETTLE);
     // TODO: Use a timer instead.
-    sleep_ms(100);
+    if (radio.settle_ms) {
+        sleep_ms(radio.settle_ms);
+    }
+    TEA5767_PROFILE_EXIT();
 }
 
-TEA5757_t tea5767_init(){
+bool tea5767_write_broadcast(TEA5757_t *radios, uint8_t count, bool verify) {
+    uint8_t registers[TEA5767_REGISTERS];
+    uint16_t settle_ms = 0;
+    bool ok = true;
+
+    if (count > TEA5767_BROADCAST_MAX) {
+        return false;
+    }
+
+    // The first radio carries the settings, the others take them over and keep their own bus position
+    for (uint8_t i = 1; i < count; i++) {
+        TEA5757_t settings = radios[0];
+        settings.i2c = radios[i].i2c;
+        settings.address = radios[i].address;
+        settings.mux_address = radios[i].mux_address;
+        settings.mux_channel = radios[i].mux_channel;
+        settings.pll_offset = radios[i].pll_offset;
+        radios[i] = settings;
+    }
+
+    // One write per controller, mux and per-tuner PLL correction, all mux channels of the group enabled at once
+    uint32_t written = 0;
+    for (uint8_t i = 0; i < count; i++) {
+        if (written & (1u << i)) {
+            continue;
+        }
+        uint8_t mask = 0;
+        for (uint8_t j = i; j < count; j++) {
+            if (radios[j].i2c == radios[i].i2c && radios[j].mux_address == radios[i].mux_address
+                    && radios[j].address == radios[i].address && radios[j].pll_offset == radios[i].pll_offset
+                    && !(written & (1u << j))) {
+                mask |= 1 << radios[j].mux_channel;
+                written |= 1u << j;
+                if (!radios[i].mux_address) {
+                    break;
+                }
+            }
+        }
+        tea5767_encode_registers(radios[i], registers);
+        // Without the mux path the write would reach whichever tuners were selected before
+        if (!tea5767_mux_select(radios[i].i2c, radios[i].mux_address, mask)
+                || i2c_write_blocking(radios[i].i2c, radios[i].address, registers, TEA5767_REGISTERS, false)
+                != TEA5767_REGISTERS) {
+            ok = false;
+        }
+        if (radios[i].settle_ms > settle_ms) {
+            settle_ms = radios[i].settle_ms;
+        }
+    }
+    if (settle_ms) {
+        sleep_ms(settle_ms);
+    }
+
+    // The status bytes echo the PLL word, which is enough to tell the write reached the tuner
+    for (uint8_t i = 0; verify && i < count; i++) {
+        TEA5767_status_t status;
+        tea5767_encode_registers(radios[i], registers);
+        tea5767_getStatus(radios[i], &status);
+        if (!radios[i].searchMode && status.pll != ((registers[0] & 0x3f) << 8 | registers[1])) {
+            ok = false;
+        }
+    }
+    return ok;
+}
+
+TEA5757_t tea5767_init_i2c(i2c_inst_t *i2c, uint sda_pin, uint scl_pin){
     TEA5757_t radio;
+    radio.i2c = i2c;
     radio.address = 0x60;
     // Default (See datasheet).
     //buf[0] = 0x40;buf[1] = 0x00;buf[2] = 0x90;buf[3] = 0x1E;buf[4] = 0x00;
@@ -87,17 +199,25 @@ TEA5757_t tea5767_init(){
     radio.softMuteMode = false;
     radio.hpfMode = true;
     radio.stereoNoiseCancelling = true;
+    radio.deemphasis = false;
+    radio.settle_ms = TEA5767_SETTLE_MS;
+    radio.pll_offset = 0;
+    radio.mux_address = 0;
+    radio.mux_channel = 0;
+
+    i2c_init(i2c, 400 * 1000);
+    gpio_set_function(sda_pin, GPIO_FUNC_I2C);
+    gpio_set_function(scl_pin, GPIO_FUNC_I2C);
+    gpio_pull_up(sda_pin);
+    gpio_pull_up(scl_pin);
+
+    return radio;
+}
 
-    // TODO: Allow other pins than I2C0 on the default SDA and SCL pins (4, 5 on a Pico)
-    i2c_init(i2c_default, 400 * 1000);
-    gpio_set_function(PICO_DEFAULT_I2C_SDA_PIN, GPIO_FUNC_I2C);
-    gpio_set_function(PICO_DEFAULT_I2C_SCL_PIN, GPIO_FUNC_I2C);
-    gpio_pull_up(PICO_DEFAULT_I2C_SDA_PIN);
-    gpio_pull_up(PICO_DEFAULT_I2C_SCL_PIN);
+TEA5757_t tea5767_init(){
     // Make the I2C pins available to picotool
     bi_decl(bi_2pins_with_func(PICO_DEFAULT_I2C_SDA_PIN, PICO_DEFAULT_I2C_SCL_PIN, GPIO_FUNC_I2C));
-
-    return radio;
+    return tea5767_init_i2c(i2c_default, PICO_DEFAULT_I2C_SDA_PIN, PICO_DEFAULT_I2C_SCL_PIN);
 }
 
 float tea5767_getStation(TEA5757_t *radio) {
@@ -106,13 +226,33 @@ float tea5767_getStation(TEA5757_t *radio) {
     // Read current settings from the TEA5767 module
     tea5767_read_raw(*radio,buf);
 
-    // Calculate the current frequency based on the TEA5767's register values
-    float integer_freq = (buf[0] & 0x3f) << 8 | buf[1];
+    // Calculate the current frequency based on the TEA5767's register values, without the PLL correction
+    TEA5767_PROFILE_ENTER(TEA5767_REGION_DECODE);
+    float integer_freq = ((buf[0] & 0x3f) << 8 | buf[1]) - radio->pll_offset;
     radio->frequency = (integer_freq*32768/4 - 225000) / 1000000;
+    TEA5767_PROFILE_EXIT();
 
     return radio->frequency;
 }
 
+void tea5767_decode_status(const uint8_t *buffer, int16_t pll_offset, TEA5767_status_t *status) {
+    TEA5767_PROFILE_ENTER(TEA5767_REGION_DECODE);
+    status->ready = buffer[0] >> 7;
+    status->bandLimit = (buffer[0] >> 6) & 0x01;
+    status->pll = (buffer[0] & 0x3f) << 8 | buffer[1];
+    status->stereo = buffer[2] >> 7;
+    status->ifCounter = buffer[2] & 0x7f;
+    status->level = buffer[3] >> 4;
+    status->frequency = ((float)(status->pll - pll_offset)*32768/4 - 225000) / 1000000;
+    TEA5767_PROFILE_EXIT();
+}
+
+void tea5767_getStatus(TEA5757_t radio, TEA5767_status_t *status) {
+    uint8_t buf[TEA5767_REGISTERS];
+    tea5767_read_raw(radio, buf);
+    tea5767_decode_status(buf, radio.pll_offset, status);
+}
+
 int tea5767_getReady(TEA5757_t *radio) {
     uint8_t buf[TEA5767_REGISTERS];
     tea5767_read_raw(*radio,buf);
@@ -183,6 +323,26 @@ void tea5767_setMute(TEA5757_t *radio, bool mute) {
     tea5767_write_registers(*radio);
 }
 
+void tea5767_setSoftMute(TEA5757_t *radio, bool mute) {
+    radio->softMuteMode = mute;
+    tea5767_write_registers(*radio);
+}
+
+void tea5767_setAudioProfile(TEA5757_t *radio, uint16_t profile) {
+    radio->softMuteMode = (profile & TEA5767_AUDIO_SOFT_MUTE) != 0;
+    radio->hpfMode = (profile & TEA5767_AUDIO_HIGH_CUT) != 0;
+    radio->stereoNoiseCancelling = (profile & TEA5767_AUDIO_SNC) != 0;
+    radio->deemphasis = (profile & TEA5767_AUDIO_DEEMPHASIS_75US) != 0;
+    tea5767_write_registers(*radio);
+}
+
+uint16_t tea5767_getAudioProfile(TEA5757_t radio) {
+    return (radio.softMuteMode ? TEA5767_AUDIO_SOFT_MUTE : 0)
+            | (radio.hpfMode ? TEA5767_AUDIO_HIGH_CUT : 0)
+            | (radio.stereoNoiseCancelling ? TEA5767_AUDIO_SNC : 0)
+            | (radio.deemphasis ? TEA5767_AUDIO_DEEMPHASIS_75US : 0);
+}
+
 void tea5767_setMuteLeft(TEA5757_t *radio, bool mute) {
     radio->muteLmode = mute;
     tea5767_write_registers(*radio);
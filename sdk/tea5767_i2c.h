@@ -29,6 +29,20 @@
 #define ADC_MID 7 // Constant for the medium level of ADC readings
 #define ADC_HIGH 10 // Constant for the high level of ADC readings
 #define TEA5767_REGISTERS 5 // Number of registers in the TEA5767 chip
+#define TEA5767_AUDIO_SOFT_MUTE 0x0008 // Soft mute, SMUTE bit of the fourth byte
+#define TEA5767_AUDIO_HIGH_CUT 0x0004 // High cut control, HCC bit of the fourth byte
+#define TEA5767_AUDIO_SNC 0x0002 // Stereo noise cancelling, SNC bit of the fourth byte
+#define TEA5767_AUDIO_DEEMPHASIS_75US 0x4000 // 75 us de-emphasis instead of 50 us, DTC bit of the fifth byte
+#define TEA5767_AUDIO_PROFILE_HIFI (TEA5767_AUDIO_SNC) // Strong stations, full audio bandwidth
+#define TEA5767_AUDIO_PROFILE_DEFAULT (TEA5767_AUDIO_HIGH_CUT | TEA5767_AUDIO_SNC) // Settings after init
+#define TEA5767_AUDIO_PROFILE_WEAK (TEA5767_AUDIO_SOFT_MUTE | TEA5767_AUDIO_HIGH_CUT | TEA5767_AUDIO_SNC) // Noisy stations
+#define TEA5767_AUDIO_PROFILE_US (TEA5767_AUDIO_PROFILE_DEFAULT | TEA5767_AUDIO_DEEMPHASIS_75US) // Americas de-emphasis
+#define TEA5767_SETTLE_MS 100 // Default wait after a write, before calibration
+#define TEA5767_IF_MIN 0x31 // Lowest IF counter value of a correctly tuned station
+#define TEA5767_IF_MAX 0x3E // Highest IF counter value of a correctly tuned station
+#define TEA5767_MUX_CHANNELS 8 // Channels of a TCA9548A I2C multiplexer
+#define TEA5767_BROADCAST_MAX 32 // Tuners per tea5767_write_broadcast() call
+#define TEA5767_IF_CENTER 0x37 // IF counter value of an exactly tuned station, 225 kHz
 
 /************************************
  * TYPEDEFS
@@ -36,6 +50,7 @@
 /*! @brief The TEA5757 radio module configuration structure
 */
 typedef struct {
+i2c_inst_t *i2c;                //< I2C controller the tuner is on
 uint8_t address;                //< I2C device address
 uint8_t mute_mode;              //< Audio mute mode
 uint8_t band_mode;              //< Frequency band mode
@@ -49,12 +64,29 @@ uint8_t muteRmode;              // Right channel mute mode
 uint8_t stereoNoiseCancelling;  // Stereo noise cancelling mode
 uint8_t softMuteMode;           // Soft mute mode
 uint8_t hpfMode;                // High pass filter mode
+uint8_t deemphasis;             // De-emphasis time constant, 1 for 75 us, 0 for 50 us
 uint8_t isReady;                // Radio is ready flag
 uint8_t isStereo;               // Stereo mode flag
 uint8_t stationLevel;           // Station level
+uint16_t settle_ms;             // Wait after each write, see tea5767_calibrate()
+int16_t pll_offset;             // Correction added to the PLL word, see tea5767_afc()
+uint8_t mux_address;            // Address of the TCA9548A the tuner is behind, 0 if none
+uint8_t mux_channel;            // Multiplexer channel of the tuner
 float frequency;                // Frequency in MHz
 } TEA5757_t;
 
+/*! @brief Decoded content of the five bytes read from the TEA5767
+*/
+typedef struct {
+uint8_t ready;                  // Ready flag, station found or band limit reached
+uint8_t bandLimit;              // Band limit flag
+uint16_t pll;                   // PLL word as read, pll_offset included
+uint8_t stereo;                 // Stereo reception
+uint8_t ifCounter;              // IF counter result
+uint8_t level;                  // ADC level output, 0 to 15
+float frequency;                // Nominal frequency in MHz, PLL word without the pll_offset of the radio
+} TEA5767_status_t;
+
 /************************************
  * EXPORTED VARIABLES
  ************************************/
@@ -69,6 +101,7 @@ float frequency;                // Frequency in MHz
  *  \ingroup tea5767_i2c
  *
  * Reads five bytes from the TEA5767_t variable and fills the buffer variable.
+ * If the tuner's mux does not acknowledge, the buffer is zeroed, which decodes as not ready.
  *
  * \param radio From type TEA5767_t.
  * \param buffer \ref TEA5767_REGISTERS amount to this variable.
@@ -81,11 +114,30 @@ void tea5767_read_raw(TEA5757_t radio,uint8_t *buffer);
  *
  * Writtes five bytes to the TEA5767_t variable and fills the buffer variable.
  * The data from the radio variable is modified to fit the memory map of TEA5767.
+ * Nothing is written if the tuner's mux does not acknowledge.
  *
  * \param radio Variable of type TEA5767_t.
  */
 void tea5767_write_registers(TEA5757_t radio);
 
+/*! @brief Builds the five bytes written to the TEA5767 from the radio settings.
+* @param radio Variable of type TEA5767_t.
+* @param registers \ref TEA5767_REGISTERS bytes, filled.
+*/
+void tea5767_encode_registers(TEA5757_t radio, uint8_t *registers);
+
+/*! @brief Applies the settings of radios[0] to several tuners with as few writes as possible.
+* The settings of the first radio are copied into the others, which keep their bus position and PLL correction.
+* Tuners behind the same TCA9548A that end up with the same register image get a single write with all
+* their mux channels enabled at once, then the longest settle time is waited once.
+* @param radios Tuners, the first one carrying the settings.
+* @param count Number of tuners, up to \ref TEA5767_BROADCAST_MAX.
+* @param verify Read every tuner back and check its PLL word, one extra read per tuner.
+* @return bool false if a mux select or a write was not acknowledged, or a readback did not match. The tuners
+* behind a mux that did not acknowledge are not written.
+*/
+bool tea5767_write_broadcast(TEA5757_t *radios, uint8_t count, bool verify);
+
 /*! \brief   Initialize an struct with the parameters needed for initialization.
  *  \ingroup tea5767_i2c
  *
@@ -95,6 +147,15 @@ void tea5767_write_registers(TEA5757_t radio);
  */
 TEA5757_t tea5767_init();
 
+/*! @brief Same as tea5767_init() for a tuner on any I2C controller and pins.
+* Each RP2040 controller can host one tuner, since the TEA5767 address is fixed.
+* @param i2c I2C controller, i2c0 or i2c1.
+* @param sda_pin GPIO used as SDA.
+* @param scl_pin GPIO used as SCL.
+* @return TEA5757_t The TEA5757_t structure initialized with default values.
+*/
+TEA5757_t tea5767_init_i2c(i2c_inst_t *i2c, uint sda_pin, uint scl_pin);
+
 /*! @brief Gets the current station frequency from the TEA5757 radio and prints it to stdout.
 * This function reads the raw data from the TEA5757 radio using the tea5767_read_raw() function,
 * extracts the frequency values from the read buffer, and calculates the frequency in MHz.
@@ -105,6 +166,19 @@ TEA5757_t tea5767_init();
 */
 float tea5767_getStation(TEA5757_t *radio);
 
+/*! @brief Decodes a buffer filled by tea5767_read_raw().
+* @param buffer \ref TEA5767_REGISTERS bytes read from the tuner.
+* @param pll_offset pll_offset of the radio the buffer was read from, removed from the frequency.
+* @param status Filled with the decoded fields.
+*/
+void tea5767_decode_status(const uint8_t *buffer, int16_t pll_offset, TEA5767_status_t *status);
+
+/*! @brief Reads and decodes the status of the TEA5757 tuner in one transaction.
+* @param radio The TEA5757_t structure representing the radio device.
+* @param status Filled with the decoded fields.
+*/
+void tea5767_getStatus(TEA5757_t radio, TEA5767_status_t *status);
+
 /*! @brief Initializes the TEA5757_t structure for the TEA5757 tuner.
 * This function initializes the TEA5757_t structure with the default values for the TEA5757 tuner.
 * The default I2C address of the tuner is 0x60.
@@ -181,6 +255,19 @@ void tea5767_setMute(TEA5757_t *radio, bool mute);
 */
 void tea5767_setSoftMute(TEA5757_t *radio, bool mute);
 
+/*! @brief Sets soft mute, high cut control, stereo noise cancelling and de-emphasis in one register write.
+* @param radio A pointer to a TEA5757_t struct representing the TEA5767 radio.
+* @param profile OR of TEA5767_AUDIO_* bits, or one of the TEA5767_AUDIO_PROFILE_* presets.
+* @note Switching profile costs exactly one bus transaction, whatever the number of settings changed.
+*/
+void tea5767_setAudioProfile(TEA5757_t *radio, uint16_t profile);
+
+/*! @brief Returns the current audio settings as TEA5767_AUDIO_* bits.
+* @param radio The TEA5757_t structure representing the radio device.
+* @return uint16_t Profile that tea5767_setAudioProfile() would restore.
+*/
+uint16_t tea5767_getAudioProfile(TEA5757_t radio);
+
 /*! @brief Sets the left channel mute mode for the TEA5767 radio.
 * @param radio Pointer to the TEA5757_t struct representing the radio.
 * @param mute Boolean value indicating whether the left channel should be muted.
@@ -0,0 +1,170 @@
+/**
+ ********************************************************************************
+ * @file    tea5767_nmea.c
+ * @author  Carlos Egea
+ * @date    18/10/2026
+ * @brief   Incremental, allocation free NMEA parser for drive-test position tagging.
+ ********************************************************************************
+ */
+
+/************************************
+ * INCLUDES
+ ************************************/
+#include <string.h>
+#include "tea5767_nmea.h"
+
+/************************************
+ * PRIVATE MACROS AND DEFINES
+ ************************************/
+#define NMEA_FIELDS 16 // Fields looked at in a sentence
+
+/************************************
+ * STATIC FUNCTIONS
+ ************************************/
+static int hex_digit(char c) {
+    if (c >= '0' && c <= '9') {
+        return c - '0';
+    }
+    if (c >= 'A' && c <= 'F') {
+        return c - 'A' + 10;
+    }
+    return -1;
+}
+
+// Parses digits with an optional decimal part, scaled by 10^decimals. Stops at the first other character.
+static int64_t parse_fixed(const char *s, uint8_t decimals) {
+    int64_t value = 0;
+    uint8_t seen = 0;
+    bool fraction = false;
+
+    for (; *s; s++) {
+        if (*s == '.') {
+            fraction = true;
+        } else if (*s >= '0' && *s <= '9') {
+            if (fraction && seen == decimals) {
+                continue;
+            }
+            value = value * 10 + (*s - '0');
+            seen += fraction;
+        } else {
+            break;
+        }
+    }
+    for (; seen < decimals; seen++) {
+        value *= 10;
+    }
+    return value;
+}
+
+// ddmm.mmmmm or dddmm.mmmmm to degrees * 1e7
+static bool parse_coordinate(const char *s, const char *hemisphere, int32_t *out) {
+    const char *dot = strchr(s, '.');
+    size_t int_len = dot ? (size_t)(dot - s) : strlen(s);
+    if (int_len < 3 || (*hemisphere != 'N' && *hemisphere != 'S' && *hemisphere != 'E' && *hemisphere != 'W')) {
+        return false;
+    }
+
+    int64_t degrees = parse_fixed(s, 0) / 100;
+    int64_t minutes_e5 = parse_fixed(s + int_len - 2, 5);
+    int64_t value = degrees * 10000000 + minutes_e5 * 100 / 60;
+    *out = (*hemisphere == 'S' || *hemisphere == 'W') ? -value : value;
+    return true;
+}
+
+static uint32_t parse_time(const char *s) {
+    int64_t hhmmss_e3 = parse_fixed(s, 3);
+    uint32_t ms = hhmmss_e3 % 100000;
+    uint32_t minutes = (hhmmss_e3 / 100000) % 100;
+    uint32_t hours = hhmmss_e3 / 10000000;
+    return (hours * 3600 + minutes * 60) * 1000 + ms;
+}
+
+static bool tea5767_nmea_parse(TEA5767_nmea_t *nmea) {
+    char *field[NMEA_FIELDS];
+    uint8_t fields = 0;
+    uint8_t checksum = 0;
+    char *p;
+
+    // Checksum over everything between '$' and '*'
+    for (p = nmea->buf + 1; *p && *p != '*'; p++) {
+        checksum ^= *p;
+    }
+    if (*p != '*' || hex_digit(p[1]) < 0 || hex_digit(p[2]) < 0
+            || checksum != (hex_digit(p[1]) << 4 | hex_digit(p[2]))) {
+        nmea->errors++;
+        return false;
+    }
+    *p = '\0';
+
+    // Split in place
+    field[fields++] = nmea->buf + 1;
+    for (p = nmea->buf + 1; *p && fields < NMEA_FIELDS; p++) {
+        if (*p == ',') {
+            *p = '\0';
+            field[fields++] = p + 1;
+        }
+    }
+    if (strlen(field[0]) != 5) {
+        return false;
+    }
+
+    TEA5767_position_t position = nmea->position;
+    const char *type = field[0] + 2;
+    if (strcmp(type, "RMC") == 0 && fields >= 7) {
+        // time, status, lat, N/S, lon, E/W
+        if (field[2][0] != 'A') {
+            position.fix = 0;
+        } else if (parse_coordinate(field[3], field[4], &position.lat_e7)
+                && parse_coordinate(field[5], field[6], &position.lon_e7)) {
+            position.fix = position.fix ? position.fix : 1;
+        } else {
+            return false;
+        }
+        position.time_ms = parse_time(field[1]);
+    } else if (strcmp(type, "GGA") == 0 && fields >= 8) {
+        // time, lat, N/S, lon, E/W, fix quality, satellites
+        position.fix = parse_fixed(field[6], 0);
+        position.satellites = parse_fixed(field[7], 0);
+        if (position.fix && !(parse_coordinate(field[2], field[3], &position.lat_e7)
+                && parse_coordinate(field[4], field[5], &position.lon_e7))) {
+            return false;
+        }
+        position.time_ms = parse_time(field[1]);
+    } else {
+        return false;
+    }
+
+    nmea->position = position;
+    nmea->sentences++;
+    return true;
+}
+
+/************************************
+ * GLOBAL FUNCTIONS
+ ************************************/
+void tea5767_nmea_init(TEA5767_nmea_t *nmea) {
+    memset(nmea, 0, sizeof(*nmea));
+}
+
+bool tea5767_nmea_feed(TEA5767_nmea_t *nmea, char c) {
+    if (c == '$') {
+        nmea->len = 0;
+    } else if (nmea->len == 0) {
+        // Waiting for the start of a sentence
+        return false;
+    }
+
+    if (c == '\r' || c == '\n') {
+        nmea->buf[nmea->len] = '\0';
+        nmea->len = 0;
+        return tea5767_nmea_parse(nmea);
+    }
+
+    if (nmea->len >= TEA5767_NMEA_MAX) {
+        nmea->errors++;
+        nmea->len = 0;
+        return false;
+    }
+    nmea->buf[nmea->len++] = c;
+    return false;
+}
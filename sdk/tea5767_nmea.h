@@ -0,0 +1,65 @@
+/**
+ ********************************************************************************
+ * @file    tea5767_nmea.h
+ * @author  Carlos Egea
+ * @date    18/10/2026
+ * @brief   Incremental, allocation free NMEA parser for drive-test position tagging.
+ ********************************************************************************
+ */
+
+#ifndef _HARDWARE_TEA5767_NMEA_H
+#define _HARDWARE_TEA5767_NMEA_H
+
+/************************************
+ * INCLUDES
+ ************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+/************************************
+ * MACROS AND DEFINES
+ ************************************/
+#define TEA5767_NMEA_MAX 82 // Longest NMEA 0183 sentence, '$' to end of line
+
+/************************************
+ * TYPEDEFS
+ ************************************/
+/*! @brief Last position reported by the GPS
+*/
+typedef struct {
+int32_t lat_e7;                 // Latitude in degrees * 1e7, north positive
+int32_t lon_e7;                 // Longitude in degrees * 1e7, east positive
+uint32_t time_ms;               // UTC time of day in milliseconds
+uint8_t fix;                    // 0 without a fix
+uint8_t satellites;             // Satellites used, from GGA
+} TEA5767_position_t;
+
+/*! @brief Parser state. Characters are fed one at a time, from a UART IRQ for instance.
+*/
+typedef struct {
+char buf[TEA5767_NMEA_MAX + 1]; // Sentence being received
+uint8_t len;                    // Characters in buf
+TEA5767_position_t position;    // Last position
+uint32_t sentences;             // Sentences used
+uint32_t errors;                // Sentences dropped on checksum or length
+} TEA5767_nmea_t;
+
+/************************************
+ * GLOBAL FUNCTION PROTOTYPES
+ ************************************/
+
+/*! @brief Initializes a parser with no position.
+* @param nmea Parser to initialize.
+*/
+void tea5767_nmea_init(TEA5767_nmea_t *nmea);
+
+/*! @brief Feeds one received character.
+* Constant work per character; a complete sentence is parsed in place when its end of line arrives.
+* RMC and GGA sentences from any talker are used, the rest are ignored.
+* @param nmea Parser.
+* @param c Received character.
+* @return bool true if the character completed a sentence that updated the position.
+*/
+bool tea5767_nmea_feed(TEA5767_nmea_t *nmea, char c);
+
+#endif
@@ -0,0 +1,250 @@
+/**
+ ********************************************************************************
+ * @file    tea5767_pipeline.c
+ * @author  Carlos Egea
+ * @date    18/10/2026
+ * @brief   Streaming audio path: ADC capture of a TEA5767, AGC and high-pass, PWM output.
+ ********************************************************************************
+ */
+
+/************************************
+ * INCLUDES
+ ************************************/
+#include "pico/time.h"
+#include "hardware/clocks.h"
+#include "hardware/dma.h"
+#include "hardware/gpio.h"
+#include "hardware/irq.h"
+#include "hardware/pwm.h"
+#include "tea5767_pipeline.h"
+
+/************************************
+ * PRIVATE MACROS AND DEFINES
+ ************************************/
+#if TEA5767_CAPTURE_BLOCK % TEA5767_GATE_HOP
+#error "TEA5767_CAPTURE_BLOCK must be a multiple of TEA5767_GATE_HOP, the gate only takes whole hops"
+#endif
+
+/************************************
+ * STATIC VARIABLES
+ ************************************/
+static TEA5767_pipeline_t *active;
+
+/************************************
+ * STATIC FUNCTIONS
+ ************************************/
+// Buffer i is over and the chain already started the other one
+static void pipeline_irq(void) {
+    for (uint8_t i = 0; i < 2; i++) {
+        if (!dma_channel_get_irq1_status(active->dma[i])) {
+            continue;
+        }
+        dma_channel_acknowledge_irq1(active->dma[i]);
+        dma_channel_set_read_addr(active->dma[i], active->out[i], false);
+        active->writable[i] = true;
+
+        uint8_t playing = !i;
+        active->writable[playing] = false;
+        if (active->fresh[playing]) {
+            active->fresh[playing] = false;
+            active->latency_us = time_us_64() - active->picked_us[playing] + active->block_us;
+            if (active->latency_us > active->latency_max_us) {
+                active->latency_max_us = active->latency_us;
+            }
+        } else {
+            active->underruns++;
+        }
+    }
+}
+
+static void pipeline_silence(TEA5767_pipeline_t *pipeline, uint8_t buffer) {
+    uint32_t mid = (pipeline->wrap + 1) / 2;
+    for (uint16_t i = 0; i < TEA5767_CAPTURE_BLOCK; i++) {
+        pipeline->out[buffer][i] = mid | mid << 16;
+    }
+}
+
+/************************************
+ * GLOBAL FUNCTIONS
+ ************************************/
+bool tea5767_pipeline_init(TEA5767_pipeline_t *pipeline, uint8_t inputs, uint32_t rate, uint8_t pin, float cutoff) {
+    // Checked before the capture claims its DMA channels, there is nothing to release on the way out
+    uint8_t channels = 0;
+    for (uint8_t input = 0; input < TEA5767_CAPTURE_INPUTS; input++) {
+        channels += (inputs >> input) & 1;
+    }
+    if (channels == 0 || channels > 2 || !tea5767_capture_init(&pipeline->capture, inputs, rate)) {
+        return false;
+    }
+    rate = pipeline->capture.rate;
+    pipeline->block_us = (uint64_t)TEA5767_CAPTURE_BLOCK * 1000000 / rate;
+    pipeline->highpass = cutoff > 0;
+    for (uint8_t c = 0; c < 2; c++) {
+        tea5767_audio_hpfInit(&pipeline->hpf[c], cutoff, rate);
+        tea5767_audio_gateInit(&pipeline->gate[c], TEA5767_PIPELINE_GATE_MIN_GAIN, TEA5767_PIPELINE_GATE_OVER);
+        tea5767_audio_agcInit(&pipeline->agc[c], TEA5767_PIPELINE_AGC_TARGET, TEA5767_PIPELINE_AGC_MAX_GAIN,
+                              TEA5767_PIPELINE_AGC_ATTACK_MS, TEA5767_PIPELINE_AGC_RELEASE_MS, rate);
+    }
+    pipeline->latency_us = pipeline->latency_max_us = 0;
+    pipeline->process_us = pipeline->process_max_us = 0;
+    pipeline->load = 0;
+    pipeline->dropped = pipeline->underruns = 0;
+
+    // One PWM period per sample. The output rate is 16 * clk_sys / (clkdiv * (wrap + 1)) and the input rate
+    // ADC_HZ / (period * channels): they are equal when clkdiv * (wrap + 1) * ADC_HZ is ticks below.
+    // The smallest divider that does it keeps the most resolution.
+    uint64_t ticks = 16ull * clock_get_hz(clk_sys) * pipeline->capture.period * pipeline->capture.channels;
+    uint64_t unit = (uint64_t)TEA5767_CAPTURE_ADC_HZ * (UINT16_MAX + 1);
+    uint32_t first = (ticks + unit - 1) / unit;
+    if (first < 16) {
+        first = 16;
+    }
+    uint32_t clkdiv = first;
+    uint32_t top = (ticks + (uint64_t)first * TEA5767_CAPTURE_ADC_HZ / 2) / ((uint64_t)first * TEA5767_CAPTURE_ADC_HZ);
+    for (uint32_t div = first; div <= 0xfff; div++) {
+        uint64_t step = (uint64_t)div * TEA5767_CAPTURE_ADC_HZ;
+        if (ticks / step <= TEA5767_PIPELINE_WRAP_MIN) {
+            break;
+        }
+        if (ticks % step == 0) {
+            clkdiv = div;
+            top = ticks / step;
+            break;
+        }
+    }
+    // Without an exact pair the smallest divider is kept and the difference slipped
+    double ratio = (double)ticks / ((double)clkdiv * top * TEA5767_CAPTURE_ADC_HZ);
+    pipeline->clkdiv = clkdiv;
+    pipeline->wrap = top - 1;
+    pipeline->slip = (int32_t)((ratio - 1) * TEA5767_CAPTURE_BLOCK * (1 << 24));
+    pipeline->phase = 0;
+    pipeline->slips = 0;
+    pipeline->slice = pwm_gpio_to_slice_num(pin);
+    gpio_set_function(pin, GPIO_FUNC_PWM);
+    gpio_set_function(pin + 1, GPIO_FUNC_PWM);
+    pwm_config config = pwm_get_default_config();
+    pwm_config_set_clkdiv_int_frac(&config, pipeline->clkdiv >> 4, pipeline->clkdiv & 0xf);
+    pwm_config_set_wrap(&config, pipeline->wrap);
+    pwm_init(pipeline->slice, &config, false);
+
+    pipeline->dma[0] = dma_claim_unused_channel(false);
+    pipeline->dma[1] = dma_claim_unused_channel(false);
+    if (pipeline->dma[0] < 0 || pipeline->dma[1] < 0) {
+        if (pipeline->dma[0] >= 0) {
+            dma_channel_unclaim(pipeline->dma[0]);
+        }
+        tea5767_capture_stop(&pipeline->capture);
+        return false;
+    }
+    for (uint8_t i = 0; i < 2; i++) {
+        dma_channel_config dma = dma_channel_get_default_config(pipeline->dma[i]);
+        channel_config_set_transfer_data_size(&dma, DMA_SIZE_32);
+        channel_config_set_read_increment(&dma, true);
+        channel_config_set_write_increment(&dma, false);
+        channel_config_set_dreq(&dma, DREQ_PWM_WRAP0 + pipeline->slice);
+        channel_config_set_chain_to(&dma, pipeline->dma[!i]);
+        dma_channel_configure(pipeline->dma[i], &dma, &pwm_hw->slice[pipeline->slice].cc, pipeline->out[i],
+                              TEA5767_CAPTURE_BLOCK, false);
+        dma_channel_set_irq1_enabled(pipeline->dma[i], true);
+    }
+    return true;
+}
+
+void tea5767_pipeline_start(TEA5767_pipeline_t *pipeline) {
+    pipeline_silence(pipeline, 0);
+    pipeline_silence(pipeline, 1);
+    // Buffer 0 plays first, buffer 1 is queued and can still take the first block
+    pipeline->writable[0] = false;
+    pipeline->writable[1] = true;
+    pipeline->fresh[0] = pipeline->fresh[1] = false;
+    pipeline->phase = 0;
+    dma_channel_set_trans_count(pipeline->dma[0], TEA5767_CAPTURE_BLOCK, false);
+    dma_channel_set_trans_count(pipeline->dma[1], TEA5767_CAPTURE_BLOCK, false);
+
+    active = pipeline;
+    irq_add_shared_handler(DMA_IRQ_1, pipeline_irq, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+    irq_set_enabled(DMA_IRQ_1, true);
+    dma_channel_start(pipeline->dma[0]);
+    pwm_set_enabled(pipeline->slice, true);
+    tea5767_capture_start(&pipeline->capture);
+}
+
+void tea5767_pipeline_stop(TEA5767_pipeline_t *pipeline) {
+    tea5767_capture_stop(&pipeline->capture);
+    for (uint8_t i = 0; i < 2; i++) {
+        dma_channel_set_irq1_enabled(pipeline->dma[i], false);
+    }
+    tea5767_capture_abortChain(pipeline->dma);
+    for (uint8_t i = 0; i < 2; i++) {
+        dma_channel_unclaim(pipeline->dma[i]);
+    }
+    irq_remove_handler(DMA_IRQ_1, pipeline_irq);
+    pwm_set_enabled(pipeline->slice, false);
+    active = 0;
+}
+
+void tea5767_pipeline_setLevel(TEA5767_pipeline_t *pipeline, uint8_t level) {
+    tea5767_audio_gateLevel(&pipeline->gate[0], level);
+    tea5767_audio_gateLevel(&pipeline->gate[1], level);
+}
+
+bool tea5767_pipeline_process(TEA5767_pipeline_t *pipeline) {
+    const uint16_t *block = tea5767_capture_block(&pipeline->capture);
+    uint8_t channels = pipeline->capture.channels;
+
+    if (!block) {
+        return false;
+    }
+    uint64_t start = time_us_64();
+    uint8_t buffer = pipeline->writable[0] ? 0 : 1;
+    if (!pipeline->writable[buffer]) {
+        pipeline->dropped++;
+        return false;
+    }
+
+    for (uint8_t c = 0; c < channels; c++) {
+        tea5767_audio_toPcm(block + c, TEA5767_CAPTURE_BLOCK, channels, pipeline->pcm + c, 2);
+        if (pipeline->highpass) {
+            tea5767_audio_hpf(&pipeline->hpf[c], pipeline->pcm + c, TEA5767_CAPTURE_BLOCK, 2);
+        }
+        tea5767_audio_gate(&pipeline->gate[c], pipeline->pcm + c, TEA5767_CAPTURE_BLOCK, 2);
+        tea5767_audio_agc(&pipeline->agc[c], pipeline->pcm + c, TEA5767_CAPTURE_BLOCK, 2);
+    }
+
+    // The output clock is faster or slower than the capture one by slip samples per block
+    uint16_t length = TEA5767_CAPTURE_BLOCK;
+    pipeline->phase += pipeline->slip;
+    if (pipeline->phase >= 1 << 24) {
+        pipeline->phase -= 1 << 24;
+        length++;
+        pipeline->slips++;
+    } else if (pipeline->phase <= -(1 << 24)) {
+        pipeline->phase += 1 << 24;
+        length--;
+        pipeline->slips++;
+    }
+
+    // PCM to PWM compare levels, left in the low half for channel A, mono played on both.
+    // A longer buffer plays its last sample twice.
+    uint32_t scale = pipeline->wrap + 1;
+    uint8_t right = channels > 1;
+    for (uint16_t i = 0; i < length; i++) {
+        uint16_t j = i < TEA5767_CAPTURE_BLOCK ? i : TEA5767_CAPTURE_BLOCK - 1;
+        uint32_t left = ((uint32_t)(pipeline->pcm[2 * j] + 32768) * scale) >> 16;
+        uint32_t other = ((uint32_t)(pipeline->pcm[2 * j + right] + 32768) * scale) >> 16;
+        pipeline->out[buffer][i] = left | other << 16;
+    }
+    // The channel is idle until chained, the count is reloaded from here when it starts
+    dma_channel_set_trans_count(pipeline->dma[buffer], length, false);
+
+    pipeline->writable[buffer] = false;
+    pipeline->picked_us[buffer] = start;
+    pipeline->fresh[buffer] = true;
+
+    pipeline->process_us = time_us_64() - start;
+    if (pipeline->process_us > pipeline->process_max_us) {
+        pipeline->process_max_us = pipeline->process_us;
+    }
+    pipeline->load = (uint32_t)pipeline->process_us * 1000 / pipeline->block_us;
+    return true;
+}
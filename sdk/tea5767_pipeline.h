@@ -0,0 +1,114 @@
+/**
+ ********************************************************************************
+ * @file    tea5767_pipeline.h
+ * @author  Carlos Egea
+ * @date    18/10/2026
+ * @brief   Streaming audio path: ADC capture of a TEA5767, AGC and high-pass, PWM output.
+ ********************************************************************************
+ */
+
+#ifndef _HARDWARE_TEA5767_PIPELINE_H
+#define _HARDWARE_TEA5767_PIPELINE_H
+
+/************************************
+ * INCLUDES
+ ************************************/
+#include "tea5767_audio.h"
+#include "tea5767_capture.h"
+
+/************************************
+ * MACROS AND DEFINES
+ ************************************/
+#define TEA5767_PIPELINE_AGC_TARGET 16384 // Peak level aimed at, half of full scale
+#define TEA5767_PIPELINE_AGC_MAX_GAIN 16.0f // Highest AGC gain, linear
+#define TEA5767_PIPELINE_AGC_ATTACK_MS 5.0f // AGC envelope rise time constant
+#define TEA5767_PIPELINE_AGC_RELEASE_MS 300.0f // AGC envelope decay time constant
+#define TEA5767_PIPELINE_GATE_MIN_GAIN 0.1f // Noise gate depth, -20 dB
+#define TEA5767_PIPELINE_GATE_OVER 4 // Noise floor multiple subtracted by the gate
+#define TEA5767_PIPELINE_WRAP_MIN 1023 // Least PWM counter top accepted to lock the output rate exactly, 10 bits
+
+/*
+ * Both ends are double buffered by DMA. A capture block is processed into the output
+ * buffer that is not playing, and starts playing once the other one is over, so the
+ * latency is at most two block periods plus the processing time, and the noise gate
+ * adds \ref TEA5767_GATE_HOP samples. The CPU only runs tea5767_pipeline_process(),
+ * from the main loop.
+ * The ADC runs off the 48 MHz USB clock and the PWM off clk_sys. The PWM fractional divider
+ * and counter top are picked to give exactly the capture rate when some pair does, otherwise
+ * an output buffer is now and then played one sample longer or shorter to stay in step.
+ */
+
+/************************************
+ * TYPEDEFS
+ ************************************/
+/*! @brief Audio pipeline
+*/
+typedef struct {
+TEA5767_capture_t capture;      // ADC side, one input (mono) or two (left then right)
+TEA5767_hpf_t hpf[2];           // High-pass per channel
+TEA5767_gate_t gate[2];         // Noise gate per channel, engaged by tea5767_pipeline_setLevel()
+TEA5767_agc_t agc[2];           // AGC per channel, reconfigurable with tea5767_audio_agcInit()
+bool highpass;                  // High-pass stage enabled
+uint8_t slice;                  // PWM slice, left on channel A and right on channel B
+uint16_t wrap;                  // PWM counter top, one PWM period per output sample
+uint16_t clkdiv;                // PWM clock divider, 4 fractional bits
+int32_t slip;                   // Output samples to add per block to match the capture rate, Q24
+int32_t phase;                  // Accumulated slip, Q24
+uint32_t slips;                 // Output samples repeated or skipped so far
+int dma[2];                     // DMA channel playing each output buffer
+volatile bool writable[2];      // Output buffer not playing nor queued with fresh audio
+volatile bool fresh[2];         // Output buffer filled since it last played
+uint64_t picked_us[2];          // Time the audio of each output buffer was taken from the capture
+uint32_t block_us;              // Duration of a block
+uint32_t latency_us;            // Last capture to output latency, block fill time included
+uint32_t latency_max_us;        // Highest latency seen
+uint32_t process_us;            // Last processing time of a block
+uint32_t process_max_us;        // Highest processing time seen
+uint16_t load;                  // Last processing time over block time, per mille
+uint32_t dropped;               // Capture blocks thrown away, no output buffer free
+uint32_t underruns;             // Output buffers played again because no new audio was ready
+int16_t pcm[TEA5767_CAPTURE_BLOCK * 2];
+uint32_t out[2][TEA5767_CAPTURE_BLOCK + 1];
+} TEA5767_pipeline_t;
+
+/************************************
+ * GLOBAL FUNCTION PROTOTYPES
+ ************************************/
+
+/*! @brief Sets up capture, DSP stages and PWM output. Does not start them.
+* Only one pipeline can exist, it owns the ADC.
+* @param pipeline Pipeline to initialize.
+* @param inputs ADC inputs, one for mono or two for left and right, bit n for input n.
+* @param rate Sample rate in Hz, at most 250 kHz in stereo.
+* @param pin Left output GPIO, even. Right is on pin + 1, both on the same PWM slice.
+* @param cutoff High-pass cutoff in Hz, 0 to leave the stage out.
+* @return bool false if the inputs are not one or two, or no DMA channel is free.
+*/
+bool tea5767_pipeline_init(TEA5767_pipeline_t *pipeline, uint8_t inputs, uint32_t rate, uint8_t pin, float cutoff);
+
+/*! @brief Starts the output on silence, then the capture.
+* @param pipeline Pipeline.
+*/
+void tea5767_pipeline_start(TEA5767_pipeline_t *pipeline);
+
+/*! @brief Stops capture and output and releases the DMA channels.
+* @param pipeline Pipeline.
+*/
+void tea5767_pipeline_stop(TEA5767_pipeline_t *pipeline);
+
+/*! @brief Engages the noise gate on weak stations. Call with every status read from the tuner.
+* The gate costs one 64 point FFT and its inverse per 32 samples and channel while engaged, keep the
+* sample rate around 16 kHz for it to fit in real time.
+* @param pipeline Pipeline.
+* @param level Tuner ADC level, 0 to 15.
+*/
+void tea5767_pipeline_setLevel(TEA5767_pipeline_t *pipeline, uint8_t level);
+
+/*! @brief Moves a complete capture block through the DSP stages into the free output buffer.
+* Call at least once per block period.
+* @param pipeline Pipeline.
+* @return bool true if a block was processed.
+*/
+bool tea5767_pipeline_process(TEA5767_pipeline_t *pipeline);
+
+#endif
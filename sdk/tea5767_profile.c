@@ -0,0 +1,74 @@
+/**
+ ********************************************************************************
+ * @file    tea5767_profile.c
+ * @author  Carlos Egea
+ * @date    18/10/2026
+ * @brief   Timer based sampling profiler for the TEA5767 driver hot paths.
+ ********************************************************************************
+ */
+
+/************************************
+ * INCLUDES
+ ************************************/
+#include <stdio.h>
+#include "pico/time.h"
+#include "tea5767_profile.h"
+
+/************************************
+ * STATIC VARIABLES
+ ************************************/
+static volatile uint32_t histogram[TEA5767_PROFILE_REGIONS];
+static repeating_timer_t timer;
+static bool running;
+
+/************************************
+ * GLOBAL VARIABLES
+ ************************************/
+volatile uint8_t tea5767_profile_region = TEA5767_REGION_IDLE;
+
+/************************************
+ * STATIC FUNCTIONS
+ ************************************/
+static bool tea5767_profile_sample(repeating_timer_t *rt) {
+    uint8_t region = tea5767_profile_region;
+    if (region < TEA5767_PROFILE_REGIONS) {
+        histogram[region]++;
+    }
+    return true;
+}
+
+/************************************
+ * GLOBAL FUNCTIONS
+ ************************************/
+bool tea5767_profile_start(uint32_t period_us) {
+    if (running) {
+        tea5767_profile_stop();
+    }
+    if (period_us < TEA5767_PROFILE_MIN_PERIOD_US) {
+        period_us = TEA5767_PROFILE_MIN_PERIOD_US;
+    }
+    // Negative delay: period measured from start to start, not from the end of the callback
+    running = add_repeating_timer_us(-(int64_t)period_us, tea5767_profile_sample, NULL, &timer);
+    return running;
+}
+
+void tea5767_profile_stop() {
+    if (running) {
+        cancel_repeating_timer(&timer);
+        running = false;
+    }
+}
+
+void tea5767_profile_reset() {
+    for (int i = 0; i < TEA5767_PROFILE_REGIONS; i++) {
+        histogram[i] = 0;
+    }
+}
+
+void tea5767_profile_dump() {
+    for (int i = 0; i < TEA5767_PROFILE_REGIONS; i++) {
+        if (histogram[i]) {
+            printf("profile,%d,%lu\n", i, (unsigned long)histogram[i]);
+        }
+    }
+}
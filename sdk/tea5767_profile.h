@@ -0,0 +1,91 @@
+/**
+ ********************************************************************************
+ * @file    tea5767_profile.h
+ * @author  Carlos Egea
+ * @date    18/10/2026
+ * @brief   Timer based sampling profiler for the TEA5767 driver hot paths.
+ ********************************************************************************
+ */
+
+#ifndef _HARDWARE_TEA5767_PROFILE_H
+#define _HARDWARE_TEA5767_PROFILE_H
+
+/************************************
+ * INCLUDES
+ ************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+/************************************
+ * MACROS AND DEFINES
+ ************************************/
+#define TEA5767_PROFILE_REGIONS 16 // Size of the region histogram
+#define TEA5767_PROFILE_MIN_PERIOD_US 50 // Fastest sample period accepted, bounds the IRQ load
+
+/*! @brief Region tags known by the driver. Values from TEA5767_REGION_APP up to
+* TEA5767_PROFILE_REGIONS - 1 are free for the application.
+*/
+#define TEA5767_REGION_IDLE 0 // Outside any tagged region
+#define TEA5767_REGION_ENCODE 1 // Building the register image
+#define TEA5767_REGION_BUS_WRITE 2 // I2C write transaction
+#define TEA5767_REGION_BUS_READ 3 // I2C read transaction
+#define TEA5767_REGION_SETTLE 4 // Waiting for the PLL after a write
+#define TEA5767_REGION_DECODE 5 // Decoding the read buffer
+#define TEA5767_REGION_APP 8 // First application defined region
+
+#ifdef TEA5767_PROFILE
+#define TEA5767_PROFILE_ENTER(region) uint8_t _tea5767_prev_region = tea5767_profile_enter(region)
+#define TEA5767_PROFILE_SWITCH(region) tea5767_profile_region = (region)
+#define TEA5767_PROFILE_EXIT() tea5767_profile_exit(_tea5767_prev_region)
+#else
+#define TEA5767_PROFILE_ENTER(region) do {} while (0)
+#define TEA5767_PROFILE_SWITCH(region) do {} while (0)
+#define TEA5767_PROFILE_EXIT() do {} while (0)
+#endif
+
+/************************************
+ * EXPORTED VARIABLES
+ ************************************/
+extern volatile uint8_t tea5767_profile_region;
+
+/************************************
+ * GLOBAL FUNCTION PROTOTYPES
+ ************************************/
+
+/*! @brief Tags the code that follows with a region ID.
+* @param region Region ID, lower than TEA5767_PROFILE_REGIONS.
+* @return uint8_t The previous region, to be handed back to tea5767_profile_exit().
+*/
+static inline uint8_t tea5767_profile_enter(uint8_t region) {
+    uint8_t prev = tea5767_profile_region;
+    tea5767_profile_region = region;
+    return prev;
+}
+
+/*! @brief Restores the region that was active before tea5767_profile_enter().
+* @param prev Value returned by tea5767_profile_enter().
+*/
+static inline void tea5767_profile_exit(uint8_t prev) {
+    tea5767_profile_region = prev;
+}
+
+/*! @brief Starts sampling the active region from a repeating timer IRQ.
+* Each sample costs one histogram increment in the IRQ, so the overhead is set by the period.
+* @param period_us Sample period in microseconds. Clamped to TEA5767_PROFILE_MIN_PERIOD_US.
+* @return bool true if the timer could be started.
+*/
+bool tea5767_profile_start(uint32_t period_us);
+
+/*! @brief Stops sampling. The histogram is kept until tea5767_profile_reset().
+*/
+void tea5767_profile_stop();
+
+/*! @brief Clears the histogram.
+*/
+void tea5767_profile_reset();
+
+/*! @brief Prints the histogram to stdout, one "profile,<region>,<samples>" line per non empty region.
+*/
+void tea5767_profile_dump();
+
+#endif
@@ -0,0 +1,113 @@
+/**
+ ********************************************************************************
+ * @file    tea5767_ring.c
+ * @author  Carlos Egea
+ * @date    18/10/2026
+ * @brief   Single writer, many readers lock-free ring of TEA5767 status records.
+ ********************************************************************************
+ */
+
+/************************************
+ * INCLUDES
+ ************************************/
+#include <string.h>
+#include "tea5767_ring.h"
+
+/************************************
+ * PRIVATE MACROS AND DEFINES
+ ************************************/
+// Full barrier, a DMB on the Cortex-M0+. Orders the sequence number against the payload.
+#define RING_BARRIER() __sync_synchronize()
+
+/************************************
+ * STATIC VARIABLES
+ ************************************/
+static TEA5767_ring_t *registry[TEA5767_RING_REGISTRY];
+
+/************************************
+ * STATIC FUNCTIONS
+ ************************************/
+static void tea5767_ring_resync(TEA5767_reader_t *reader) {
+    // Skip to the oldest record that cannot be overwritten by the next publish
+    uint32_t oldest = reader->ring->head - TEA5767_RING_SIZE + 1;
+    if ((int32_t)(oldest - reader->cursor) > 0) {
+        reader->dropped += oldest - reader->cursor;
+        reader->cursor = oldest;
+    }
+}
+
+/************************************
+ * GLOBAL FUNCTIONS
+ ************************************/
+bool tea5767_ring_init(TEA5767_ring_t *ring, const char *name) {
+    ring->name = name;
+    ring->head = 0;
+    for (int i = 0; i < TEA5767_RING_SIZE; i++) {
+        ring->slots[i].seq = 0;
+    }
+
+    for (int i = 0; i < TEA5767_RING_REGISTRY; i++) {
+        if (registry[i] == NULL || registry[i] == ring) {
+            registry[i] = ring;
+            return true;
+        }
+    }
+    return false;
+}
+
+void tea5767_ring_publish(TEA5767_ring_t *ring, const TEA5767_record_t *record) {
+    uint32_t index = ring->head;
+    TEA5767_slot_t *slot = &ring->slots[index & TEA5767_RING_MASK];
+
+    slot->seq = 2 * index + 1;
+    RING_BARRIER();
+    slot->record = *record;
+    RING_BARRIER();
+    slot->seq = 2 * index + 2;
+    ring->head = index + 1;
+}
+
+bool tea5767_ring_attach(TEA5767_reader_t *reader, const char *name) {
+    for (int i = 0; i < TEA5767_RING_REGISTRY; i++) {
+        if (registry[i] != NULL && strcmp(registry[i]->name, name) == 0) {
+            reader->ring = registry[i];
+            reader->cursor = registry[i]->head;
+            reader->dropped = 0;
+            return true;
+        }
+    }
+    return false;
+}
+
+const TEA5767_record_t *tea5767_ring_peek(TEA5767_reader_t *reader) {
+    TEA5767_slot_t *slot = &reader->ring->slots[reader->cursor & TEA5767_RING_MASK];
+    uint32_t expected = 2 * reader->cursor + 2;
+    int32_t diff = (int32_t)(slot->seq - expected);
+
+    if (diff < 0) {
+        // Not published yet
+        return NULL;
+    }
+    if (diff > 0) {
+        // Lapped by the writer
+        tea5767_ring_resync(reader);
+        slot = &reader->ring->slots[reader->cursor & TEA5767_RING_MASK];
+        if (slot->seq != 2 * reader->cursor + 2) {
+            return NULL;
+        }
+    }
+    RING_BARRIER();
+    return &slot->record;
+}
+
+bool tea5767_ring_release(TEA5767_reader_t *reader) {
+    TEA5767_slot_t *slot = &reader->ring->slots[reader->cursor & TEA5767_RING_MASK];
+    RING_BARRIER();
+    if (slot->seq != 2 * reader->cursor + 2) {
+        // Overwritten while it was being read
+        tea5767_ring_resync(reader);
+        return false;
+    }
+    reader->cursor++;
+    return true;
+}
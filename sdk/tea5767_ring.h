@@ -0,0 +1,97 @@
+/**
+ ********************************************************************************
+ * @file    tea5767_ring.h
+ * @author  Carlos Egea
+ * @date    18/10/2026
+ * @brief   Single writer, many readers lock-free ring of TEA5767 status records.
+ ********************************************************************************
+ */
+
+#ifndef _HARDWARE_TEA5767_RING_H
+#define _HARDWARE_TEA5767_RING_H
+
+/************************************
+ * INCLUDES
+ ************************************/
+#include "tea5767_i2c.h"
+
+/************************************
+ * MACROS AND DEFINES
+ ************************************/
+#define TEA5767_RING_SIZE 32 // Records kept in the ring, power of two
+#define TEA5767_RING_MASK (TEA5767_RING_SIZE - 1)
+#define TEA5767_RING_REGISTRY 4 // Rings that can be attached to by name
+
+/************************************
+ * TYPEDEFS
+ ************************************/
+/*! @brief One decoded status reading, as published into the ring
+*/
+typedef struct {
+uint32_t time_us;               // Time of the reading
+uint8_t tuner;                  // Index of the tuner that produced it
+TEA5767_status_t status;        // Decoded status
+} TEA5767_record_t;
+
+/*! @brief Ring slot. The sequence number is odd while the writer fills the record.
+*/
+typedef struct {
+volatile uint32_t seq;          // 2 * index + 2 once record index is complete
+TEA5767_record_t record;        // Payload
+} TEA5767_slot_t;
+
+/*! @brief The ring. Only the writer modifies it, so any number of readers can follow it,
+* on either core, without locks and without slowing the writer down.
+*/
+typedef struct {
+const char *name;               // Name readers attach by
+volatile uint32_t head;         // Records published so far
+TEA5767_slot_t slots[TEA5767_RING_SIZE];
+} TEA5767_ring_t;
+
+/*! @brief Per reader state. Lives with the reader, never written by the writer.
+*/
+typedef struct {
+TEA5767_ring_t *ring;           // Ring followed
+uint32_t cursor;                // Next record index to read
+uint32_t dropped;               // Records overwritten before they could be read
+} TEA5767_reader_t;
+
+/************************************
+ * GLOBAL FUNCTION PROTOTYPES
+ ************************************/
+
+/*! @brief Initializes an empty ring and makes it reachable by name through tea5767_ring_attach().
+* @param ring Ring to initialize.
+* @param name Name of the ring. The string must outlive the ring.
+* @return bool false if \ref TEA5767_RING_REGISTRY rings are already registered.
+*/
+bool tea5767_ring_init(TEA5767_ring_t *ring, const char *name);
+
+/*! @brief Publishes a record. Never blocks; the oldest record is overwritten when the ring is full.
+* @param ring Ring written. Must only be called from one context.
+* @param record Record copied into the ring.
+*/
+void tea5767_ring_publish(TEA5767_ring_t *ring, const TEA5767_record_t *record);
+
+/*! @brief Attaches a reader to the named ring. The reader starts at the next record to be published.
+* @param reader Reader state to initialize.
+* @param name Name given to tea5767_ring_init().
+* @return bool false if no ring with that name exists.
+*/
+bool tea5767_ring_attach(TEA5767_reader_t *reader, const char *name);
+
+/*! @brief Returns the next record in place, without copying it.
+* The record must be handed back with tea5767_ring_release() before it is trusted.
+* @param reader Attached reader.
+* @return const TEA5767_record_t* The record, or NULL if nothing new was published.
+*/
+const TEA5767_record_t *tea5767_ring_peek(TEA5767_reader_t *reader);
+
+/*! @brief Finishes reading the record returned by tea5767_ring_peek() and moves to the next one.
+* @param reader Attached reader.
+* @return bool true if the record was not overwritten while it was being read.
+*/
+bool tea5767_ring_release(TEA5767_reader_t *reader);
+
+#endif
@@ -0,0 +1,56 @@
+/**
+ ********************************************************************************
+ * @file    tea5767_sampler.c
+ * @author  Carlos Egea
+ * @date    18/10/2026
+ * @brief   Time aligned status sampling across several TEA5767 tuners.
+ ********************************************************************************
+ */
+
+/************************************
+ * INCLUDES
+ ************************************/
+#include "pico/time.h"
+#include "tea5767_sampler.h"
+
+/************************************
+ * GLOBAL FUNCTIONS
+ ************************************/
+void tea5767_sampleAll(const TEA5757_t *radios, uint8_t count, TEA5767_sample_t *sample) {
+    uint8_t buf[TEA5767_SAMPLER_MAX][TEA5767_REGISTERS];
+    uint64_t stamp[TEA5767_SAMPLER_MAX];
+
+    if (count > TEA5767_SAMPLER_MAX) {
+        count = TEA5767_SAMPLER_MAX;
+    }
+
+    // Burst: bus transactions only
+    uint64_t start = time_us_64();
+    uint64_t before = start;
+    for (uint8_t i = 0; i < count; i++) {
+        tea5767_read_raw(radios[i], buf[i]);
+        uint64_t after = time_us_64();
+        stamp[i] = before + (after - before) / 2;
+        before = after;
+    }
+
+    // Decode outside the burst
+    uint64_t sum = 0;
+    sample->count = count;
+    sample->burst_us = before - start;
+    sample->skew_us = count ? stamp[count - 1] - stamp[0] : 0;
+    for (uint8_t i = 0; i < count; i++) {
+        TEA5767_record_t *record = &sample->records[i];
+        record->time_us = stamp[i];
+        record->tuner = i;
+        tea5767_decode_status(buf[i], radios[i].pll_offset, &record->status);
+        sum += stamp[i] - start;
+    }
+    sample->time_us = count ? start + sum / count : start;
+}
+
+void tea5767_sample_publish(TEA5767_ring_t *ring, const TEA5767_sample_t *sample) {
+    for (uint8_t i = 0; i < sample->count; i++) {
+        tea5767_ring_publish(ring, &sample->records[i]);
+    }
+}
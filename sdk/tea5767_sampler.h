@@ -0,0 +1,56 @@
+/**
+ ********************************************************************************
+ * @file    tea5767_sampler.h
+ * @author  Carlos Egea
+ * @date    18/10/2026
+ * @brief   Time aligned status sampling across several TEA5767 tuners.
+ ********************************************************************************
+ */
+
+#ifndef _HARDWARE_TEA5767_SAMPLER_H
+#define _HARDWARE_TEA5767_SAMPLER_H
+
+/************************************
+ * INCLUDES
+ ************************************/
+#include "tea5767_i2c.h"
+#include "tea5767_ring.h"
+
+/************************************
+ * MACROS AND DEFINES
+ ************************************/
+#define TEA5767_SAMPLER_MAX 8 // Tuners sampled in one burst
+
+/************************************
+ * TYPEDEFS
+ ************************************/
+/*! @brief One burst of status readings, one record per tuner
+*/
+typedef struct {
+uint64_t time_us;               // Common timestamp, mean of the tuners' reading times
+uint32_t skew_us;               // Time between the first and the last tuner reading
+uint32_t burst_us;              // Duration of the whole burst
+uint8_t count;                  // Records in the burst
+TEA5767_record_t records[TEA5767_SAMPLER_MAX];
+} TEA5767_sample_t;
+
+/************************************
+ * GLOBAL FUNCTION PROTOTYPES
+ ************************************/
+
+/*! @brief Reads the status of all tuners back to back and stamps them with a shared timebase.
+* The reads are issued first and decoded afterwards so nothing but bus traffic happens inside the burst.
+* Each record is stamped with the midpoint of its own read transaction.
+* @param radios Tuners to sample.
+* @param count Number of tuners, at most \ref TEA5767_SAMPLER_MAX.
+* @param sample Filled with the burst.
+*/
+void tea5767_sampleAll(const TEA5757_t *radios, uint8_t count, TEA5767_sample_t *sample);
+
+/*! @brief Publishes every record of a burst into a ring.
+* @param ring Ring written.
+* @param sample Burst filled by tea5767_sampleAll().
+*/
+void tea5767_sample_publish(TEA5767_ring_t *ring, const TEA5767_sample_t *sample);
+
+#endif
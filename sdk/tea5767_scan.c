@@ -0,0 +1,443 @@
+/**
+ ********************************************************************************
+ * @file    tea5767_scan.c
+ * @author  Carlos Egea
+ * @date    18/10/2026
+ * @brief   Band scanning strategies for the TEA5767.
+ ********************************************************************************
+ */
+
+/************************************
+ * INCLUDES
+ ************************************/
+#include <string.h>
+#include "pico/time.h"
+#include "tea5767_scan.h"
+
+/************************************
+ * PRIVATE TYPEDEFS
+ ************************************/
+typedef struct {
+TEA5757_t radio;                // Copy of the tuner in search mode
+int8_t direction;               // 1 up, -1 down
+bool active;                    // Search started and not over
+uint16_t found;                 // Channel of the valid stop, 0 if none
+} seek_side_t;
+
+/************************************
+ * STATIC FUNCTIONS
+ ************************************/
+static uint16_t scan_channel(float frequency) {
+    return (tea5767_stations_channel(frequency) + TEA5767_SCAN_STEP / 2) / TEA5767_SCAN_STEP * TEA5767_SCAN_STEP;
+}
+
+static void scan_init(TEA5767_scan_t *ctx, TEA5757_t *radio, TEA5767_stations_t *db, uint8_t min_level,
+                      TEA5767_scan_cb cb, void *user) {
+    memset(ctx, 0, sizeof(*ctx));
+    ctx->radio = radio;
+    ctx->db = db;
+    ctx->min_level = min_level;
+    ctx->cb = cb;
+    ctx->user = user;
+    tea5767_scan_band(*radio, &ctx->first, &ctx->last);
+    ctx->tuned = radio->frequency;
+    ctx->start = time_us_64();
+}
+
+static void scan_finish(TEA5767_scan_t *ctx, TEA5767_scan_stats_t *stats) {
+    ctx->stats.elapsed_us = time_us_64() - ctx->start;
+    if (ctx->stats.found) {
+        uint16_t recorded = ctx->stats.found < TEA5767_STATIONS_MAX ? ctx->stats.found : TEA5767_STATIONS_MAX;
+        ctx->stats.first_us = ctx->found_us[0];
+        ctx->stats.most_us = ctx->found_us[(recorded * 9 + 9) / 10 - 1];
+    }
+    if (stats) {
+        *stats = ctx->stats;
+    }
+}
+
+static bool scan_mark(TEA5767_scan_t *ctx, uint16_t channel) {
+    if (channel < ctx->first || channel > ctx->last || (channel - ctx->first) % TEA5767_SCAN_STEP) {
+        return false;
+    }
+    uint16_t index = (channel - ctx->first) / TEA5767_SCAN_STEP;
+    if (ctx->visited[index / 8] & (1 << (index % 8))) {
+        return false;
+    }
+    ctx->visited[index / 8] |= 1 << (index % 8);
+    ctx->stats.visited++;
+    return true;
+}
+
+static void scan_found(TEA5767_scan_t *ctx, uint16_t channel, const TEA5767_status_t *status) {
+    uint32_t now = time_us_64() - ctx->start;
+    if (ctx->stats.found < TEA5767_STATIONS_MAX) {
+        ctx->found_us[ctx->stats.found] = now;
+    }
+    ctx->stats.found++;
+    ctx->last_found = channel;
+    tea5767_stations_update(ctx->db, channel, status->level, status->stereo ? TEA5767_STATION_STEREO : 0);
+    if (ctx->cb) {
+        ctx->cb(status, ctx->user);
+    }
+}
+
+static void scan_visit(TEA5767_scan_t *ctx, uint16_t channel) {
+    TEA5767_status_t status;
+
+    if (!scan_mark(ctx, channel)) {
+        return;
+    }
+    ctx->stats.transactions += 2;
+
+    if (tea5767_scan_probe(ctx->radio, channel, ctx->min_level, &status)) {
+        scan_found(ctx, channel, &status);
+    } else {
+        tea5767_stations_remove(ctx->db, channel);
+    }
+}
+
+static void scan_range(TEA5767_scan_t *ctx, uint16_t from, uint16_t to) {
+    for (uint16_t channel = from; channel <= to && channel <= ctx->last; channel += TEA5767_SCAN_STEP) {
+        scan_visit(ctx, channel);
+    }
+}
+
+// Channels a hardware search went over without stopping hold nothing above the stop level. A known
+// station may still be above min_level there, so it is probed as the software scan would.
+static void scan_skip(TEA5767_scan_t *ctx, uint16_t from, uint16_t to) {
+    for (uint16_t channel = from; channel < to; channel += TEA5767_SCAN_STEP) {
+        if (tea5767_stations_find(ctx->db, channel) >= 0) {
+            scan_visit(ctx, channel);
+        } else {
+            scan_mark(ctx, channel);
+        }
+    }
+}
+
+// Starts a hardware search up from a channel and waits for it to stop. The radio is left in search mode.
+static bool scan_search(TEA5767_scan_t *ctx, uint16_t from, TEA5767_status_t *status) {
+    TEA5757_t search = *ctx->radio;
+
+    search.searchMode = true;
+    search.searchUpDown = 1;
+    search.frequency = from / 100.0f;
+    search.settle_ms = 0;
+    tea5767_write_registers(search);
+    ctx->stats.transactions++;
+
+    uint64_t start = time_us_64();
+    do {
+        sleep_ms(TEA5767_SEARCH_POLL_MS);
+        tea5767_getStatus(search, status);
+        ctx->stats.transactions++;
+        if (status->ready) {
+            return true;
+        }
+    } while (time_us_64() - start < TEA5767_SEARCH_TIMEOUT_US);
+    return false;
+}
+
+static void seek_start(seek_side_t *side, uint16_t from, uint32_t *transactions) {
+    side->radio.searchMode = true;
+    side->radio.searchUpDown = side->direction > 0;
+    side->radio.frequency = from / 100.0f;
+    side->radio.settle_ms = 0;
+    tea5767_write_registers(side->radio);
+    side->active = true;
+    side->found = 0;
+    (*transactions)++;
+}
+
+// Polls one side of a seek, restarting it past a false stop. Returns true when the side is over.
+static bool seek_poll(seek_side_t *side, uint16_t first, uint16_t last, uint8_t min_level, uint32_t *transactions) {
+    TEA5767_status_t status;
+
+    tea5767_getStatus(side->radio, &status);
+    (*transactions)++;
+    if (!status.ready) {
+        return false;
+    }
+    side->active = false;
+    if (status.bandLimit) {
+        return true;
+    }
+
+    uint16_t channel = scan_channel(status.frequency);
+    if (status.level >= min_level && status.ifCounter >= TEA5767_IF_MIN && status.ifCounter <= TEA5767_IF_MAX) {
+        side->found = channel;
+        return true;
+    }
+    int next = channel + side->direction * TEA5767_SCAN_STEP;
+    if (next >= first && next <= last) {
+        seek_start(side, next, transactions);
+        return false;
+    }
+    return true;
+}
+
+/************************************
+ * GLOBAL FUNCTIONS
+ ************************************/
+void tea5767_scan_band(TEA5757_t radio, uint16_t *first, uint16_t *last) {
+    if (radio.band_mode == JP_BAND) {
+        *first = tea5767_stations_channel(MIN_FREQ_JP);
+        *last = tea5767_stations_channel(MAX_FREQ_JP);
+    } else {
+        *first = tea5767_stations_channel(MIN_FREQ_EU);
+        *last = tea5767_stations_channel(MAX_FREQ_EU);
+    }
+}
+
+bool tea5767_scan_probe(TEA5757_t *radio, uint16_t channel, uint8_t min_level, TEA5767_status_t *status) {
+    radio->searchMode = false;
+    radio->frequency = channel / 100.0f;
+    tea5767_write_registers(*radio);
+    tea5767_getStatus(*radio, status);
+    return status->level >= min_level && status->ifCounter >= TEA5767_IF_MIN && status->ifCounter <= TEA5767_IF_MAX;
+}
+
+void tea5767_scanOrdered(TEA5757_t *radio, TEA5767_scan_t *scan, TEA5767_stations_t *db, const uint16_t *hints,
+                         uint8_t hint_count, uint8_t min_level, TEA5767_scan_cb cb, void *user,
+                         TEA5767_scan_stats_t *stats) {
+    uint8_t known = db->ranked;
+
+    scan_init(scan, radio, db, min_level, cb, user);
+
+    // Known stations best first. Channels are copied first, visiting updates the ranking in place
+    uint16_t channels[TEA5767_STATIONS_MAX];
+    for (uint8_t i = 0; i < known; i++) {
+        channels[i] = db->channel[tea5767_stations_rank(db, i)];
+    }
+    for (uint8_t i = 0; i < known; i++) {
+        scan_visit(scan, channels[i]);
+    }
+
+    for (uint8_t i = 0; hints && i < hint_count; i++) {
+        scan_visit(scan, hints[i]);
+    }
+
+    scan_range(scan, scan->first, scan->last);
+
+    scan_finish(scan, stats);
+}
+
+void tea5767_scanSoftware(TEA5757_t *radio, TEA5767_scan_t *scan, TEA5767_stations_t *db, uint8_t min_level,
+                          TEA5767_scan_cb cb, void *user, TEA5767_scan_stats_t *stats) {
+    scan_init(scan, radio, db, min_level, cb, user);
+    scan_range(scan, scan->first, scan->last);
+    scan_finish(scan, stats);
+}
+
+void tea5767_scanHardware(TEA5757_t *radio, TEA5767_scan_t *scan, TEA5767_stations_t *db, uint8_t min_level,
+                          TEA5767_scan_cb cb, void *user, TEA5767_scan_stats_t *stats) {
+    TEA5767_status_t status;
+
+    scan_init(scan, radio, db, min_level, cb, user);
+    uint16_t from = scan->first;
+
+    while (from <= scan->last) {
+        if (!scan_search(scan, from, &status)) {
+            // Search never stopped, step the rest of the band
+            scan_range(scan, from, scan->last);
+            break;
+        }
+        if (status.bandLimit) {
+            scan_skip(scan, from, scan->last + TEA5767_SCAN_STEP);
+            break;
+        }
+
+        uint16_t channel = scan_channel(status.frequency);
+        bool valid = status.level >= min_level && status.ifCounter >= TEA5767_IF_MIN
+                && status.ifCounter <= TEA5767_IF_MAX;
+
+        if (channel < from || channel > scan->last) {
+            // Stopped outside the searched span, step one segment and search again after it
+            uint16_t to = from + TEA5767_SEGMENT_WIDTH - TEA5767_SCAN_STEP;
+            scan_range(scan, from, to);
+            from = to + TEA5767_SCAN_STEP;
+            continue;
+        }
+        if (!valid) {
+            // False stop, the search cannot be trusted up to here
+            scan_range(scan, from, channel);
+            from = channel + TEA5767_SCAN_STEP;
+            continue;
+        }
+
+        scan_skip(scan, from, channel);
+        if (scan_mark(scan, channel)) {
+            scan_found(scan, channel, &status);
+        }
+        from = channel + TEA5767_SCAN_STEP;
+    }
+
+    // Leave search mode, tuned to the last station found or back where the scan started
+    radio->searchMode = false;
+    radio->frequency = scan->last_found ? scan->last_found / 100.0f : scan->tuned;
+    tea5767_write_registers(*radio);
+    scan->stats.transactions++;
+
+    scan_finish(scan, stats);
+}
+
+void tea5767_detector_init(TEA5767_detector_t *detector, uint8_t threshold) {
+    memset(detector, 0, sizeof(*detector));
+    detector->threshold = threshold;
+}
+
+bool tea5767_detector_observe(TEA5767_detector_t *detector, TEA5757_t radio, TEA5767_stations_t *db,
+                              const TEA5767_status_t *status, uint8_t min_level) {
+    uint16_t first, last;
+    bool changed;
+
+    tea5767_scan_band(radio, &first, &last);
+    uint16_t channel = scan_channel(status->frequency);
+    if (channel < first || channel > last) {
+        return false;
+    }
+    detector->observations++;
+
+    bool valid = status->level >= min_level && status->ifCounter >= TEA5767_IF_MIN
+            && status->ifCounter <= TEA5767_IF_MAX;
+    TEA5767_station_t station;
+    if (tea5767_stations_get(db, channel, &station)) {
+        int diff = (int)status->level - station.level;
+        changed = !valid || diff >= detector->threshold || -diff >= detector->threshold;
+    } else {
+        changed = valid;
+    }
+    if (!changed) {
+        return false;
+    }
+
+    uint32_t segment = 1u << ((channel - first) / TEA5767_SEGMENT_WIDTH);
+    detector->changes++;
+    if (detector->dirty == 0) {
+        detector->changed_us = time_us_64();
+    }
+    detector->dirty |= segment;
+    return true;
+}
+
+void tea5767_rescanChanged(TEA5757_t *radio, TEA5767_scan_t *scan, TEA5767_detector_t *detector,
+                           TEA5767_stations_t *db, uint8_t min_level, TEA5767_scan_cb cb, void *user,
+                           TEA5767_scan_stats_t *stats) {
+    scan_init(scan, radio, db, min_level, cb, user);
+    uint8_t segments = (scan->last - scan->first) / TEA5767_SEGMENT_WIDTH + 1;
+
+    if (detector->dirty) {
+        detector->delay_us = scan->start - detector->changed_us;
+    }
+    for (uint8_t segment = 0; segment < segments && segment < TEA5767_SEGMENTS; segment++) {
+        if (!(detector->dirty & (1u << segment))) {
+            detector->avoided++;
+            continue;
+        }
+        uint16_t from = scan->first + segment * TEA5767_SEGMENT_WIDTH;
+        scan_range(scan, from, from + TEA5767_SEGMENT_WIDTH - TEA5767_SCAN_STEP);
+        detector->rescanned++;
+    }
+    detector->dirty = 0;
+
+    scan_finish(scan, stats);
+}
+
+bool tea5767_seekParallel(TEA5757_t *play, TEA5757_t *helper, int8_t direction, uint8_t min_level,
+                          TEA5767_seek_t *seek) {
+    seek_side_t sides[2];
+    uint8_t count = helper ? 2 : 1;
+    uint16_t first, last;
+    TEA5767_seek_t result;
+    bool handed = false;
+    uint16_t parked;
+
+    memset(&result, 0, sizeof(result));
+    memset(sides, 0, sizeof(sides));
+    tea5767_scan_band(*play, &first, &last);
+    uint16_t from = scan_channel(play->frequency);
+    uint64_t start = time_us_64();
+    parked = from;
+
+    sides[0].radio = *play;
+    sides[0].direction = direction < 0 ? -1 : 1;
+    if (helper) {
+        sides[1].radio = *helper;
+        sides[1].direction = -sides[0].direction;
+    }
+    for (uint8_t i = 0; i < count; i++) {
+        int next = from + sides[i].direction * TEA5767_SCAN_STEP;
+        if (next >= first && next <= last) {
+            seek_start(&sides[i], next, &result.transactions);
+        }
+    }
+
+    while ((sides[0].active || sides[1].active) && time_us_64() - start < TEA5767_SEARCH_TIMEOUT_US) {
+        sleep_ms(TEA5767_SEARCH_POLL_MS);
+        for (uint8_t i = 0; i < count; i++) {
+            if (!sides[i].active || !seek_poll(&sides[i], first, last, min_level, &result.transactions)) {
+                continue;
+            }
+            if (sides[i].found) {
+                if (sides[i].direction > 0) {
+                    result.next = sides[i].found / 100.0f;
+                } else {
+                    result.prev = sides[i].found / 100.0f;
+                }
+                if (i == 1) {
+                    parked = sides[i].found;
+                }
+            }
+            if (handed || !sides[i].found || (direction && sides[i].direction != direction)) {
+                continue;
+            }
+            // Hand the station to the playing tuner, already locked there if it found it itself
+            play->searchMode = false;
+            play->frequency = sides[i].found / 100.0f;
+            if (i == 0) {
+                TEA5757_t locked = *play;
+                locked.settle_ms = 0;
+                tea5767_write_registers(locked);
+            } else {
+                tea5767_write_registers(*play);
+                // The playing tuner left the up search, the helper takes it over to fill in next
+                if (sides[0].active) {
+                    sides[0].active = false;
+                    sides[1].direction = 1;
+                    if (from + TEA5767_SCAN_STEP <= last) {
+                        seek_start(&sides[1], from + TEA5767_SCAN_STEP, &result.transactions);
+                    }
+                }
+            }
+            result.transactions++;
+            result.latency_us = time_us_64() - start;
+            handed = true;
+        }
+        // The playing side ran out of band without a winner, nothing left to wait for in that direction
+        if (!handed && direction && !sides[0].active && !sides[0].found) {
+            break;
+        }
+    }
+
+    if (!handed) {
+        // Back to where it was, the search left the tuner somewhere else
+        play->searchMode = false;
+        play->frequency = from / 100.0f;
+        tea5767_write_registers(*play);
+        result.transactions++;
+    }
+    if (helper) {
+        helper->searchMode = false;
+        helper->frequency = parked / 100.0f;
+        TEA5757_t locked = *helper;
+        locked.settle_ms = 0;
+        tea5767_write_registers(locked);
+        result.transactions++;
+    }
+
+    result.elapsed_us = time_us_64() - start;
+    if (seek) {
+        *seek = result;
+    }
+    return handed;
+}
@@ -0,0 +1,208 @@
+/**
+ ********************************************************************************
+ * @file    tea5767_scan.h
+ * @author  Carlos Egea
+ * @date    18/10/2026
+ * @brief   Band scanning strategies for the TEA5767.
+ ********************************************************************************
+ */
+
+#ifndef _HARDWARE_TEA5767_SCAN_H
+#define _HARDWARE_TEA5767_SCAN_H
+
+/************************************
+ * INCLUDES
+ ************************************/
+#include "tea5767_i2c.h"
+#include "tea5767_stations.h"
+
+/************************************
+ * MACROS AND DEFINES
+ ************************************/
+#define TEA5767_SCAN_STEP 10 // Channel spacing in station database units (100 kHz)
+#define TEA5767_SCAN_CHANNELS 256 // Upper bound of channels in a band
+#define TEA5767_SEGMENT_WIDTH 100 // Band segment rescanned on a change, station database units (1 MHz)
+#define TEA5767_SEGMENTS 32 // Segments tracked by the change detector, enough for either band
+#define TEA5767_SEARCH_POLL_MS 10 // Ready flag polling period during a hardware search
+#define TEA5767_SEARCH_TIMEOUT_US 3000000 // A hardware search that did not stop by then is given up
+
+/************************************
+ * TYPEDEFS
+ ************************************/
+/*! @brief Called for every station found, as soon as it is found
+*/
+typedef void (*TEA5767_scan_cb)(const TEA5767_status_t *status, void *user);
+
+/*! @brief Figures of a finished scan
+*/
+typedef struct {
+uint16_t visited;               // Channels tuned
+uint16_t found;                 // Stations found
+uint32_t transactions;          // Bus transactions issued
+uint32_t first_us;              // Time to the first station
+uint32_t most_us;               // Time to 90% of the stations found
+uint32_t elapsed_us;            // Duration of the whole scan
+} TEA5767_scan_stats_t;
+
+/*! @brief State of a scan in progress. Owned by the caller, so tuners scanned at the same time, from
+* one core or both, each need their own.
+*/
+typedef struct {
+TEA5757_t *radio;               // Tuner scanning
+TEA5767_stations_t *db;         // Station database updated
+uint8_t min_level;              // Lowest ADC level accepted as a station
+TEA5767_scan_cb cb;             // Called for each station found, or NULL
+void *user;                     // Passed to cb
+uint16_t first;                 // Lowest channel of the band
+uint16_t last;                  // Highest channel of the band
+uint8_t visited[TEA5767_SCAN_CHANNELS / 8]; // Channels already tuned, one bit each from first
+uint32_t found_us[TEA5767_STATIONS_MAX];    // Time of each station found, from start
+uint64_t start;                 // Time the scan started
+float tuned;                    // Frequency of the radio when the scan started
+uint16_t last_found;            // Channel of the last station reported, 0 if none
+TEA5767_scan_stats_t stats;
+} TEA5767_scan_t;
+
+/*! @brief Band occupancy change detector. Marks the segments where readings disagree with the database.
+*/
+typedef struct {
+uint32_t dirty;                 // Segments to rescan, bit n for the n-th segment from the band start
+uint8_t threshold;              // Level difference taken as a change
+uint64_t changed_us;            // Time of the first change not yet rescanned
+uint32_t observations;          // Readings checked
+uint32_t changes;               // Readings that disagreed with the database
+uint32_t rescanned;             // Segments rescanned
+uint32_t avoided;               // Segments left alone because nothing changed there
+uint32_t delay_us;              // Last delay between detecting a change and rescanning it
+} TEA5767_detector_t;
+
+/*! @brief Outcome of a seek
+*/
+typedef struct {
+float next;                     // Nearest valid station above the start, 0 if none was found
+float prev;                     // Nearest valid station below the start, 0 if none was found
+uint32_t latency_us;            // Time until the playing tuner was on the new station
+uint32_t elapsed_us;            // Time until both searches were over
+uint32_t transactions;          // Bus transactions issued
+} TEA5767_seek_t;
+
+/************************************
+ * GLOBAL FUNCTION PROTOTYPES
+ ************************************/
+
+/*! @brief Returns the first and last channel of the radio's band.
+* @param radio The TEA5757_t structure representing the radio device.
+* @param first Lowest channel, in station database units.
+* @param last Highest channel, in station database units.
+*/
+void tea5767_scan_band(TEA5757_t radio, uint16_t *first, uint16_t *last);
+
+/*! @brief Tunes a channel and tells whether a station is there.
+* @param radio Pointer to the TEA5757_t structure. Left tuned to the channel.
+* @param channel Channel in station database units.
+* @param min_level Lowest ADC level accepted as a station.
+* @param status Filled with the status read after tuning.
+* @return bool true if the level is high enough and the IF counter in range.
+*/
+bool tea5767_scan_probe(TEA5757_t *radio, uint16_t channel, uint8_t min_level, TEA5767_status_t *status);
+
+/*! @brief Scans the band visiting the most likely channels first.
+* Known stations are visited first, strongest last level first (stereo first at equal level), then the hint channels (a band map from
+* other units for instance), then the rest of the band in ascending order. Every channel is visited once.
+* The database is updated with what is found, and stations no longer received are removed.
+* @param radio Pointer to the TEA5757_t structure.
+* @param scan Scan state, not shared with a scan running at the same time.
+* @param db Station database used as prior and updated.
+* @param hints Extra channels to try early, in order, or NULL.
+* @param hint_count Number of hints.
+* @param min_level Lowest ADC level accepted as a station.
+* @param cb Called for each station found, or NULL.
+* @param user Passed to cb.
+* @param stats Filled with the scan figures, or NULL.
+*/
+void tea5767_scanOrdered(TEA5757_t *radio, TEA5767_scan_t *scan, TEA5767_stations_t *db, const uint16_t *hints,
+                         uint8_t hint_count, uint8_t min_level, TEA5767_scan_cb cb, void *user,
+                         TEA5767_scan_stats_t *stats);
+
+/*! @brief Scans the band by stepping every channel from software, one write and one read each.
+* @param radio Pointer to the TEA5757_t structure.
+* @param scan Scan state, not shared with a scan running at the same time.
+* @param db Station database, updated.
+* @param min_level Lowest ADC level accepted as a station.
+* @param cb Called for each station found, or NULL.
+* @param user Passed to cb.
+* @param stats Filled with the scan figures, or NULL.
+*/
+void tea5767_scanSoftware(TEA5757_t *radio, TEA5767_scan_t *scan, TEA5767_stations_t *db, uint8_t min_level,
+                          TEA5767_scan_cb cb, void *user, TEA5767_scan_stats_t *stats);
+
+/*! @brief Scans the band by chaining the tuner's own searches.
+* A search up is started from the band start and restarted just above every station found, until the band
+* limit flag is set. The stop level is the radio's searchLevel. Where the search proves unreliable (a stop
+* that fails the level or IF counter check, a stop outside the searched span, or no stop at all) that
+* segment is stepped from software instead. Known stations a search went over are probed, so one above
+* min_level but below the stop level is kept as tea5767_scanSoftware() would keep it.
+* @param radio Pointer to the TEA5757_t structure. Left out of search mode, on the last station found,
+* or on its starting frequency if none was.
+* @param scan Scan state, not shared with a scan running at the same time.
+* @param db Station database, updated.
+* @param min_level Lowest ADC level accepted as a station.
+* @param cb Called for each station found, or NULL.
+* @param user Passed to cb.
+* @param stats Filled with the scan figures, or NULL.
+*/
+void tea5767_scanHardware(TEA5757_t *radio, TEA5767_scan_t *scan, TEA5767_stations_t *db, uint8_t min_level,
+                          TEA5767_scan_cb cb, void *user, TEA5767_scan_stats_t *stats);
+
+/*! @brief Initializes a change detector with no segment to rescan.
+* @param detector Detector to initialize.
+* @param threshold Level difference taken as a change.
+*/
+void tea5767_detector_init(TEA5767_detector_t *detector, uint8_t threshold);
+
+/*! @brief Checks a reading taken while monitoring a channel or at the stop of a seek.
+* A change is a known station whose level moved by the threshold or more or whose IF counter went out of
+* range, or a station at a channel the database does not know.
+* @param detector Detector.
+* @param radio The TEA5757_t structure the reading comes from.
+* @param db Station database.
+* @param status Reading to check.
+* @param min_level Lowest ADC level accepted as a station.
+* @return bool true if the reading marked its segment for rescanning.
+*/
+bool tea5767_detector_observe(TEA5767_detector_t *detector, TEA5757_t radio, TEA5767_stations_t *db,
+                              const TEA5767_status_t *status, uint8_t min_level);
+
+/*! @brief Rescans only the segments marked by the detector and clears them.
+* @param radio Pointer to the TEA5757_t structure.
+* @param scan Scan state, not shared with a scan running at the same time.
+* @param detector Detector.
+* @param db Station database, updated.
+* @param min_level Lowest ADC level accepted as a station.
+* @param cb Called for each station found, or NULL.
+* @param user Passed to cb.
+* @param stats Filled with the scan figures, or NULL.
+*/
+void tea5767_rescanChanged(TEA5757_t *radio, TEA5767_scan_t *scan, TEA5767_detector_t *detector,
+                           TEA5767_stations_t *db, uint8_t min_level, TEA5767_scan_cb cb, void *user,
+                           TEA5767_scan_stats_t *stats);
+
+/*! @brief Seeks the next station with one or two tuners searching at the same time.
+* The playing tuner searches in the requested direction and the helper, if any, in the opposite one. Both are
+* polled together and false stops are searched past. For direction 0 the first valid stop reported by either
+* side wins. Both sides step at the same pace, so it is usually the closer station, but a side with more false
+* stops to search past can lose to a farther station on the other side. Otherwise only a stop in the requested
+* direction wins. The playing tuner is handed the winning station as soon as it is known, and the helper keeps
+* searching to fill in next and prev so that the following seek either way can be a plain tune. When the helper
+* wins it takes over the up search the playing tuner left. Without a helper this is a single-tuner seek.
+* @param play Pointer to the playing tuner. Left out of search mode, on the station found or where it was.
+* @param helper Pointer to the second tuner, or NULL. Left out of search mode, on the last stop it accepted.
+* @param direction 1 up, -1 down, 0 nearest either way (up without a helper).
+* @param min_level Lowest ADC level accepted as a station.
+* @param seek Filled with the seek figures, or NULL.
+* @return bool true if the playing tuner was moved to a new station.
+*/
+bool tea5767_seekParallel(TEA5757_t *play, TEA5757_t *helper, int8_t direction, uint8_t min_level,
+                          TEA5767_seek_t *seek);
+
+#endif
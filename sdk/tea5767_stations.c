@@ -0,0 +1,334 @@
+/**
+ ********************************************************************************
+ * @file    tea5767_stations.c
+ * @author  Carlos Egea
+ * @date    18/10/2026
+ * @brief   Versioned station database with delta synchronisation.
+ ********************************************************************************
+ */
+
+/************************************
+ * INCLUDES
+ ************************************/
+#include <string.h>
+#include "tea5767_stations.h"
+
+/************************************
+ * STATIC FUNCTIONS
+ ************************************/
+static void put_u32(uint8_t *buf, uint32_t value) {
+    buf[0] = value;
+    buf[1] = value >> 8;
+    buf[2] = value >> 16;
+    buf[3] = value >> 24;
+}
+
+static uint32_t get_u32(const uint8_t *buf) {
+    return buf[0] | buf[1] << 8 | (uint32_t)buf[2] << 16 | (uint32_t)buf[3] << 24;
+}
+
+// Binary search over the channel column. Returns the index of channel, or -1 with *pos set to where it goes.
+static int tea5767_stations_search(const TEA5767_stations_t *db, uint16_t channel, int *pos) {
+    int lo = 0;
+    int hi = db->count;
+
+    while (lo < hi) {
+        int mid = (lo + hi) >> 1;
+        if (db->channel[mid] < channel) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    if (pos) {
+        *pos = lo;
+    }
+    return (lo < db->count && db->channel[lo] == channel) ? lo : -1;
+}
+
+static void tea5767_stations_move(TEA5767_stations_t *db, int dst, int src, int n) {
+    memmove(&db->channel[dst], &db->channel[src], n * sizeof(db->channel[0]));
+    memmove(&db->level[dst], &db->level[src], n * sizeof(db->level[0]));
+    memmove(&db->flags[dst], &db->flags[src], n * sizeof(db->flags[0]));
+    memmove(&db->quality[dst], &db->quality[src], n * sizeof(db->quality[0]));
+    memmove(&db->seen[dst], &db->seen[src], n * sizeof(db->seen[0]));
+    memmove(&db->changed[dst], &db->changed[src], n * sizeof(db->changed[0]));
+    memmove(&db->rank_pos[dst], &db->rank_pos[src], n * sizeof(db->rank_pos[0]));
+}
+
+static void tea5767_stations_place(TEA5767_stations_t *db, int pos, uint8_t index) {
+    db->rank[pos] = index;
+    db->rank_pos[index] = pos;
+}
+
+// Moves a ranked station between quality groups, -1 being the unranked slot past the last group
+static void tea5767_stations_regroup(TEA5767_stations_t *db, int i, int from, int to) {
+    while (from > to) {
+        // Swap with the last of the group, then shrink the group over it
+        int last = db->tail[from] - 1;
+        uint8_t other = db->rank[last];
+        tea5767_stations_place(db, db->rank_pos[i], other);
+        tea5767_stations_place(db, last, i);
+        db->tail[from--]--;
+    }
+    while (from < to) {
+        // Swap with the first of the group, then grow the group above over it
+        int first = db->tail[++from];
+        uint8_t other = db->rank[first];
+        tea5767_stations_place(db, db->rank_pos[i], other);
+        tea5767_stations_place(db, first, i);
+        db->tail[from]++;
+    }
+}
+
+static void tea5767_stations_rank_drop(TEA5767_stations_t *db, int i) {
+    tea5767_stations_regroup(db, i, db->quality[i], -1);
+    db->ranked--;
+}
+
+// Opens a slot at pos for channel, keeping the rank pointing to the shifted stations
+static void tea5767_stations_insert(TEA5767_stations_t *db, int pos, uint16_t channel) {
+    tea5767_stations_move(db, pos + 1, pos, db->count - pos);
+    db->count++;
+    for (int r = 0; r < db->ranked; r++) {
+        if (db->rank[r] >= pos) {
+            db->rank[r]++;
+        }
+    }
+    db->channel[pos] = channel;
+}
+
+// Closes the slot of a station out of the rank
+static void tea5767_stations_erase(TEA5767_stations_t *db, int i) {
+    tea5767_stations_move(db, i, i + 1, db->count - i - 1);
+    db->count--;
+    for (int r = 0; r < db->ranked; r++) {
+        if (db->rank[r] > i) {
+            db->rank[r]--;
+        }
+    }
+}
+
+// Stores level and flags and keeps the rank in step with the removed flag and the quality
+static void tea5767_stations_set(TEA5767_stations_t *db, int i, bool fresh, uint8_t level, uint8_t flags) {
+    bool was_ranked = !fresh && !(db->flags[i] & TEA5767_STATION_REMOVED);
+    bool ranked = !(flags & TEA5767_STATION_REMOVED);
+    int from = was_ranked ? db->quality[i] : -1;
+
+    if (!was_ranked && ranked) {
+        tea5767_stations_place(db, db->ranked++, i);
+    }
+    db->level[i] = level;
+    db->flags[i] = flags;
+    db->quality[i] = TEA5767_STATION_QUALITY(level, flags);
+    tea5767_stations_regroup(db, i, from, ranked ? db->quality[i] : -1);
+    if (was_ranked && !ranked) {
+        db->ranked--;
+    }
+}
+
+static size_t tea5767_stations_encode(const TEA5767_stations_t *db, uint8_t type, uint32_t since,
+                                      uint8_t *buf, size_t len) {
+    size_t pos = TEA5767_SYNC_HEADER;
+    uint8_t entries = 0;
+
+    if (len < TEA5767_SYNC_HEADER) {
+        return 0;
+    }
+    for (int i = 0; i < db->count; i++) {
+        if (type == TEA5767_SYNC_FULL ? (db->flags[i] & TEA5767_STATION_REMOVED) : db->changed[i] <= since) {
+            continue;
+        }
+        if (pos + TEA5767_SYNC_ENTRY > len) {
+            return 0;
+        }
+        buf[pos++] = db->channel[i];
+        buf[pos++] = db->channel[i] >> 8;
+        buf[pos++] = db->level[i];
+        buf[pos++] = db->flags[i];
+        entries++;
+    }
+
+    buf[0] = type;
+    put_u32(&buf[1], type == TEA5767_SYNC_FULL ? 0 : since);
+    put_u32(&buf[5], db->version);
+    buf[9] = entries;
+    return pos;
+}
+
+/************************************
+ * GLOBAL FUNCTIONS
+ ************************************/
+void tea5767_stations_init(TEA5767_stations_t *db) {
+    db->version = 0;
+    db->floor = 0;
+    db->updates = 0;
+    db->count = 0;
+    db->ranked = 0;
+    memset(db->tail, 0, sizeof(db->tail));
+}
+
+uint16_t tea5767_stations_channel(float freq) {
+    return (uint16_t)(freq * 100 + 0.5);
+}
+
+int tea5767_stations_find(const TEA5767_stations_t *db, uint16_t channel) {
+    int i = tea5767_stations_search(db, channel, NULL);
+    if (i >= 0 && (db->flags[i] & TEA5767_STATION_REMOVED)) {
+        return -1;
+    }
+    return i;
+}
+
+bool tea5767_stations_get(const TEA5767_stations_t *db, uint16_t channel, TEA5767_station_t *station) {
+    int i = tea5767_stations_find(db, channel);
+    if (i < 0) {
+        return false;
+    }
+    station->channel = db->channel[i];
+    station->level = db->level[i];
+    station->flags = db->flags[i];
+    station->quality = db->quality[i];
+    station->seen = db->seen[i];
+    station->version = db->changed[i];
+    return true;
+}
+
+int tea5767_stations_rank(const TEA5767_stations_t *db, uint8_t n) {
+    return n < db->ranked ? db->rank[n] : -1;
+}
+
+bool tea5767_stations_update(TEA5767_stations_t *db, uint16_t channel, uint8_t level, uint8_t flags) {
+    int pos;
+    int i = tea5767_stations_search(db, channel, &pos);
+    bool fresh = i < 0;
+    flags &= ~TEA5767_STATION_REMOVED;
+    if (level > TEA5767_STATION_LEVEL_MAX) {
+        return false;
+    }
+    db->updates++;
+
+    if (fresh) {
+        if (db->count == TEA5767_STATIONS_MAX) {
+            // Recycle the oldest removed station. Receivers older than it can no longer get a delta.
+            int oldest = -1;
+            for (int j = 0; j < db->count; j++) {
+                if ((db->flags[j] & TEA5767_STATION_REMOVED)
+                        && (oldest < 0 || db->changed[j] < db->changed[oldest])) {
+                    oldest = j;
+                }
+            }
+            if (oldest < 0) {
+                return false;
+            }
+            db->floor = db->changed[oldest];
+            tea5767_stations_erase(db, oldest);
+            if (oldest < pos) {
+                pos--;
+            }
+        }
+        tea5767_stations_insert(db, pos, channel);
+        i = pos;
+    } else if (db->level[i] == level && db->flags[i] == flags) {
+        db->seen[i] = db->updates;
+        return true;
+    }
+
+    tea5767_stations_set(db, i, fresh, level, flags);
+    db->seen[i] = db->updates;
+    db->changed[i] = ++db->version;
+    return true;
+}
+
+bool tea5767_stations_remove(TEA5767_stations_t *db, uint16_t channel) {
+    int i = tea5767_stations_find(db, channel);
+    if (i < 0) {
+        return false;
+    }
+    tea5767_stations_set(db, i, false, db->level[i], db->flags[i] | TEA5767_STATION_REMOVED);
+    db->changed[i] = ++db->version;
+    return true;
+}
+
+size_t tea5767_stations_delta(const TEA5767_stations_t *db, uint32_t since, uint8_t *buf, size_t len) {
+    if (since < db->floor || since > db->version) {
+        return tea5767_stations_full(db, buf, len);
+    }
+    return tea5767_stations_encode(db, TEA5767_SYNC_DELTA, since, buf, len);
+}
+
+size_t tea5767_stations_full(const TEA5767_stations_t *db, uint8_t *buf, size_t len) {
+    return tea5767_stations_encode(db, TEA5767_SYNC_FULL, 0, buf, len);
+}
+
+bool tea5767_stations_apply(TEA5767_stations_t *db, const uint8_t *buf, size_t len) {
+    if (len < TEA5767_SYNC_HEADER || len != TEA5767_SYNC_HEADER + (size_t)buf[9] * TEA5767_SYNC_ENTRY) {
+        return false;
+    }
+    // Messages come from the wire, a level out of range would index past the quality groups
+    for (const uint8_t *entry = &buf[TEA5767_SYNC_HEADER]; entry < buf + len; entry += TEA5767_SYNC_ENTRY) {
+        if (entry[2] > TEA5767_STATION_LEVEL_MAX) {
+            return false;
+        }
+    }
+
+    uint8_t type = buf[0];
+    uint32_t from = get_u32(&buf[1]);
+    if (type == TEA5767_SYNC_FULL) {
+        db->count = 0;
+        db->ranked = 0;
+        memset(db->tail, 0, sizeof(db->tail));
+    } else if (type != TEA5767_SYNC_DELTA || from != db->version) {
+        return false;
+    }
+
+    // The version only moves once every entry is in, a receiver left half way must not accept the next delta
+    uint32_t to = get_u32(&buf[5]);
+    for (const uint8_t *entry = &buf[TEA5767_SYNC_HEADER]; entry < buf + len; entry += TEA5767_SYNC_ENTRY) {
+        uint16_t channel = entry[0] | entry[1] << 8;
+        int pos;
+        int i = tea5767_stations_search(db, channel, &pos);
+        bool fresh = i < 0;
+
+        if (entry[3] & TEA5767_STATION_REMOVED) {
+            // The receiver has no one to sync to, removed stations are simply dropped
+            if (!fresh) {
+                tea5767_stations_rank_drop(db, i);
+                tea5767_stations_erase(db, i);
+            }
+            continue;
+        }
+        if (fresh) {
+            if (db->count >= TEA5767_STATIONS_MAX) {
+                tea5767_stations_init(db);
+                return false;
+            }
+            tea5767_stations_insert(db, pos, channel);
+            i = pos;
+        }
+        tea5767_stations_set(db, i, fresh, entry[2], entry[3]);
+        db->seen[i] = db->updates;
+        db->changed[i] = to;
+    }
+    db->version = to;
+    db->floor = 0;
+    return true;
+}
+
+size_t tea5767_stations_save(const TEA5767_stations_t *db, uint8_t *buf, size_t len) {
+    return tea5767_stations_full(db, buf, len);
+}
+
+bool tea5767_stations_load(TEA5767_stations_t *db, const uint8_t *buf, size_t len) {
+    if (len < TEA5767_SYNC_HEADER || buf[0] != TEA5767_SYNC_FULL) {
+        return false;
+    }
+    tea5767_stations_init(db);
+    if (!tea5767_stations_apply(db, buf, len)) {
+        tea5767_stations_init(db);
+        return false;
+    }
+    // Removed stations were not saved, a delta from before the save would miss them
+    db->floor = db->version;
+    return true;
+}
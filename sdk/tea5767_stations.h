@@ -0,0 +1,176 @@
+/**
+ ********************************************************************************
+ * @file    tea5767_stations.h
+ * @author  Carlos Egea
+ * @date    18/10/2026
+ * @brief   Versioned station database with delta synchronisation.
+ ********************************************************************************
+ */
+
+#ifndef _HARDWARE_TEA5767_STATIONS_H
+#define _HARDWARE_TEA5767_STATIONS_H
+
+/************************************
+ * INCLUDES
+ ************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/************************************
+ * MACROS AND DEFINES
+ ************************************/
+#ifndef TEA5767_STATIONS_MAX
+#define TEA5767_STATIONS_MAX 64 // Capacity of the station database, up to 255
+#endif
+#define TEA5767_STATION_STEREO 0x01 // Station flag: received in stereo
+#define TEA5767_STATION_REMOVED 0x80 // Station flag: removed, kept to be synchronised
+#define TEA5767_SYNC_DELTA 0x01 // Sync message type: changes since a version
+#define TEA5767_SYNC_FULL 0x02 // Sync message type: complete list, replaces the receiver content
+#define TEA5767_SYNC_HEADER 10 // Sync message header size in bytes
+#define TEA5767_SYNC_ENTRY 4 // Sync message entry size in bytes
+#define TEA5767_STATION_QUALITY(level, flags) ((level) << 1 | ((flags) & TEA5767_STATION_STEREO)) // Level first, stereo breaks ties
+#define TEA5767_STATION_QUALITIES 32 // Distinct quality values
+#define TEA5767_STATION_LEVEL_MAX 15 // Highest ADC level, larger ones would index past the quality groups
+
+/************************************
+ * TYPEDEFS
+ ************************************/
+/*! @brief A station of the database, as copied out by tea5767_stations_get()
+*/
+typedef struct {
+uint16_t channel;               // Frequency in units of 10 kHz, 10270 for 102.7 MHz
+uint8_t level;                  // Last ADC level, 0 to 15
+uint8_t flags;                  // TEA5767_STATION_* flags
+uint8_t quality;                // Ranking key, see \ref TEA5767_STATION_QUALITY
+uint32_t seen;                  // Update count when the station was last reported
+uint32_t version;               // Database version of the last change
+} TEA5767_station_t;
+
+/*! @brief Station database. Every change bumps the version and stamps the station with it,
+* so the changes since any version can be listed.
+* Stations are stored column by column and sorted by channel, so a lookup is a binary search
+* over the channel column only. Removed stations stay in the columns until recycled.
+* rank lists the stations not removed from best to worst quality, grouped by quality value. tail bounds the groups,
+* so a quality change moves a station one group at a time by swapping it with a group end.
+*/
+typedef struct {
+uint32_t version;               // Current version, 0 when empty
+uint32_t floor;                 // Deltas from versions older than this are incomplete
+uint32_t updates;               // Update calls so far, the clock of seen
+uint8_t count;                  // Used entries, removed ones included
+uint8_t ranked;                 // Entries of rank, stations not removed
+uint16_t channel[TEA5767_STATIONS_MAX]; // Channels, ascending
+uint8_t level[TEA5767_STATIONS_MAX];    // Last ADC level, 0 to 15
+uint8_t flags[TEA5767_STATIONS_MAX];    // TEA5767_STATION_* flags
+uint8_t quality[TEA5767_STATIONS_MAX];  // Ranking key, see TEA5767_STATION_QUALITY
+uint32_t seen[TEA5767_STATIONS_MAX];    // Value of updates when last reported
+uint32_t changed[TEA5767_STATIONS_MAX]; // Database version of the last change
+uint8_t rank[TEA5767_STATIONS_MAX];     // Station indices, best quality first
+uint8_t rank_pos[TEA5767_STATIONS_MAX]; // Position of each station in rank
+uint8_t tail[TEA5767_STATION_QUALITIES + 1]; // Ranked stations of quality at least the index
+} TEA5767_stations_t;
+
+/************************************
+ * GLOBAL FUNCTION PROTOTYPES
+ ************************************/
+
+/*! @brief Initializes an empty database.
+* @param db Database to initialize.
+*/
+void tea5767_stations_init(TEA5767_stations_t *db);
+
+/*! @brief Converts a frequency in MHz to a database channel.
+* @param freq Frequency in MHz.
+* @return uint16_t Channel in units of 10 kHz.
+*/
+uint16_t tea5767_stations_channel(float freq);
+
+/*! @brief Looks a station up, by binary search.
+* @param db Database.
+* @param channel Channel of the station.
+* @return int Index of the station in the columns, or -1 if it is not in the database or was removed.
+*/
+int tea5767_stations_find(const TEA5767_stations_t *db, uint16_t channel);
+
+/*! @brief Copies a station out of the columns.
+* @param db Database.
+* @param channel Channel of the station.
+* @param station Filled with the station.
+* @return bool false if it is not in the database or was removed.
+*/
+bool tea5767_stations_get(const TEA5767_stations_t *db, uint16_t channel, TEA5767_station_t *station);
+
+/*! @brief Returns the n-th best station.
+* @param db Database.
+* @param n Position in the ranking, 0 for the best.
+* @return int Index of the station in the columns, or -1 if n is past the last station.
+*/
+int tea5767_stations_rank(const TEA5767_stations_t *db, uint8_t n);
+
+/*! @brief Inserts a station or updates it. The version only changes if something did.
+* When the database is full the oldest removed station is recycled. The ranking is not re-sorted, the station
+* is moved by one swap per quality step.
+* @param db Database.
+* @param channel Channel of the station.
+* @param level ADC level, 0 to \ref TEA5767_STATION_LEVEL_MAX.
+* @param flags TEA5767_STATION_* flags.
+* @return bool false if the database is full or level is out of range.
+*/
+bool tea5767_stations_update(TEA5767_stations_t *db, uint16_t channel, uint8_t level, uint8_t flags);
+
+/*! @brief Removes a station. It is kept as removed so the removal reaches the host.
+* @param db Database.
+* @param channel Channel of the station.
+* @return bool false if the station was not in the database.
+*/
+bool tea5767_stations_remove(TEA5767_stations_t *db, uint16_t channel);
+
+/*! @brief Builds a sync message with the changes made after a version.
+* A full dump is built instead when since is older than what the database still tracks.
+* Message: type (1), from version (4), to version (4), entry count (1), then per entry
+* channel (2), level (1), flags (1). Multi-byte fields are little endian.
+* @param db Database.
+* @param since Version the receiver has.
+* @param buf Output buffer.
+* @param len Size of buf.
+* @return size_t Bytes written, 0 if buf is too small.
+*/
+size_t tea5767_stations_delta(const TEA5767_stations_t *db, uint32_t since, uint8_t *buf, size_t len);
+
+/*! @brief Builds a sync message with the full station list.
+* @param db Database.
+* @param buf Output buffer.
+* @param len Size of buf.
+* @return size_t Bytes written, 0 if buf is too small.
+*/
+size_t tea5767_stations_full(const TEA5767_stations_t *db, uint8_t *buf, size_t len);
+
+/*! @brief Applies a sync message to a receiver side copy of the database.
+* @param db Receiver database.
+* @param buf Message built by tea5767_stations_delta() or tea5767_stations_full().
+* @param len Size of the message.
+* @return bool false if the message is malformed, a level out of range included, or is a delta from another version than db->version,
+* db is then unchanged. Also false if the stations do not fit, db is then emptied back to version 0.
+* A full dump should be requested in both cases.
+*/
+bool tea5767_stations_apply(TEA5767_stations_t *db, const uint8_t *buf, size_t len);
+
+/*! @brief Serialises the database for persistence, in flash for instance. The format is the full sync message.
+* @param db Database.
+* @param buf Output buffer.
+* @param len Size of buf.
+* @return size_t Bytes written, 0 if buf is too small.
+*/
+size_t tea5767_stations_save(const TEA5767_stations_t *db, uint8_t *buf, size_t len);
+
+/*! @brief Restores a database saved by tea5767_stations_save(). Removed stations are not saved, so
+* receivers synchronised before the save get a full dump on their next delta request.
+* @param db Database.
+* @param buf Saved data.
+* @param len Size of the data.
+* @return bool false if the data is malformed.
+*/
+bool tea5767_stations_load(TEA5767_stations_t *db, const uint8_t *buf, size_t len);
+
+#endif
@@ -0,0 +1,212 @@
+/**
+ ********************************************************************************
+ * @file    tea5767_stats.c
+ * @author  Carlos Egea
+ * @date    18/10/2026
+ * @brief   Fixed memory level statistics per station.
+ ********************************************************************************
+ */
+
+/************************************
+ * INCLUDES
+ ************************************/
+#include <string.h>
+#include "tea5767_stats.h"
+
+/************************************
+ * STATIC FUNCTIONS
+ ************************************/
+static void rollup_close(TEA5767_rollups_t *rollups, uint8_t index) {
+    TEA5767_rollup_t *rollup = &rollups->open[index];
+
+    if (rollups->cb) {
+        rollups->cb(rollup, rollups->user);
+    }
+    // Move the last open interval into the hole
+    uint8_t last = --rollups->count;
+    rollups->slot[(rollup->channel - TEA5767_STATS_FIRST_CHANNEL) / 10] = 0;
+    if (index != last) {
+        *rollup = rollups->open[last];
+        rollups->slot[(rollup->channel - TEA5767_STATS_FIRST_CHANNEL) / 10] = index + 1;
+    }
+}
+
+// Closes the intervals before the given one, and records the earliest of those left
+static void rollup_expire(TEA5767_rollups_t *rollups, uint32_t interval) {
+    uint32_t oldest = UINT32_MAX;
+
+    // Backwards, closing moves the last open interval into the hole and that one was already checked
+    for (uint8_t i = rollups->count; i-- > 0;) {
+        if (rollups->open[i].interval < interval) {
+            rollup_close(rollups, i);
+        } else if (rollups->open[i].interval < oldest) {
+            oldest = rollups->open[i].interval;
+        }
+    }
+    rollups->oldest = oldest;
+}
+
+// Returns the open interval of a channel, closing it first if it is not the given one
+static TEA5767_rollup_t *rollup_get(TEA5767_rollups_t *rollups, uint16_t channel, uint32_t interval) {
+    if (channel < TEA5767_STATS_FIRST_CHANNEL) {
+        return NULL;
+    }
+    uint16_t index = (channel - TEA5767_STATS_FIRST_CHANNEL) / 10;
+    if (index >= TEA5767_STATS_CHANNELS) {
+        return NULL;
+    }
+
+    if (rollups->slot[index]) {
+        TEA5767_rollup_t *rollup = &rollups->open[rollups->slot[index] - 1];
+        if (rollup->interval == interval) {
+            return rollup;
+        }
+        rollup_close(rollups, rollups->slot[index] - 1);
+    }
+    if (rollups->count >= TEA5767_ROLLUP_STATIONS) {
+        return NULL;
+    }
+
+    TEA5767_rollup_t *rollup = &rollups->open[rollups->count++];
+    rollups->slot[index] = rollups->count;
+    rollup->channel = channel;
+    rollup->interval = interval;
+    if (interval < rollups->oldest) {
+        rollups->oldest = interval;
+    }
+    rollup->min = 0xff;
+    rollup->max = 0;
+    rollup->samples = 0;
+    rollup->sum = 0;
+    rollup->stereo = 0;
+    return rollup;
+}
+
+static void sketch_halve(TEA5767_sketch_t *sketch) {
+    for (int i = 0; i < TEA5767_LEVELS; i++) {
+        sketch->counts[i] >>= 1;
+    }
+    sketch->invalid >>= 1;
+}
+
+/************************************
+ * GLOBAL FUNCTIONS
+ ************************************/
+void tea5767_rollup_init(TEA5767_rollups_t *rollups, uint64_t interval_us, TEA5767_rollup_cb cb, void *user) {
+    memset(rollups, 0, sizeof(*rollups));
+    rollups->interval_us = interval_us;
+    rollups->cb = cb;
+    rollups->user = user;
+    rollups->oldest = UINT32_MAX;
+}
+
+bool tea5767_rollup_add(TEA5767_rollups_t *rollups, uint16_t channel, uint64_t time_us, uint8_t level, bool stereo) {
+    uint32_t interval = time_us / rollups->interval_us;
+    if (interval > rollups->oldest) {
+        rollup_expire(rollups, interval);
+    }
+    TEA5767_rollup_t *rollup = rollup_get(rollups, channel, interval);
+    if (rollup == NULL) {
+        return false;
+    }
+    if (level < rollup->min) {
+        rollup->min = level;
+    }
+    if (level > rollup->max) {
+        rollup->max = level;
+    }
+    rollup->samples++;
+    rollup->sum += level;
+    rollup->stereo += stereo;
+    return true;
+}
+
+bool tea5767_rollup_merge(TEA5767_rollups_t *rollups, const TEA5767_rollup_t *finer, uint64_t finer_interval_us) {
+    uint32_t interval = (uint64_t)finer->interval * finer_interval_us / rollups->interval_us;
+    TEA5767_rollup_t *rollup = rollup_get(rollups, finer->channel, interval);
+    if (rollup == NULL) {
+        return false;
+    }
+    if (finer->min < rollup->min) {
+        rollup->min = finer->min;
+    }
+    if (finer->max > rollup->max) {
+        rollup->max = finer->max;
+    }
+    rollup->samples += finer->samples;
+    rollup->sum += finer->sum;
+    rollup->stereo += finer->stereo;
+    return true;
+}
+
+void tea5767_rollup_tick(TEA5767_rollups_t *rollups, uint64_t now_us) {
+    rollup_expire(rollups, now_us / rollups->interval_us);
+}
+
+void tea5767_rollup_flush(TEA5767_rollups_t *rollups) {
+    while (rollups->count) {
+        rollup_close(rollups, rollups->count - 1);
+    }
+    rollups->oldest = UINT32_MAX;
+}
+
+void tea5767_sketch_init(TEA5767_sketch_t *sketch, uint16_t channel) {
+    memset(sketch, 0, sizeof(*sketch));
+    sketch->channel = channel;
+}
+
+void tea5767_sketch_add(TEA5767_sketch_t *sketch, uint8_t level, bool if_valid) {
+    uint16_t *counter = if_valid ? &sketch->counts[level & (TEA5767_LEVELS - 1)] : &sketch->invalid;
+    if (*counter == UINT16_MAX) {
+        sketch_halve(sketch);
+    }
+    (*counter)++;
+}
+
+bool tea5767_sketch_merge(TEA5767_sketch_t *sketch, const TEA5767_sketch_t *other) {
+    if (other->channel != sketch->channel) {
+        return false;
+    }
+
+    // If any counter would overflow both sides are halved, keeping their relative weight
+    int shift = (uint32_t)sketch->invalid + other->invalid > UINT16_MAX;
+    for (int i = 0; i < TEA5767_LEVELS; i++) {
+        if ((uint32_t)sketch->counts[i] + other->counts[i] > UINT16_MAX) {
+            shift = 1;
+        }
+    }
+    if (shift) {
+        sketch_halve(sketch);
+    }
+
+    for (int i = 0; i < TEA5767_LEVELS; i++) {
+        sketch->counts[i] += other->counts[i] >> shift;
+    }
+    sketch->invalid += other->invalid >> shift;
+    return true;
+}
+
+uint8_t tea5767_sketch_percentile(const TEA5767_sketch_t *sketch, uint8_t percent) {
+    uint32_t total = tea5767_sketch_total(sketch);
+    if (total == 0) {
+        return 0;
+    }
+    // Smallest level whose cumulative count reaches percent of the total
+    uint32_t target = (total * percent + 99) / 100;
+    uint32_t cumulative = 0;
+    for (uint8_t level = 0; level < TEA5767_LEVELS; level++) {
+        cumulative += sketch->counts[level];
+        if (cumulative >= target) {
+            return level;
+        }
+    }
+    return TEA5767_LEVELS - 1;
+}
+
+uint32_t tea5767_sketch_total(const TEA5767_sketch_t *sketch) {
+    uint32_t total = 0;
+    for (int i = 0; i < TEA5767_LEVELS; i++) {
+        total += sketch->counts[i];
+    }
+    return total;
+}
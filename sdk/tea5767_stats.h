@@ -0,0 +1,150 @@
+/**
+ ********************************************************************************
+ * @file    tea5767_stats.h
+ * @author  Carlos Egea
+ * @date    18/10/2026
+ * @brief   Fixed memory level statistics per station.
+ ********************************************************************************
+ */
+
+#ifndef _HARDWARE_TEA5767_STATS_H
+#define _HARDWARE_TEA5767_STATS_H
+
+/************************************
+ * INCLUDES
+ ************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+/************************************
+ * MACROS AND DEFINES
+ ************************************/
+#define TEA5767_STATS_FIRST_CHANNEL 7600 // Lowest channel of either band, station database units
+#define TEA5767_STATS_CHANNELS 321 // 100 kHz channels from 76.0 to 108.0 MHz
+#define TEA5767_ROLLUP_STATIONS 16 // Stations aggregated at the same time by one rollup stage
+#define TEA5767_LEVELS 16 // Distinct ADC level values
+
+/************************************
+ * TYPEDEFS
+ ************************************/
+/*! @brief Aggregate of one station over one interval. The mean level is sum / samples and the
+* stereo ratio stereo / samples, kept as sums so that rollups can be merged exactly.
+*/
+typedef struct {
+uint16_t channel;               // Station, in station database units
+uint8_t min;                    // Lowest level
+uint8_t max;                    // Highest level
+uint32_t interval;              // Interval index, start time divided by the interval length
+uint32_t samples;               // Samples aggregated
+uint32_t sum;                   // Sum of the levels
+uint32_t stereo;                // Samples received in stereo
+} TEA5767_rollup_t;
+
+/*! @brief Called with every interval closed by a rollup stage
+*/
+typedef void (*TEA5767_rollup_cb)(const TEA5767_rollup_t *rollup, void *user);
+
+/*! @brief One rollup stage, aggregating samples or finer rollups into intervals of a fixed length.
+* Stages are chained by merging the output of one into the next, 1 s into 1 min into 1 h for instance.
+*/
+typedef struct {
+uint64_t interval_us;           // Interval length
+TEA5767_rollup_cb cb;           // Receives the closed intervals
+void *user;                     // Passed to cb
+uint8_t count;                  // Stations with an open interval
+uint32_t oldest;                // Earliest open interval index or lower, UINT32_MAX if none
+uint8_t slot[TEA5767_STATS_CHANNELS]; // Open interval of each channel, index + 1, 0 if none
+TEA5767_rollup_t open[TEA5767_ROLLUP_STATIONS];
+} TEA5767_rollups_t;
+
+/*! @brief Level distribution of one station, 36 bytes.
+* The ADC level only takes 16 values, so a histogram gives exact percentiles. When a counter would
+* overflow every counter is halved, which keeps the proportions and turns the sketch into a slowly
+* decaying one. Adding a sample is one increment; the halving costs 17 shifts once every 32768 or more samples.
+*/
+typedef struct {
+uint16_t channel;               // Station, in station database units
+uint16_t invalid;               // Samples with the IF counter out of range, not in counts
+uint16_t counts[TEA5767_LEVELS]; // Valid samples per level
+} TEA5767_sketch_t;
+
+/************************************
+ * GLOBAL FUNCTION PROTOTYPES
+ ************************************/
+
+/*! @brief Initializes a rollup stage.
+* @param rollups Stage to initialize.
+* @param interval_us Interval length in microseconds.
+* @param cb Receives the closed intervals.
+* @param user Passed to cb.
+*/
+void tea5767_rollup_init(TEA5767_rollups_t *rollups, uint64_t interval_us, TEA5767_rollup_cb cb, void *user);
+
+/*! @brief Adds a level sample. Constant time: one table lookup and a few additions.
+* The station's open interval is closed and handed to the callback first if the sample falls after it.
+* Samples are expected in time order: the first sample of a new interval also closes the intervals of
+* every other station that ended before it, at most \ref TEA5767_ROLLUP_STATIONS checks once per interval.
+* @param rollups Stage.
+* @param channel Station, in station database units.
+* @param time_us Time of the sample.
+* @param level ADC level of the sample.
+* @param stereo true if the sample was received in stereo.
+* @return bool false if the channel is outside the bands or \ref TEA5767_ROLLUP_STATIONS stations are open.
+*/
+bool tea5767_rollup_add(TEA5767_rollups_t *rollups, uint16_t channel, uint64_t time_us, uint8_t level, bool stereo);
+
+/*! @brief Adds a rollup closed by a stage with shorter intervals.
+* @param rollups Stage.
+* @param finer Rollup to merge.
+* @param finer_interval_us Interval length of the stage that produced it.
+* @return bool false if the channel is outside the bands or \ref TEA5767_ROLLUP_STATIONS stations are open.
+*/
+bool tea5767_rollup_merge(TEA5767_rollups_t *rollups, const TEA5767_rollup_t *finer, uint64_t finer_interval_us);
+
+/*! @brief Closes the intervals that ended at or before a time and hands them to the callback.
+* Call it periodically, so that stations that stopped reporting are closed without waiting for a sample.
+* Stages fed by tea5767_rollup_merge() are only closed this way or by tea5767_rollup_flush().
+* @param rollups Stage.
+* @param now_us Current time.
+*/
+void tea5767_rollup_tick(TEA5767_rollups_t *rollups, uint64_t now_us);
+
+/*! @brief Closes every open interval and hands it to the callback.
+* @param rollups Stage.
+*/
+void tea5767_rollup_flush(TEA5767_rollups_t *rollups);
+
+/*! @brief Initializes an empty sketch.
+* @param sketch Sketch to initialize.
+* @param channel Station, in station database units.
+*/
+void tea5767_sketch_init(TEA5767_sketch_t *sketch, uint16_t channel);
+
+/*! @brief Adds a level sample.
+* @param sketch Sketch.
+* @param level ADC level of the sample.
+* @param if_valid false if the IF counter was out of range, the level is then not counted.
+*/
+void tea5767_sketch_add(TEA5767_sketch_t *sketch, uint8_t level, bool if_valid);
+
+/*! @brief Adds the samples of another sketch of the same station, from another device for instance.
+* @param sketch Sketch updated.
+* @param other Sketch merged into it.
+* @return bool false if other is of another station, sketch is then unchanged.
+*/
+bool tea5767_sketch_merge(TEA5767_sketch_t *sketch, const TEA5767_sketch_t *other);
+
+/*! @brief Returns the level below which a given share of the valid samples falls.
+* @param sketch Sketch.
+* @param percent Percentile, 5, 50 and 95 for p5, p50 and p95.
+* @return uint8_t Level, 0 if the sketch holds no valid sample.
+*/
+uint8_t tea5767_sketch_percentile(const TEA5767_sketch_t *sketch, uint8_t percent);
+
+/*! @brief Returns the number of valid samples in the sketch.
+* @param sketch Sketch.
+* @return uint32_t Valid samples.
+*/
+uint32_t tea5767_sketch_total(const TEA5767_sketch_t *sketch);
+
+#endif
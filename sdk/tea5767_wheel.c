@@ -0,0 +1,156 @@
+/**
+ ********************************************************************************
+ * @file    tea5767_wheel.c
+ * @author  Carlos Egea
+ * @date    18/10/2026
+ * @brief   Hierarchical timer wheel scheduling polls and timeouts across many tuners.
+ ********************************************************************************
+ */
+
+/************************************
+ * INCLUDES
+ ************************************/
+#include "pico/time.h"
+#include "tea5767_wheel.h"
+
+/************************************
+ * STATIC FUNCTIONS
+ ************************************/
+static void wheel_link(TEA5767_link_t *head, TEA5767_link_t *link) {
+    link->prev = head->prev;
+    link->next = head;
+    head->prev->next = link;
+    head->prev = link;
+}
+
+static void wheel_unlink(TEA5767_link_t *link) {
+    link->prev->next = link->next;
+    link->next->prev = link->prev;
+    link->next = 0;
+    link->prev = 0;
+}
+
+// Moves every node of a list onto another, empty, list head
+static void wheel_splice(TEA5767_link_t *from, TEA5767_link_t *to) {
+    if (from->next == from) {
+        to->next = to->prev = to;
+        return;
+    }
+    to->next = from->next;
+    to->prev = from->prev;
+    to->next->prev = to;
+    to->prev->next = to;
+    from->next = from->prev = from;
+}
+
+// Slot for a timer, by how far ahead of the current tick it is due
+static void wheel_place(TEA5767_wheel_t *wheel, TEA5767_timer_t *timer) {
+    uint32_t delta = timer->expires - wheel->now;
+    uint8_t level = 0;
+
+    if ((int32_t)delta < 0) {
+        // Already due, fired on the next tick
+        timer->expires = wheel->now;
+        delta = 0;
+    }
+    while (level < TEA5767_WHEEL_LEVELS - 1 && delta >= 1u << (TEA5767_WHEEL_BITS * (level + 1))) {
+        level++;
+    }
+    uint8_t slot = (timer->expires >> (TEA5767_WHEEL_BITS * level)) & TEA5767_WHEEL_MASK;
+    wheel_link(&wheel->slots[level][slot], &timer->link);
+}
+
+// Moves the timers of one upper level slot down to the levels below. Returns the slot index.
+static uint8_t wheel_cascade(TEA5767_wheel_t *wheel, uint8_t level) {
+    uint8_t slot = (wheel->now >> (TEA5767_WHEEL_BITS * level)) & TEA5767_WHEEL_MASK;
+    TEA5767_link_t list;
+
+    wheel_splice(&wheel->slots[level][slot], &list);
+    while (list.next != &list) {
+        TEA5767_link_t *link = list.next;
+        wheel_unlink(link);
+        wheel_place(wheel, (TEA5767_timer_t *)link);
+        wheel->cascaded++;
+    }
+    return slot;
+}
+
+/************************************
+ * GLOBAL FUNCTIONS
+ ************************************/
+void tea5767_wheel_init(TEA5767_wheel_t *wheel, uint32_t now) {
+    wheel->now = now;
+    wheel->count = 0;
+    wheel->fired = 0;
+    wheel->cascaded = 0;
+    for (uint8_t level = 0; level < TEA5767_WHEEL_LEVELS; level++) {
+        for (uint8_t slot = 0; slot < TEA5767_WHEEL_SLOTS; slot++) {
+            wheel->slots[level][slot].next = &wheel->slots[level][slot];
+            wheel->slots[level][slot].prev = &wheel->slots[level][slot];
+        }
+    }
+}
+
+void tea5767_timer_init(TEA5767_timer_t *timer, TEA5767_timer_cb cb, void *user) {
+    timer->link.next = 0;
+    timer->link.prev = 0;
+    timer->expires = 0;
+    timer->cb = cb;
+    timer->user = user;
+}
+
+void tea5767_wheel_add(TEA5767_wheel_t *wheel, TEA5767_timer_t *timer, uint32_t delay) {
+    if (tea5767_timer_pending(timer)) {
+        wheel_unlink(&timer->link);
+    } else {
+        wheel->count++;
+    }
+    if (delay > TEA5767_WHEEL_MAX_DELAY) {
+        delay = TEA5767_WHEEL_MAX_DELAY;
+    }
+    timer->expires = wheel->now + delay;
+    wheel_place(wheel, timer);
+}
+
+void tea5767_wheel_cancel(TEA5767_wheel_t *wheel, TEA5767_timer_t *timer) {
+    if (tea5767_timer_pending(timer)) {
+        wheel_unlink(&timer->link);
+        wheel->count--;
+    }
+}
+
+uint32_t tea5767_wheel_advance(TEA5767_wheel_t *wheel, uint32_t now) {
+    uint32_t fired = 0;
+    TEA5767_link_t batch;
+
+    while ((int32_t)(now - wheel->now) >= 0) {
+        if (wheel->count == 0) {
+            wheel->now = now + 1;
+            break;
+        }
+        uint8_t slot = wheel->now & TEA5767_WHEEL_MASK;
+        // Entering a new lap of a level pulls the matching slot of the level above down
+        for (uint8_t level = 1; slot == 0 && level < TEA5767_WHEEL_LEVELS; level++) {
+            if (wheel_cascade(wheel, level) != 0) {
+                break;
+            }
+        }
+
+        // Callbacks may add or cancel timers, the batch is detached from the wheel first
+        wheel_splice(&wheel->slots[0][slot], &batch);
+        wheel->now++;
+        while (batch.next != &batch) {
+            TEA5767_timer_t *timer = (TEA5767_timer_t *)batch.next;
+            wheel_unlink(&timer->link);
+            wheel->count--;
+            fired++;
+            timer->cb(timer, timer->user);
+        }
+    }
+    wheel->fired += fired;
+    return fired;
+}
+
+uint32_t tea5767_wheel_poll(TEA5767_wheel_t *wheel) {
+    return tea5767_wheel_advance(wheel, time_us_64() / TEA5767_WHEEL_TICK_US);
+}
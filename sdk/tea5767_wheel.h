@@ -0,0 +1,118 @@
+/**
+ ********************************************************************************
+ * @file    tea5767_wheel.h
+ * @author  Carlos Egea
+ * @date    18/10/2026
+ * @brief   Hierarchical timer wheel scheduling polls and timeouts across many tuners.
+ ********************************************************************************
+ */
+
+#ifndef _HARDWARE_TEA5767_WHEEL_H
+#define _HARDWARE_TEA5767_WHEEL_H
+
+/************************************
+ * INCLUDES
+ ************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+/************************************
+ * MACROS AND DEFINES
+ ************************************/
+#define TEA5767_WHEEL_TICK_US 1000 // Tick length used by tea5767_wheel_poll()
+#define TEA5767_WHEEL_BITS 6 // Slots per level as a power of two
+#define TEA5767_WHEEL_SLOTS (1 << TEA5767_WHEEL_BITS)
+#define TEA5767_WHEEL_MASK (TEA5767_WHEEL_SLOTS - 1)
+#define TEA5767_WHEEL_LEVELS 4 // Levels, the wheel spans 2^24 ticks (4.6 hours at 1 ms)
+#define TEA5767_WHEEL_MAX_DELAY ((1u << (TEA5767_WHEEL_BITS * TEA5767_WHEEL_LEVELS)) - 1)
+
+/************************************
+ * TYPEDEFS
+ ************************************/
+/*! @brief Doubly linked list node, embedded in timers and used as slot head
+*/
+typedef struct TEA5767_link {
+struct TEA5767_link *next;
+struct TEA5767_link *prev;
+} TEA5767_link_t;
+
+struct TEA5767_timer;
+
+/*! @brief Called when a timer expires. The timer is no longer pending and may be added again from the callback.
+*/
+typedef void (*TEA5767_timer_cb)(struct TEA5767_timer *timer, void *user);
+
+/*! @brief Timer, embedded by the caller in its per-tuner state. The wheel allocates nothing.
+*/
+typedef struct TEA5767_timer {
+TEA5767_link_t link;            // Position in a slot, NULL while not pending. Must stay the first field.
+uint32_t expires;               // Tick the timer is due at
+TEA5767_timer_cb cb;            // Expiry callback
+void *user;                     // Passed to cb
+} TEA5767_timer_t;
+
+/*! @brief The wheel. Level n slots hold timers due within 2^(6(n+1)) ticks, moved down a level as time
+* comes near, so that adding and cancelling never depend on the number of timers.
+*/
+typedef struct {
+uint32_t now;                   // Current tick
+uint32_t count;                 // Pending timers
+uint32_t fired;                 // Callbacks run so far
+uint32_t cascaded;              // Timers moved down a level so far
+TEA5767_link_t slots[TEA5767_WHEEL_LEVELS][TEA5767_WHEEL_SLOTS];
+} TEA5767_wheel_t;
+
+/************************************
+ * GLOBAL FUNCTION PROTOTYPES
+ ************************************/
+
+/*! @brief Initializes an empty wheel.
+* @param wheel Wheel to initialize.
+* @param now Current tick.
+*/
+void tea5767_wheel_init(TEA5767_wheel_t *wheel, uint32_t now);
+
+/*! @brief Initializes a timer, not pending.
+* @param timer Timer to initialize.
+* @param cb Expiry callback.
+* @param user Passed to cb.
+*/
+void tea5767_timer_init(TEA5767_timer_t *timer, TEA5767_timer_cb cb, void *user);
+
+/*! @brief Tells whether a timer is waiting in a wheel.
+* @param timer Timer.
+* @return bool true if added and neither expired nor cancelled since.
+*/
+static inline bool tea5767_timer_pending(const TEA5767_timer_t *timer) {
+    return timer->link.next != 0;
+}
+
+/*! @brief Schedules a timer, moving it if it was already pending. Constant time.
+* @param wheel Wheel.
+* @param timer Timer.
+* @param delay Ticks from now, clamped to \ref TEA5767_WHEEL_MAX_DELAY. 0 fires on the next tick.
+*/
+void tea5767_wheel_add(TEA5767_wheel_t *wheel, TEA5767_timer_t *timer, uint32_t delay);
+
+/*! @brief Cancels a timer. Constant time, and harmless if the timer is not pending.
+* @param wheel Wheel.
+* @param timer Timer.
+*/
+void tea5767_wheel_cancel(TEA5767_wheel_t *wheel, TEA5767_timer_t *timer);
+
+/*! @brief Advances the wheel to a tick, firing the timers due on the way.
+* The timers due at a tick are detached from their slot in one go and fired as a batch.
+* An empty wheel jumps straight to the tick.
+* @param wheel Wheel.
+* @param now Tick to advance to. Ticks already past are ignored.
+* @return uint32_t Number of callbacks run.
+*/
+uint32_t tea5767_wheel_advance(TEA5767_wheel_t *wheel, uint32_t now);
+
+/*! @brief Advances the wheel to the current time, in \ref TEA5767_WHEEL_TICK_US ticks.
+* @param wheel Wheel.
+* @return uint32_t Number of callbacks run.
+*/
+uint32_t tea5767_wheel_poll(TEA5767_wheel_t *wheel);
+
+#endif
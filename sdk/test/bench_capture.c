@@ -0,0 +1,117 @@
+/**
+ ********************************************************************************
+ * @file    bench_capture.c
+ * @author  Carlos Egea
+ * @date    18/10/2026
+ * @brief   Host benchmark of de-interleaving a capture block. The rms and noise kernels run
+ *          over every channel of a 4 x 256 block in place, with the channel count as stride,
+ *          against copying the channels apart first and running them contiguous. Built like
+ *          the audio test, once vectorised where the host allows and once scalar as on the M0+.
+ ********************************************************************************
+ */
+
+/************************************
+ * INCLUDES
+ ************************************/
+#include <time.h>
+#include "tea5767_audio.h"
+#include "tea5767_capture.h"
+#include "test.h"
+
+/************************************
+ * PRIVATE MACROS AND DEFINES
+ ************************************/
+#define BENCH_CHANNELS TEA5767_CAPTURE_INPUTS
+#define BENCH_BLOCKS 20000
+
+/************************************
+ * STATIC VARIABLES
+ ************************************/
+static uint16_t block[TEA5767_CAPTURE_BLOCK * BENCH_CHANNELS];
+static uint16_t apart[BENCH_CHANNELS][TEA5767_CAPTURE_BLOCK];
+static volatile uint32_t sink; // Keeps the results alive
+
+/************************************
+ * STATIC FUNCTIONS
+ ************************************/
+static double elapsed_ns(const struct timespec *from, const struct timespec *to) {
+    return (to->tv_sec - from->tv_sec) * 1e9 + (to->tv_nsec - from->tv_nsec);
+}
+
+static uint32_t in_place(void) {
+    uint32_t sum = 0;
+
+    for (uint8_t c = 0; c < BENCH_CHANNELS; c++) {
+        sum += tea5767_audio_rms(block + c, TEA5767_CAPTURE_BLOCK, BENCH_CHANNELS);
+        sum += tea5767_audio_noise(block + c, TEA5767_CAPTURE_BLOCK, BENCH_CHANNELS);
+    }
+    return sum;
+}
+
+static void copy_apart(void) {
+    for (uint16_t i = 0; i < TEA5767_CAPTURE_BLOCK; i++) {
+        for (uint8_t c = 0; c < BENCH_CHANNELS; c++) {
+            apart[c][i] = block[i * BENCH_CHANNELS + c];
+        }
+    }
+}
+
+static uint32_t contiguous(void) {
+    uint32_t sum = 0;
+
+    for (uint8_t c = 0; c < BENCH_CHANNELS; c++) {
+        sum += tea5767_audio_rms(apart[c], TEA5767_CAPTURE_BLOCK, 1);
+        sum += tea5767_audio_noise(apart[c], TEA5767_CAPTURE_BLOCK, 1);
+    }
+    return sum;
+}
+
+/************************************
+ * GLOBAL FUNCTIONS
+ ************************************/
+int main() {
+    struct timespec from, to;
+    double place_ns, copy_ns, kernels_ns;
+
+    for (size_t i = 0; i < sizeof(block) / sizeof(block[0]); i++) {
+        block[i] = test_random() & 0xfff;
+    }
+
+    // Same figures either way, then the three timings per block
+    copy_apart();
+    TEST_CHECK(in_place() == contiguous());
+
+    clock_gettime(CLOCK_MONOTONIC, &from);
+    for (uint32_t n = 0; n < BENCH_BLOCKS; n++) {
+        block[n % TEA5767_CAPTURE_BLOCK] ^= 1;
+        sink += in_place();
+    }
+    clock_gettime(CLOCK_MONOTONIC, &to);
+    place_ns = elapsed_ns(&from, &to) / BENCH_BLOCKS;
+
+    clock_gettime(CLOCK_MONOTONIC, &from);
+    for (uint32_t n = 0; n < BENCH_BLOCKS; n++) {
+        block[n % TEA5767_CAPTURE_BLOCK] ^= 1;
+        copy_apart();
+        sink += apart[0][n % TEA5767_CAPTURE_BLOCK];
+    }
+    clock_gettime(CLOCK_MONOTONIC, &to);
+    copy_ns = elapsed_ns(&from, &to) / BENCH_BLOCKS;
+
+    clock_gettime(CLOCK_MONOTONIC, &from);
+    for (uint32_t n = 0; n < BENCH_BLOCKS; n++) {
+        apart[n % BENCH_CHANNELS][n % TEA5767_CAPTURE_BLOCK] ^= 1;
+        sink += contiguous();
+    }
+    clock_gettime(CLOCK_MONOTONIC, &to);
+    kernels_ns = elapsed_ns(&from, &to) / BENCH_BLOCKS;
+
+#ifdef TEA5767_AUDIO_SCALAR
+    printf("capture %u x %u block, scalar build:\n", BENCH_CHANNELS, TEA5767_CAPTURE_BLOCK);
+#else
+    printf("capture %u x %u block, default build:\n", BENCH_CHANNELS, TEA5767_CAPTURE_BLOCK);
+#endif
+    printf("%14s %14s %14s %14s\n", "in place ns", "copy apart ns", "kernels ns", "copy+kernels");
+    printf("%14.0f %14.0f %14.0f %14.0f\n", place_ns, copy_ns, kernels_ns, copy_ns + kernels_ns);
+    return TEST_RESULT();
+}
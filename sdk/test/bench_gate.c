@@ -0,0 +1,87 @@
+/**
+ ********************************************************************************
+ * @file    bench_gate.c
+ * @author  Carlos Egea
+ * @date    18/10/2026
+ * @brief   Host benchmark of the spectral noise gate. The cost of a frame, one hop of
+ *          samples, engaged on noise and disengaged once it has gone transparent, printed
+ *          with the share of a hop at 16 kHz it takes. Built at the default and largest frame.
+ ********************************************************************************
+ */
+
+/************************************
+ * INCLUDES
+ ************************************/
+#include <time.h>
+#include "tea5767_audio.h"
+#include "test.h"
+
+/************************************
+ * PRIVATE MACROS AND DEFINES
+ ************************************/
+#define BENCH_RATE 16000
+#define BENCH_HOPS 200000
+
+/************************************
+ * STATIC VARIABLES
+ ************************************/
+static TEA5767_gate_t gate;
+static int16_t block[TEA5767_GATE_HOP];
+static volatile int32_t sink; // Keeps the results alive
+
+/************************************
+ * STATIC FUNCTIONS
+ ************************************/
+static double elapsed_ns(const struct timespec *from, const struct timespec *to) {
+    return (to->tv_sec - from->tv_sec) * 1e9 + (to->tv_nsec - from->tv_nsec);
+}
+
+// Average cost of one hop of random input
+static double bench_gate(uint8_t level) {
+    struct timespec from, to;
+
+    tea5767_audio_gateInit(&gate, 0.1f, 4);
+    tea5767_audio_gateLevel(&gate, level);
+    clock_gettime(CLOCK_MONOTONIC, &from);
+    for (uint32_t n = 0; n < BENCH_HOPS; n++) {
+        for (uint16_t i = 0; i < TEA5767_GATE_HOP; i++) {
+            block[i] = (int16_t)test_random() >> 4;
+        }
+        tea5767_audio_gate(&gate, block, TEA5767_GATE_HOP, 1);
+        sink += block[n % TEA5767_GATE_HOP];
+    }
+    clock_gettime(CLOCK_MONOTONIC, &to);
+    return elapsed_ns(&from, &to) / BENCH_HOPS;
+}
+
+/************************************
+ * GLOBAL FUNCTIONS
+ ************************************/
+int main() {
+    double hop_ns = 1e9 * TEA5767_GATE_HOP / BENCH_RATE;
+    double fill_ns, engaged_ns, transparent_ns;
+    struct timespec from, to;
+
+    // The input alone, to take it off both figures
+    clock_gettime(CLOCK_MONOTONIC, &from);
+    for (uint32_t n = 0; n < BENCH_HOPS; n++) {
+        for (uint16_t i = 0; i < TEA5767_GATE_HOP; i++) {
+            block[i] = (int16_t)test_random() >> 4;
+        }
+        sink += block[n % TEA5767_GATE_HOP];
+    }
+    clock_gettime(CLOCK_MONOTONIC, &to);
+    fill_ns = elapsed_ns(&from, &to) / BENCH_HOPS;
+
+    engaged_ns = bench_gate(0) - fill_ns;
+    TEST_CHECK(gate.frames == BENCH_HOPS);
+    transparent_ns = bench_gate(TEA5767_GATE_LEVEL) - fill_ns;
+    TEST_CHECK(gate.transparent);
+
+    printf("gate %u points, hop of %u samples (%.0f us at %u Hz):\n", TEA5767_GATE_FFT, TEA5767_GATE_HOP,
+           hop_ns / 1000, BENCH_RATE);
+    printf("%14s %14s %14s\n", "", "ns per hop", "% of the hop");
+    printf("%14s %14.0f %14.3f\n", "engaged", engaged_ns, 100 * engaged_ns / hop_ns);
+    printf("%14s %14.0f %14.3f\n", "transparent", transparent_ns, 100 * transparent_ns / hop_ns);
+    return TEST_RESULT();
+}
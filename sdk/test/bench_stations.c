@@ -0,0 +1,312 @@
+/**
+ ********************************************************************************
+ * @file    bench_stations.c
+ * @author  Carlos Egea
+ * @date    18/10/2026
+ * @brief   Host benchmark of the station database against the table it replaced, an
+ *          unsorted array of station records searched linearly and ranked by insertion
+ *          sort at every scan. A replay of random updates and removes first checks that
+ *          both hold the same stations, then lookup, update and rank are timed at 200.
+ ********************************************************************************
+ */
+
+/************************************
+ * INCLUDES
+ ************************************/
+#include <string.h>
+#include <time.h>
+#include "tea5767_stations.h"
+#include "test.h"
+
+/************************************
+ * PRIVATE MACROS AND DEFINES
+ ************************************/
+#define BENCH_STATIONS 200
+#define BENCH_CHANNELS 260 // Channels the replay draws from, more than the database holds
+#define BENCH_FIRST_CHANNEL 8750
+#define BENCH_REPLAY 200000
+#define BENCH_CALLS 1000000
+#define BENCH_RANKS 20000
+
+#if TEA5767_STATIONS_MAX < BENCH_STATIONS
+#error "Build with TEA5767_STATIONS_MAX of at least 200"
+#endif
+
+/************************************
+ * PRIVATE TYPEDEFS
+ ************************************/
+// The previous table, as it was before the columns
+typedef struct {
+uint16_t channel;
+uint8_t level;
+uint8_t flags;
+uint32_t version;
+} linear_station_t;
+
+typedef struct {
+uint32_t version;
+uint32_t floor;
+uint8_t count;
+linear_station_t stations[TEA5767_STATIONS_MAX];
+} linear_t;
+
+/************************************
+ * STATIC VARIABLES
+ ************************************/
+static TEA5767_stations_t db;
+static linear_t linear;
+static uint16_t channels[4096]; // Random lookups drawn ahead of the timing, a power of two
+static volatile uint32_t sink; // Keeps the results alive
+
+/************************************
+ * STATIC FUNCTIONS
+ ************************************/
+static double elapsed_ns(const struct timespec *from, const struct timespec *to) {
+    return (to->tv_sec - from->tv_sec) * 1e9 + (to->tv_nsec - from->tv_nsec);
+}
+
+static uint16_t channel_of(int c) {
+    return BENCH_FIRST_CHANNEL + c * 10;
+}
+
+static linear_station_t *linear_slot(linear_t *table, uint16_t channel) {
+    for (int i = 0; i < table->count; i++) {
+        if (table->stations[i].channel == channel) {
+            return &table->stations[i];
+        }
+    }
+    return NULL;
+}
+
+static linear_station_t *linear_find(linear_t *table, uint16_t channel) {
+    linear_station_t *station = linear_slot(table, channel);
+    if (station && (station->flags & TEA5767_STATION_REMOVED)) {
+        return NULL;
+    }
+    return station;
+}
+
+static bool linear_update(linear_t *table, uint16_t channel, uint8_t level, uint8_t flags) {
+    linear_station_t *station = linear_slot(table, channel);
+    flags &= ~TEA5767_STATION_REMOVED;
+
+    if (station == NULL) {
+        if (table->count < TEA5767_STATIONS_MAX) {
+            station = &table->stations[table->count++];
+        } else {
+            for (int i = 0; i < table->count; i++) {
+                linear_station_t *candidate = &table->stations[i];
+                if ((candidate->flags & TEA5767_STATION_REMOVED)
+                        && (station == NULL || candidate->version < station->version)) {
+                    station = candidate;
+                }
+            }
+            if (station == NULL) {
+                return false;
+            }
+            table->floor = station->version;
+        }
+        station->channel = channel;
+    } else if (station->level == level && station->flags == flags) {
+        return true;
+    }
+
+    station->level = level;
+    station->flags = flags;
+    station->version = ++table->version;
+    return true;
+}
+
+static bool linear_remove(linear_t *table, uint16_t channel) {
+    linear_station_t *station = linear_find(table, channel);
+    if (station == NULL) {
+        return false;
+    }
+    station->flags |= TEA5767_STATION_REMOVED;
+    station->version = ++table->version;
+    return true;
+}
+
+// What the scan did with it: live stations by descending level, insertion sorted
+static uint8_t linear_rank(const linear_t *table, uint16_t *out) {
+    uint8_t order[TEA5767_STATIONS_MAX];
+    uint8_t known = 0;
+
+    for (uint8_t i = 0; i < table->count; i++) {
+        if (table->stations[i].flags & TEA5767_STATION_REMOVED) {
+            continue;
+        }
+        uint8_t j = known++;
+        while (j > 0 && table->stations[order[j - 1]].level < table->stations[i].level) {
+            order[j] = order[j - 1];
+            j--;
+        }
+        order[j] = i;
+    }
+    for (uint8_t i = 0; i < known; i++) {
+        out[i] = table->stations[order[i]].channel;
+    }
+    return known;
+}
+
+static uint8_t columns_rank(const TEA5767_stations_t *d, uint16_t *out) {
+    for (uint8_t i = 0; i < d->ranked; i++) {
+        out[i] = d->channel[tea5767_stations_rank(d, i)];
+    }
+    return d->ranked;
+}
+
+// Same live stations, levels, flags and versions, same version and floor
+static void check_same(void) {
+    TEA5767_station_t station;
+    uint8_t live = 0;
+
+    TEST_CHECK(db.version == linear.version && db.floor == linear.floor);
+    for (int c = 0; c < BENCH_CHANNELS; c++) {
+        linear_station_t *old = linear_find(&linear, channel_of(c));
+        bool got = tea5767_stations_get(&db, channel_of(c), &station);
+        TEST_CHECK(got == (old != NULL));
+        if (got && old) {
+            TEST_CHECK(station.level == old->level && station.flags == old->flags && station.version == old->version);
+            live++;
+        }
+    }
+    TEST_CHECK(db.ranked == live);
+}
+
+static void replay(void) {
+    tea5767_stations_init(&db);
+    memset(&linear, 0, sizeof(linear));
+
+    for (uint32_t n = 0; n < BENCH_REPLAY; n++) {
+        uint16_t channel = channel_of(test_random() % BENCH_CHANNELS);
+        if (test_random() % 10 < 8) {
+            uint8_t level = test_random() % 16;
+            uint8_t flags = test_random() % 2 ? TEA5767_STATION_STEREO : 0;
+            TEST_CHECK(tea5767_stations_update(&db, channel, level, flags)
+                       == linear_update(&linear, channel, level, flags));
+        } else {
+            TEST_CHECK(tea5767_stations_remove(&db, channel) == linear_remove(&linear, channel));
+        }
+        if (n % 1000 == 0) {
+            check_same();
+        }
+    }
+    check_same();
+}
+
+// BENCH_STATIONS live stations in both, in random channel order
+static void fill(void) {
+    uint16_t order[BENCH_CHANNELS];
+
+    tea5767_stations_init(&db);
+    memset(&linear, 0, sizeof(linear));
+    for (int c = 0; c < BENCH_CHANNELS; c++) {
+        order[c] = channel_of(c);
+    }
+    for (int c = BENCH_CHANNELS - 1; c > 0; c--) {
+        int other = test_random() % (c + 1);
+        uint16_t t = order[c];
+        order[c] = order[other];
+        order[other] = t;
+    }
+    for (int i = 0; i < BENCH_STATIONS; i++) {
+        uint8_t level = test_random() % 16;
+        tea5767_stations_update(&db, order[i], level, 0);
+        linear_update(&linear, order[i], level, 0);
+    }
+    for (size_t i = 0; i < sizeof(channels) / sizeof(channels[0]); i++) {
+        channels[i] = linear.stations[test_random() % BENCH_STATIONS].channel;
+    }
+}
+
+/************************************
+ * GLOBAL FUNCTIONS
+ ************************************/
+int main() {
+    struct timespec from, to;
+    double old_ns[4], new_ns[4];
+    uint16_t old_order[TEA5767_STATIONS_MAX], new_order[TEA5767_STATIONS_MAX];
+    const size_t mask = sizeof(channels) / sizeof(channels[0]) - 1;
+    static const char *names[] = { "lookup", "unchanged update", "update, level +-1", "rank all stations" };
+
+    replay();
+    fill();
+
+    // Lookup
+    clock_gettime(CLOCK_MONOTONIC, &from);
+    for (uint32_t n = 0; n < BENCH_CALLS; n++) {
+        sink += linear_find(&linear, channels[n & mask])->level;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &to);
+    old_ns[0] = elapsed_ns(&from, &to) / BENCH_CALLS;
+    clock_gettime(CLOCK_MONOTONIC, &from);
+    for (uint32_t n = 0; n < BENCH_CALLS; n++) {
+        sink += tea5767_stations_find(&db, channels[n & mask]);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &to);
+    new_ns[0] = elapsed_ns(&from, &to) / BENCH_CALLS;
+
+    // Update with what the station already has
+    clock_gettime(CLOCK_MONOTONIC, &from);
+    for (uint32_t n = 0; n < BENCH_CALLS; n++) {
+        uint16_t channel = channels[n & mask];
+        sink += linear_update(&linear, channel, linear_find(&linear, channel)->level, 0);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &to);
+    old_ns[1] = elapsed_ns(&from, &to) / BENCH_CALLS;
+    clock_gettime(CLOCK_MONOTONIC, &from);
+    for (uint32_t n = 0; n < BENCH_CALLS; n++) {
+        uint16_t channel = channels[n & mask];
+        sink += tea5767_stations_update(&db, channel, db.level[tea5767_stations_find(&db, channel)], 0);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &to);
+    new_ns[1] = elapsed_ns(&from, &to) / BENCH_CALLS;
+
+    // A level moving by one step, the usual change between two readings. Both lookups are counted in.
+    clock_gettime(CLOCK_MONOTONIC, &from);
+    for (uint32_t n = 0; n < BENCH_CALLS; n++) {
+        uint16_t channel = channels[n & mask];
+        uint8_t level = linear_find(&linear, channel)->level;
+        sink += linear_update(&linear, channel, level == 15 || (level > 0 && n & 1) ? level - 1 : level + 1, 0);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &to);
+    old_ns[2] = elapsed_ns(&from, &to) / BENCH_CALLS;
+    clock_gettime(CLOCK_MONOTONIC, &from);
+    for (uint32_t n = 0; n < BENCH_CALLS; n++) {
+        uint16_t channel = channels[n & mask];
+        uint8_t level = db.level[tea5767_stations_find(&db, channel)];
+        sink += tea5767_stations_update(&db, channel, level == 15 || (level > 0 && n & 1) ? level - 1 : level + 1, 0);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &to);
+    new_ns[2] = elapsed_ns(&from, &to) / BENCH_CALLS;
+    check_same();
+
+    // Every station best first, as the ordered scan visits them
+    clock_gettime(CLOCK_MONOTONIC, &from);
+    for (uint32_t n = 0; n < BENCH_RANKS; n++) {
+        sink += linear_rank(&linear, old_order);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &to);
+    old_ns[3] = elapsed_ns(&from, &to) / BENCH_RANKS;
+    clock_gettime(CLOCK_MONOTONIC, &from);
+    for (uint32_t n = 0; n < BENCH_RANKS; n++) {
+        sink += columns_rank(&db, new_order);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &to);
+    new_ns[3] = elapsed_ns(&from, &to) / BENCH_RANKS;
+    // Same levels in the same order, stations of equal level may be ordered differently
+    TEST_CHECK(linear_rank(&linear, old_order) == columns_rank(&db, new_order));
+    for (int i = 0; i < BENCH_STATIONS; i++) {
+        TEST_CHECK(linear_find(&linear, old_order[i])->level == db.level[tea5767_stations_find(&db, new_order[i])]);
+    }
+
+    printf("stations: %u random updates and removes replayed on both tables, %u failures\n", BENCH_REPLAY,
+           test_failures);
+    printf("%u stations, %u max %20s %14s %14s\n", BENCH_STATIONS, TEA5767_STATIONS_MAX, "", "linear ns",
+           "columns ns");
+    for (int i = 0; i < 4; i++) {
+        printf("%-38s %14.1f %14.1f\n", names[i], old_ns[i], new_ns[i]);
+    }
+    return TEST_RESULT();
+}
@@ -0,0 +1,142 @@
+/**
+ ********************************************************************************
+ * @file    bench_wheel.c
+ * @author  Carlos Egea
+ * @date    18/10/2026
+ * @brief   Host benchmark of the timer wheel against a linear scan of deadlines.
+ *          Each simulated tuner has a settle check re-armed 5 to 100 ms ahead, a 250 ms
+ *          telemetry poll, and a 3 s timeout pushed back by every poll. The cost of a
+ *          1 ms tick is printed for 1 to 256 tuners.
+ ********************************************************************************
+ */
+
+/************************************
+ * INCLUDES
+ ************************************/
+#include <stdio.h>
+#include <time.h>
+#include "tea5767_wheel.h"
+#include "test.h"
+
+/************************************
+ * PRIVATE MACROS AND DEFINES
+ ************************************/
+#define BENCH_TUNERS_MAX 256
+#define BENCH_TICKS 60000 // One simulated minute
+#define BENCH_POLL_MS 250
+#define BENCH_TIMEOUT_MS 3000
+
+/************************************
+ * PRIVATE TYPEDEFS
+ ************************************/
+typedef struct {
+TEA5767_timer_t settle;
+TEA5767_timer_t poll;
+TEA5767_timer_t timeout;
+} tuner_t;
+
+/************************************
+ * STATIC VARIABLES
+ ************************************/
+static TEA5767_wheel_t wheel;
+static tuner_t tuners[BENCH_TUNERS_MAX];
+static uint32_t deadlines[BENCH_TUNERS_MAX][3]; // Linear scan: settle, poll and timeout tick of each tuner
+static uint32_t timeouts;
+
+/************************************
+ * STATIC FUNCTIONS
+ ************************************/
+static double elapsed_ns(const struct timespec *from, const struct timespec *to) {
+    return (to->tv_sec - from->tv_sec) * 1e9 + (to->tv_nsec - from->tv_nsec);
+}
+
+static uint32_t settle_delay(void) {
+    return 5 + test_random() % 96;
+}
+
+static void on_settle(TEA5767_timer_t *timer, void *user) {
+    tuner_t *tuner = user;
+    tea5767_wheel_add(&wheel, &tuner->settle, settle_delay());
+}
+
+static void on_poll(TEA5767_timer_t *timer, void *user) {
+    tuner_t *tuner = user;
+    tea5767_wheel_add(&wheel, &tuner->poll, BENCH_POLL_MS - 1);
+    tea5767_wheel_add(&wheel, &tuner->timeout, BENCH_TIMEOUT_MS - 1);
+}
+
+static void on_timeout(TEA5767_timer_t *timer, void *user) {
+    timeouts++;
+}
+
+static double bench_wheel(uint16_t count, uint32_t *fired) {
+    struct timespec from, to;
+
+    tea5767_wheel_init(&wheel, 0);
+    for (uint16_t i = 0; i < count; i++) {
+        tea5767_timer_init(&tuners[i].settle, on_settle, &tuners[i]);
+        tea5767_timer_init(&tuners[i].poll, on_poll, &tuners[i]);
+        tea5767_timer_init(&tuners[i].timeout, on_timeout, &tuners[i]);
+        tea5767_wheel_add(&wheel, &tuners[i].settle, test_random() % 100);
+        tea5767_wheel_add(&wheel, &tuners[i].poll, test_random() % BENCH_POLL_MS);
+        tea5767_wheel_add(&wheel, &tuners[i].timeout, BENCH_TIMEOUT_MS);
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &from);
+    for (uint32_t tick = 0; tick < BENCH_TICKS; tick++) {
+        tea5767_wheel_advance(&wheel, tick);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &to);
+    *fired = wheel.fired;
+    return elapsed_ns(&from, &to) / BENCH_TICKS;
+}
+
+static double bench_linear(uint16_t count, uint32_t *fired) {
+    struct timespec from, to;
+
+    *fired = 0;
+    for (uint16_t i = 0; i < count; i++) {
+        deadlines[i][0] = test_random() % 100;
+        deadlines[i][1] = test_random() % BENCH_POLL_MS;
+        deadlines[i][2] = BENCH_TIMEOUT_MS;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &from);
+    for (uint32_t tick = 0; tick < BENCH_TICKS; tick++) {
+        for (uint16_t i = 0; i < count; i++) {
+            // A wheel callback runs with the wheel one tick ahead, delays count from there
+            if (deadlines[i][0] == tick) {
+                deadlines[i][0] = tick + 1 + settle_delay();
+                (*fired)++;
+            }
+            if (deadlines[i][1] == tick) {
+                deadlines[i][1] = tick + BENCH_POLL_MS;
+                deadlines[i][2] = tick + BENCH_TIMEOUT_MS;
+                (*fired)++;
+            }
+            if (deadlines[i][2] == tick) {
+                (*fired)++;
+            }
+        }
+    }
+    clock_gettime(CLOCK_MONOTONIC, &to);
+    return elapsed_ns(&from, &to) / BENCH_TICKS;
+}
+
+/************************************
+ * GLOBAL FUNCTIONS
+ ************************************/
+int main() {
+    static const uint16_t counts[] = { 1, 4, 16, 64, 256 };
+
+    printf("%6s %14s %14s %12s %12s\n", "tuners", "wheel ns/tick", "linear ns/tick", "wheel fired", "linear fired");
+    for (size_t c = 0; c < sizeof(counts) / sizeof(counts[0]); c++) {
+        uint32_t fired_wheel, fired_linear;
+        double wheel_ns = bench_wheel(counts[c], &fired_wheel);
+        double linear_ns = bench_linear(counts[c], &fired_linear);
+        printf("%6u %14.1f %14.1f %12u %12u\n", counts[c], wheel_ns, linear_ns, fired_wheel, fired_linear);
+    }
+    // Every poll pushes the timeout back, one firing means the wheel lost a re-arm
+    TEST_CHECK(timeouts == 0);
+    return TEST_RESULT();
+}
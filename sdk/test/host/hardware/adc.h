@@ -0,0 +1,53 @@
+/**
+ ********************************************************************************
+ * @file    adc.h
+ * @author  Carlos Egea
+ * @date    18/10/2026
+ * @brief   Host stand-in for the Pico SDK ADC functions. Only single conversions of the
+ *          temperature sensor are simulated, at a temperature the test sets.
+ ********************************************************************************
+ */
+
+#ifndef _HOST_HARDWARE_ADC_H
+#define _HOST_HARDWARE_ADC_H
+
+/************************************
+ * INCLUDES
+ ************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+/************************************
+ * MACROS AND DEFINES
+ ************************************/
+#define ADC_CS_EN_BITS 0x00000001u
+
+/************************************
+ * TYPEDEFS
+ ************************************/
+typedef unsigned int uint;
+
+typedef struct {
+volatile uint32_t cs;           // Control and status, only the enable bit is simulated
+} adc_hw_t;
+
+/************************************
+ * GLOBAL VARIABLES
+ ************************************/
+extern adc_hw_t *adc_hw;
+extern uint32_t host_adc_inits; // Calls to adc_init(), each one resets the real block
+
+/************************************
+ * GLOBAL FUNCTION PROTOTYPES
+ ************************************/
+void adc_init(void);
+void adc_set_temp_sensor_enabled(bool enable);
+void adc_select_input(uint input);
+uint16_t adc_read(void);
+
+/*! @brief Sets the temperature the on-chip sensor reads, through the RP2040 datasheet slope.
+* @param celsius Temperature in degrees Celsius.
+*/
+void host_adc_setTemperature(float celsius);
+
+#endif
@@ -0,0 +1,35 @@
+/**
+ ********************************************************************************
+ * @file    gpio.h
+ * @author  Carlos Egea
+ * @date    18/10/2026
+ * @brief   Host stand-in for the Pico SDK GPIO functions the driver calls. They do nothing.
+ ********************************************************************************
+ */
+
+#ifndef _HOST_HARDWARE_GPIO_H
+#define _HOST_HARDWARE_GPIO_H
+
+/************************************
+ * INCLUDES
+ ************************************/
+#include <stdint.h>
+
+/************************************
+ * MACROS AND DEFINES
+ ************************************/
+#define GPIO_FUNC_I2C 3
+
+/************************************
+ * GLOBAL FUNCTION PROTOTYPES
+ ************************************/
+static inline void gpio_set_function(unsigned int gpio, int fn) {
+    (void)gpio;
+    (void)fn;
+}
+
+static inline void gpio_pull_up(unsigned int gpio) {
+    (void)gpio;
+}
+
+#endif
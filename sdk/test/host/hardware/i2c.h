@@ -0,0 +1,83 @@
+/**
+ ********************************************************************************
+ * @file    i2c.h
+ * @author  Carlos Egea
+ * @date    18/10/2026
+ * @brief   Host stand-in for the Pico SDK I2C functions, backed by simulated tuners.
+ *          Every address from HOST_I2C_TUNER upwards answers as a TEA5767 that has locked
+ *          on whatever it was last written. Other addresses do not acknowledge.
+ ********************************************************************************
+ */
+
+#ifndef _HOST_HARDWARE_I2C_H
+#define _HOST_HARDWARE_I2C_H
+
+/************************************
+ * INCLUDES
+ ************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "pico/time.h"
+
+/************************************
+ * MACROS AND DEFINES
+ ************************************/
+#define PICO_ERROR_GENERIC -1
+#define HOST_I2C_TUNER 0x60 // First simulated tuner address
+#define HOST_I2C_TUNERS 8 // Simulated tuners, as many as a sampler burst or a mux holds
+#define HOST_I2C_TRANSFER_US 150 // Simulated clock advance per transfer, five bytes at 400 kHz with overhead
+#define i2c_default i2c0
+#define PICO_DEFAULT_I2C_SDA_PIN 4 // Pico board pins, as the SDK board header has them
+#define PICO_DEFAULT_I2C_SCL_PIN 5
+
+/************************************
+ * TYPEDEFS
+ ************************************/
+typedef unsigned int uint;
+typedef struct i2c_inst i2c_inst_t;
+
+/*! @brief Bus traffic so far
+*/
+typedef struct {
+uint32_t writes;                // Write transfers acknowledged
+uint32_t reads;                 // Read transfers acknowledged
+uint32_t nacks;                 // Transfers to an address nobody answers
+} host_i2c_stats_t;
+
+/************************************
+ * GLOBAL VARIABLES
+ ************************************/
+extern i2c_inst_t *i2c0;
+extern i2c_inst_t *i2c1;
+extern host_i2c_stats_t host_i2c_stats;
+
+/************************************
+ * GLOBAL FUNCTION PROTOTYPES
+ ************************************/
+uint i2c_init(i2c_inst_t *i2c, uint baudrate);
+uint i2c_hw_index(i2c_inst_t *i2c);
+int i2c_write_blocking(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, bool nostop);
+int i2c_read_blocking(i2c_inst_t *i2c, uint8_t addr, uint8_t *dst, size_t len, bool nostop);
+
+/*! @brief Sets the level a simulated tuner reports.
+* @param addr Tuner address.
+* @param level ADC level, 0 to 15.
+*/
+void host_i2c_setLevel(uint8_t addr, uint8_t level);
+
+/*! @brief Offsets the local oscillator of a simulated tuner, as a drifting reference crystal would.
+* From then on its IF counter reads the distance from the oscillator to the nearest 100 kHz channel,
+* in 4096 Hz counts, instead of the centre of the range.
+* @param addr Tuner address.
+* @param hz Oscillator error in Hz, positive when it runs high.
+*/
+void host_i2c_setDrift(uint8_t addr, int32_t hz);
+
+/*! @brief Last five bytes written to a simulated tuner.
+* @param addr Tuner address.
+* @return const uint8_t* Register image, all zero if never written.
+*/
+const uint8_t *host_i2c_registers(uint8_t addr);
+
+#endif
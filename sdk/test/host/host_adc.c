@@ -0,0 +1,67 @@
+/**
+ ********************************************************************************
+ * @file    host_adc.c
+ * @author  Carlos Egea
+ * @date    18/10/2026
+ * @brief   Simulated ADC behind the host hardware/adc.h. Input 4 reads the temperature
+ *          sensor when it is enabled, 0.706 V at 27 C and -1.721 mV/C; the other inputs
+ *          and a disabled sensor read mid scale and 0.
+ ********************************************************************************
+ */
+
+/************************************
+ * INCLUDES
+ ************************************/
+#include "hardware/adc.h"
+
+/************************************
+ * PRIVATE MACROS AND DEFINES
+ ************************************/
+#define HOST_ADC_TEMPERATURE_INPUT 4
+
+/************************************
+ * STATIC VARIABLES
+ ************************************/
+static adc_hw_t registers;
+static uint input;
+static bool sensor;
+static float temperature = 27.0f;
+
+/************************************
+ * GLOBAL VARIABLES
+ ************************************/
+adc_hw_t *adc_hw = &registers;
+uint32_t host_adc_inits;
+
+/************************************
+ * GLOBAL FUNCTIONS
+ ************************************/
+void adc_init(void) {
+    registers.cs = ADC_CS_EN_BITS;
+    sensor = false;
+    input = 0;
+    host_adc_inits++;
+}
+
+void adc_set_temp_sensor_enabled(bool enable) {
+    sensor = enable;
+}
+
+void adc_select_input(uint in) {
+    input = in;
+}
+
+uint16_t adc_read(void) {
+    if (input != HOST_ADC_TEMPERATURE_INPUT) {
+        return 1 << 11;
+    }
+    if (!sensor) {
+        return 0;
+    }
+    float voltage = 0.706f - (temperature - 27.0f) * 0.001721f;
+    return voltage * (1 << 12) / 3.3f + 0.5f;
+}
+
+void host_adc_setTemperature(float celsius) {
+    temperature = celsius;
+}
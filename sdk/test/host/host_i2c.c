@@ -0,0 +1,142 @@
+/**
+ ********************************************************************************
+ * @file    host_i2c.c
+ * @author  Carlos Egea
+ * @date    18/10/2026
+ * @brief   Simulated tuners behind the host hardware/i2c.h. A read answers ready, stereo,
+ *          the IF counter centred and the PLL word last written, so the driver sees a lock.
+ *          A tuner given a drift reads the IF error of its oscillator instead.
+ ********************************************************************************
+ */
+
+/************************************
+ * INCLUDES
+ ************************************/
+#include <string.h>
+#include "hardware/i2c.h"
+
+/************************************
+ * PRIVATE MACROS AND DEFINES
+ ************************************/
+#define HOST_TUNER_REGISTERS 5
+#define HOST_TUNER_IF 0x37 // Centre of the IF counter range
+#define HOST_TUNER_LEVEL 10 // Level reported until set otherwise
+#define HOST_TUNER_PLL_HZ 8192 // Oscillator step of the PLL word, 32768 Hz / 4
+#define HOST_TUNER_IF_HZ 4096 // IF counter step
+#define HOST_TUNER_CHANNEL_HZ 100000
+
+/************************************
+ * PRIVATE TYPEDEFS
+ ************************************/
+typedef struct {
+uint8_t registers[HOST_TUNER_REGISTERS]; // Last write
+uint8_t level;                  // ADC level reported
+bool levelSet;                  // level set by host_i2c_setLevel()
+int32_t drift;                  // Oscillator error in Hz
+bool driftSet;                  // drift set by host_i2c_setDrift()
+} host_tuner_t;
+
+/************************************
+ * STATIC VARIABLES
+ ************************************/
+static uint8_t controllers[2]; // Only their addresses matter, they tell the two controllers apart
+static host_tuner_t tuners[HOST_I2C_TUNERS];
+
+/************************************
+ * GLOBAL VARIABLES
+ ************************************/
+i2c_inst_t *i2c0 = (i2c_inst_t *)&controllers[0];
+i2c_inst_t *i2c1 = (i2c_inst_t *)&controllers[1];
+host_i2c_stats_t host_i2c_stats;
+
+/************************************
+ * STATIC FUNCTIONS
+ ************************************/
+static host_tuner_t *host_tuner(uint8_t addr) {
+    if (addr < HOST_I2C_TUNER || addr >= HOST_I2C_TUNER + HOST_I2C_TUNERS) {
+        return 0;
+    }
+    return &tuners[addr - HOST_I2C_TUNER];
+}
+
+// IF counter of a tuner locked on its last PLL word, high side injection
+static uint8_t host_tuner_if(const host_tuner_t *tuner) {
+    if (!tuner->driftSet) {
+        return HOST_TUNER_IF;
+    }
+    int64_t oscillator = (int64_t)((tuner->registers[0] & 0x3f) << 8 | tuner->registers[1]) * HOST_TUNER_PLL_HZ
+            + tuner->drift;
+    int64_t tuned = oscillator - HOST_TUNER_IF * HOST_TUNER_IF_HZ;
+    int64_t channel = (tuned + HOST_TUNER_CHANNEL_HZ / 2) / HOST_TUNER_CHANNEL_HZ * HOST_TUNER_CHANNEL_HZ;
+    int64_t count = (oscillator - channel + HOST_TUNER_IF_HZ / 2) / HOST_TUNER_IF_HZ;
+    return count < 0 ? 0 : count > 0x7f ? 0x7f : count;
+}
+
+/************************************
+ * GLOBAL FUNCTIONS
+ ************************************/
+uint i2c_init(i2c_inst_t *i2c, uint baudrate) {
+    (void)i2c;
+    return baudrate;
+}
+
+uint i2c_hw_index(i2c_inst_t *i2c) {
+    return i2c == i2c1;
+}
+
+int i2c_write_blocking(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, bool nostop) {
+    host_tuner_t *tuner = host_tuner(addr);
+
+    (void)i2c;
+    (void)nostop;
+    host_advance_us(HOST_I2C_TRANSFER_US);
+    if (!tuner) {
+        host_i2c_stats.nacks++;
+        return PICO_ERROR_GENERIC;
+    }
+    memcpy(tuner->registers, src, len < HOST_TUNER_REGISTERS ? len : HOST_TUNER_REGISTERS);
+    host_i2c_stats.writes++;
+    return len;
+}
+
+int i2c_read_blocking(i2c_inst_t *i2c, uint8_t addr, uint8_t *dst, size_t len, bool nostop) {
+    host_tuner_t *tuner = host_tuner(addr);
+    uint8_t status[HOST_TUNER_REGISTERS];
+
+    (void)i2c;
+    (void)nostop;
+    host_advance_us(HOST_I2C_TRANSFER_US);
+    if (!tuner) {
+        host_i2c_stats.nacks++;
+        return PICO_ERROR_GENERIC;
+    }
+    status[0] = 0x80 | (tuner->registers[0] & 0x3f);
+    status[1] = tuner->registers[1];
+    status[2] = 0x80 | host_tuner_if(tuner);
+    status[3] = (tuner->levelSet ? tuner->level : HOST_TUNER_LEVEL) << 4;
+    status[4] = 0;
+    memcpy(dst, status, len < HOST_TUNER_REGISTERS ? len : HOST_TUNER_REGISTERS);
+    host_i2c_stats.reads++;
+    return len;
+}
+
+void host_i2c_setLevel(uint8_t addr, uint8_t level) {
+    host_tuner_t *tuner = host_tuner(addr);
+    if (tuner) {
+        tuner->level = level;
+        tuner->levelSet = true;
+    }
+}
+
+void host_i2c_setDrift(uint8_t addr, int32_t hz) {
+    host_tuner_t *tuner = host_tuner(addr);
+    if (tuner) {
+        tuner->drift = hz;
+        tuner->driftSet = true;
+    }
+}
+
+const uint8_t *host_i2c_registers(uint8_t addr) {
+    host_tuner_t *tuner = host_tuner(addr);
+    return tuner ? tuner->registers : 0;
+}
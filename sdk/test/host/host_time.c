@@ -0,0 +1,42 @@
+/**
+ ********************************************************************************
+ * @file    host_time.c
+ * @author  Carlos Egea
+ * @date    18/10/2026
+ * @brief   Simulated clock behind the host pico/time.h. Sleeping advances it at once,
+ *          so timing dependent code runs as fast as the host allows and repeats exactly.
+ ********************************************************************************
+ */
+
+/************************************
+ * INCLUDES
+ ************************************/
+#include "pico/time.h"
+
+/************************************
+ * STATIC VARIABLES
+ ************************************/
+static uint64_t now_us;
+
+/************************************
+ * GLOBAL FUNCTIONS
+ ************************************/
+uint64_t time_us_64(void) {
+    return now_us;
+}
+
+uint32_t time_us_32(void) {
+    return now_us;
+}
+
+void sleep_us(uint64_t us) {
+    now_us += us;
+}
+
+void sleep_ms(uint32_t ms) {
+    now_us += (uint64_t)ms * 1000;
+}
+
+void host_advance_us(uint64_t us) {
+    now_us += us;
+}
@@ -0,0 +1,16 @@
+/**
+ ********************************************************************************
+ * @file    binary_info.h
+ * @author  Carlos Egea
+ * @date    18/10/2026
+ * @brief   Host stand-in for the Pico SDK binary info, which has no meaning off target.
+ ********************************************************************************
+ */
+
+#ifndef _HOST_PICO_BINARY_INFO_H
+#define _HOST_PICO_BINARY_INFO_H
+
+#define bi_decl(...)
+#define bi_2pins_with_func(...)
+
+#endif
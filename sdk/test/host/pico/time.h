@@ -0,0 +1,31 @@
+/**
+ ********************************************************************************
+ * @file    time.h
+ * @author  Carlos Egea
+ * @date    18/10/2026
+ * @brief   Host stand-in for the Pico SDK time functions, on a simulated clock.
+ ********************************************************************************
+ */
+
+#ifndef _HOST_PICO_TIME_H
+#define _HOST_PICO_TIME_H
+
+/************************************
+ * INCLUDES
+ ************************************/
+#include <stdint.h>
+
+/************************************
+ * GLOBAL FUNCTION PROTOTYPES
+ ************************************/
+uint64_t time_us_64(void);
+uint32_t time_us_32(void);
+void sleep_us(uint64_t us);
+void sleep_ms(uint32_t ms);
+
+/*! @brief Moves the simulated clock, which only advances through this and the sleeps.
+* @param us Microseconds to advance by.
+*/
+void host_advance_us(uint64_t us);
+
+#endif
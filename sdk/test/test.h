@@ -0,0 +1,50 @@
+/**
+ ********************************************************************************
+ * @file    test.h
+ * @author  Carlos Egea
+ * @date    18/10/2026
+ * @brief   Minimal checks for the host-built tests.
+ ********************************************************************************
+ */
+
+#ifndef _HARDWARE_TEA5767_TEST_H
+#define _HARDWARE_TEA5767_TEST_H
+
+/************************************
+ * INCLUDES
+ ************************************/
+#include <stdio.h>
+#include <stdint.h>
+
+/************************************
+ * MACROS AND DEFINES
+ ************************************/
+// Reports a failed condition and counts it, the test goes on so one run shows every failure
+#define TEST_CHECK(cond) do { \
+        if (!(cond)) { \
+            printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+            test_failures++; \
+        } \
+    } while (0)
+
+// Exit status of main
+#define TEST_RESULT() (test_failures ? 1 : 0)
+
+/************************************
+ * STATIC VARIABLES
+ ************************************/
+static uint32_t test_failures;
+static uint64_t test_seed = 0x9e3779b97f4a7c15ull;
+
+/************************************
+ * STATIC FUNCTIONS
+ ************************************/
+// xorshift64*, the same sequence on every host so failures reproduce
+static inline uint32_t test_random(void) {
+    test_seed ^= test_seed >> 12;
+    test_seed ^= test_seed << 25;
+    test_seed ^= test_seed >> 27;
+    return (test_seed * 0x2545f4914f6cdd1dull) >> 32;
+}
+
+#endif
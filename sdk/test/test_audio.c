@@ -0,0 +1,290 @@
+/**
+ ********************************************************************************
+ * @file    test_audio.c
+ * @author  Carlos Egea
+ * @date    18/10/2026
+ * @brief   Host test of the audio kernels against a plain reference.
+ *          Built once as the host allows (SSE2 on x86) and once with TEA5767_AUDIO_SCALAR,
+ *          both builds have to give the reference results bit for bit.
+ ********************************************************************************
+ */
+
+/************************************
+ * INCLUDES
+ ************************************/
+#include <math.h>
+#include <string.h>
+#include "tea5767_audio.h"
+#include "test.h"
+
+/************************************
+ * PRIVATE MACROS AND DEFINES
+ ************************************/
+#define SAMPLES 4103 // Long enough for several flushes of the vector lanes, with a tail
+#define PCM_RATE 31250 // Stream rate of the streaming stage checks
+#define PCM_BLOCK 256
+#define PCM_TONE 440
+#define PCM_CUTOFF 20
+#define AGC_TARGET 16384
+
+/************************************
+ * STATIC VARIABLES
+ ************************************/
+static uint16_t samples[SAMPLES * 3];
+static int16_t pcm[PCM_BLOCK];
+static uint32_t phase; // Samples of tone generated so far
+
+/************************************
+ * STATIC FUNCTIONS
+ ************************************/
+static uint64_t ref_isqrt(uint64_t value) {
+    uint64_t root = sqrtl(value);
+    while (root * root > value) {
+        root--;
+    }
+    while ((root + 1) * (root + 1) <= value) {
+        root++;
+    }
+    return root;
+}
+
+static void ref_moments(const uint16_t *x, size_t n, size_t stride, uint64_t *sum, uint64_t *sum_sq) {
+    *sum = 0;
+    *sum_sq = 0;
+    for (size_t i = 0; i < n; i++) {
+        *sum += x[i * stride];
+        *sum_sq += (uint64_t)x[i * stride] * x[i * stride];
+    }
+}
+
+static uint16_t ref_rms(const uint16_t *x, size_t n, size_t stride) {
+    uint64_t sum, sum_sq;
+
+    if (n == 0) {
+        return 0;
+    }
+    ref_moments(x, n, stride, &sum, &sum_sq);
+    return ref_isqrt((n * sum_sq - sum * sum) / ((uint64_t)n * n));
+}
+
+static uint32_t ref_zeroCrossings(const uint16_t *x, size_t n, size_t stride) {
+    uint64_t sum, sum_sq;
+    uint32_t crossings = 0;
+
+    if (n == 0) {
+        return 0;
+    }
+    ref_moments(x, n, stride, &sum, &sum_sq);
+    uint16_t m = sum / n;
+    for (size_t i = 1; i < n; i++) {
+        crossings += (x[i * stride] >= m) != (x[(i - 1) * stride] >= m);
+    }
+    return crossings;
+}
+
+static uint16_t ref_noise(const uint16_t *x, size_t n, size_t stride) {
+    uint64_t sum_sq = 0;
+
+    if (n < 2) {
+        return 0;
+    }
+    for (size_t i = 1; i < n; i++) {
+        int64_t d = (int64_t)x[i * stride] - x[(i - 1) * stride];
+        sum_sq += d * d;
+    }
+    return ref_isqrt(sum_sq / (2 * (n - 1)));
+}
+
+// Same recurrence with 128-bit state, so any overflow of the kernel shows up as a difference
+static uint64_t ref_goertzel(const uint16_t *x, size_t n, size_t stride, int32_t coeff) {
+    uint64_t sum, sum_sq;
+    __int128 s1 = 0, s2 = 0;
+
+    ref_moments(x, n, stride, &sum, &sum_sq);
+    int32_t m = n ? sum / n : 0;
+    for (size_t i = 0; i < n; i++) {
+        __int128 s = (int32_t)x[i * stride] - m + ((coeff * s1) >> TEA5767_AUDIO_Q) - s2;
+        s2 = s1;
+        s1 = s;
+    }
+    __int128 power = s1 * s1 + s2 * s2 - ((coeff * s1) >> TEA5767_AUDIO_Q) * s2;
+    return power > 0 ? (uint64_t)power : 0;
+}
+
+static void check_block(size_t n, size_t stride) {
+    TEST_CHECK(tea5767_audio_rms(samples, n, stride) == ref_rms(samples, n, stride));
+    TEST_CHECK(tea5767_audio_zeroCrossings(samples, n, stride) == ref_zeroCrossings(samples, n, stride));
+    TEST_CHECK(tea5767_audio_noise(samples, n, stride) == ref_noise(samples, n, stride));
+    if (n <= TEA5767_GOERTZEL_MAX) {
+        int32_t coeff = tea5767_audio_goertzelCoeff(test_random() % 22050, 44100);
+        TEST_CHECK(tea5767_audio_goertzel(samples, n, stride, coeff) == ref_goertzel(samples, n, stride, coeff));
+    }
+}
+
+static void test_kernels(void) {
+    // Full scale noise, then a quiet tone with noise, every length around the lane and flush boundaries
+    for (size_t i = 0; i < SAMPLES * 3; i++) {
+        samples[i] = test_random() & 0xfff;
+    }
+    for (size_t n = 0; n <= 300; n++) {
+        check_block(n, 1);
+        check_block(n, 2);
+    }
+    check_block(SAMPLES, 1);
+    check_block(SAMPLES, 3);
+
+    for (size_t i = 0; i < SAMPLES * 3; i++) {
+        samples[i] = 2048 + lroundf(300 * sinf(2 * 3.14159265f * 1000 * i / 44100)) + (int)(test_random() % 64) - 32;
+    }
+    for (size_t n = 0; n <= 300; n++) {
+        check_block(n, 1);
+    }
+    check_block(SAMPLES, 1);
+}
+
+// The filter state grows fastest near 0 Hz and Nyquist, with the input as far from its mean as it can be
+static void test_goertzelRange(void) {
+    const size_t n = TEA5767_GOERTZEL_MAX;
+    const int32_t dc = 2 << TEA5767_AUDIO_Q;
+    const int32_t nyquist = -(2 << TEA5767_AUDIO_Q);
+
+    for (size_t i = 0; i < n; i++) {
+        samples[i] = i < n / 2 ? 4095 : 0;
+    }
+    TEST_CHECK(tea5767_audio_goertzel(samples, n, 1, dc) == ref_goertzel(samples, n, 1, dc));
+    for (size_t i = 0; i < n; i++) {
+        samples[i] = (i & 1) ? 4095 : 0;
+    }
+    TEST_CHECK(tea5767_audio_goertzel(samples, n, 1, nyquist) == ref_goertzel(samples, n, 1, nyquist));
+}
+
+static void test_toPcm(void) {
+    uint16_t x[4096];
+    int16_t pcm[4096];
+
+    for (uint16_t i = 0; i < 4096; i++) {
+        x[i] = i;
+    }
+    tea5767_audio_toPcm(x, 4096, 1, pcm, 1);
+    for (uint16_t i = 0; i < 4096; i++) {
+        TEST_CHECK(pcm[i] == ((int32_t)i - 2048) * 16);
+    }
+    TEST_CHECK(pcm[0] == INT16_MIN);
+}
+
+// A block of the test tone as the ADC gives it, a few counts of DC offset included, made PCM
+static void tone_block(int32_t amplitude) {
+    uint16_t adc[PCM_BLOCK];
+
+    for (uint16_t i = 0; i < PCM_BLOCK; i++, phase++) {
+        adc[i] = 2048 + 300 + lroundf(amplitude * sinf(2 * 3.14159265f * PCM_TONE * phase / PCM_RATE));
+    }
+    tea5767_audio_toPcm(adc, PCM_BLOCK, 1, pcm, 1);
+}
+
+static int32_t block_peak(void) {
+    int32_t peak = 0;
+
+    for (uint16_t i = 0; i < PCM_BLOCK; i++) {
+        int32_t level = pcm[i] < 0 ? -pcm[i] : pcm[i];
+        peak = level > peak ? level : peak;
+    }
+    return peak;
+}
+
+static void test_hpf(void) {
+    TEA5767_hpf_t hpf;
+    int32_t sum = 0;
+
+    // A DC step goes through at once and is gone within a second
+    tea5767_audio_hpfInit(&hpf, PCM_CUTOFF, PCM_RATE);
+    for (uint32_t block = 0; block < PCM_RATE / PCM_BLOCK; block++) {
+        for (uint16_t i = 0; i < PCM_BLOCK; i++) {
+            pcm[i] = 10000;
+        }
+        tea5767_audio_hpf(&hpf, pcm, PCM_BLOCK, 1);
+        if (block == 0) {
+            TEST_CHECK(pcm[0] == 10000);
+        }
+    }
+    TEST_CHECK(block_peak() <= 1);
+
+    // The tone passes, its ADC offset of 4800 PCM units does not. The mean is taken over 450 periods of the tone.
+    tea5767_audio_hpfInit(&hpf, PCM_CUTOFF, PCM_RATE);
+    for (uint32_t block = 0; block < 250; block++) {
+        tone_block(1000);
+        tea5767_audio_hpf(&hpf, pcm, PCM_BLOCK, 1);
+        for (uint16_t i = 0; block >= 125 && i < PCM_BLOCK; i++) {
+            sum += pcm[i];
+        }
+    }
+    TEST_CHECK(sum / (125 * PCM_BLOCK) > -20 && sum / (125 * PCM_BLOCK) < 20);
+    TEST_CHECK(block_peak() > 16000 * 95 / 100 && block_peak() < 16000 * 105 / 100);
+
+    // A full scale swing saturates instead of wrapping
+    tea5767_audio_hpfInit(&hpf, PCM_CUTOFF, PCM_RATE);
+    pcm[0] = INT16_MIN;
+    pcm[1] = INT16_MAX;
+    tea5767_audio_hpf(&hpf, pcm, 2, 1);
+    TEST_CHECK(pcm[0] == INT16_MIN && pcm[1] == INT16_MAX);
+}
+
+// The tone steps 200 -> 1500 -> 80 ADC counts, the output peak has to settle on the target every time
+static void test_agc(void) {
+    static const int32_t amplitudes[] = { 200, 1500, 80 };
+    TEA5767_hpf_t hpf;
+    TEA5767_agc_t agc;
+    int16_t in[PCM_BLOCK];
+    uint32_t blocks = 2 * PCM_RATE / PCM_BLOCK;
+    uint32_t saturated = 0;
+
+    tea5767_audio_hpfInit(&hpf, PCM_CUTOFF, PCM_RATE);
+    tea5767_audio_agcInit(&agc, AGC_TARGET, 16.0f, 5.0f, 300.0f, PCM_RATE);
+    phase = 0;
+    for (uint8_t step = 0; step < sizeof(amplitudes) / sizeof(amplitudes[0]); step++) {
+        int32_t peak = 0;
+        for (uint32_t block = 0; block < blocks; block++) {
+            tone_block(amplitudes[step]);
+            tea5767_audio_hpf(&hpf, pcm, PCM_BLOCK, 1);
+            tea5767_audio_agc(&agc, pcm, PCM_BLOCK, 1);
+            // Last quarter of a second of each step
+            if (block >= blocks - PCM_RATE / 4 / PCM_BLOCK && block_peak() > peak) {
+                peak = block_peak();
+            }
+        }
+        // Gain within 10% of what takes the tone peak to the target
+        float expected = (float)AGC_TARGET / (amplitudes[step] * 16);
+        float gain = (float)agc.gain / (1 << TEA5767_AUDIO_GAIN_Q);
+        TEST_CHECK(peak > AGC_TARGET * 9 / 10 && peak < AGC_TARGET * 11 / 10);
+        TEST_CHECK(gain > expected * 0.9f && gain < expected * 1.1f);
+        printf("agc step to %4d counts: gain %5.2f, output peak %d\n", (int)amplitudes[step], gain, (int)peak);
+    }
+
+    // Near full scale right after the quiet step, the gain is still high: clipped, never wrapped
+    tone_block(2000);
+    tea5767_audio_hpf(&hpf, pcm, PCM_BLOCK, 1);
+    memcpy(in, pcm, sizeof(in));
+    tea5767_audio_agc(&agc, pcm, PCM_BLOCK, 1);
+    for (uint16_t i = 0; i < PCM_BLOCK; i++) {
+        TEST_CHECK(in[i] == 0 || (in[i] > 0) == (pcm[i] > 0));
+        saturated += pcm[i] == INT16_MAX || pcm[i] == INT16_MIN;
+    }
+    TEST_CHECK(saturated > 0);
+}
+
+/************************************
+ * GLOBAL FUNCTIONS
+ ************************************/
+int main() {
+    test_kernels();
+    test_goertzelRange();
+    test_toPcm();
+    test_hpf();
+    test_agc();
+#ifdef TEA5767_AUDIO_SCALAR
+    printf("audio, scalar build: %u failures\n", test_failures);
+#else
+    printf("audio, default build: %u failures\n", test_failures);
+#endif
+    return TEST_RESULT();
+}
@@ -0,0 +1,365 @@
+/**
+ ********************************************************************************
+ * @file    test_command.c
+ * @author  Carlos Egea
+ * @date    18/10/2026
+ * @brief   Host test of the command broker against simulated tuners on a simulated clock.
+ *          Frame handling, staging, coalescing and the status cache are checked request by
+ *          request, then the load model compares the broker with a write or read per request.
+ ********************************************************************************
+ */
+
+/************************************
+ * INCLUDES
+ ************************************/
+#include <stdlib.h>
+#include <string.h>
+#include "hardware/i2c.h"
+#include "tea5767_command.h"
+#include "test.h"
+
+/************************************
+ * PRIVATE MACROS AND DEFINES
+ ************************************/
+#define REPLIES_MAX 256 // Replies kept by the functional checks
+#define MODEL_US 10000000ull // Simulated length of a load model run
+#define MODEL_REQUESTS 40000
+#define MODEL_POLL_US 1000 // Broker transport poll period
+
+/************************************
+ * PRIVATE TYPEDEFS
+ ************************************/
+typedef struct {
+uint8_t type;
+uint8_t client;
+uint8_t seq;
+uint16_t len;
+uint8_t payload[TEA5767_CMD_PAYLOAD_MAX];
+} reply_t;
+
+typedef struct {
+uint64_t at;                    // Arrival time
+uint8_t client;
+uint8_t seq;
+uint8_t type;                   // TEA5767_CMD_SET or TEA5767_CMD_STATUS
+uint8_t field;                  // Set requests: field and value
+uint16_t value;
+} request_t;
+
+/************************************
+ * STATIC VARIABLES
+ ************************************/
+static TEA5757_t radio;
+static TEA5767_stations_t db;
+static TEA5767_broker_t broker;
+static reply_t replies[REPLIES_MAX];
+static uint32_t reply_count;
+
+// Load model
+static request_t requests[MODEL_REQUESTS];
+static uint64_t sent_us[256][256];
+static bool outstanding[256][256];
+static uint64_t latency_sum, latency_max;
+static uint32_t answered, unexpected;
+
+/************************************
+ * STATIC FUNCTIONS
+ ************************************/
+static void on_reply(uint8_t client, const uint8_t *frame, size_t len, void *user) {
+    const uint8_t *payload;
+    uint16_t payload_len;
+
+    TEST_CHECK(tea5767_command_decode(frame, len, &payload, &payload_len));
+    TEST_CHECK(frame[1] == client);
+    if (reply_count < REPLIES_MAX) {
+        reply_t *reply = &replies[reply_count];
+        reply->type = frame[0];
+        reply->client = frame[1];
+        reply->seq = frame[2];
+        reply->len = payload_len;
+        memcpy(reply->payload, payload, payload_len);
+    }
+    reply_count++;
+}
+
+static void send_frame(uint8_t type, uint8_t client, uint8_t seq, const uint8_t *payload, uint16_t len) {
+    uint8_t frame[TEA5767_CMD_FRAME_MAX];
+    size_t size = tea5767_command_encode(frame, type, client, seq, payload, len);
+    tea5767_broker_handle(&broker, frame, size);
+}
+
+static void send_set(uint8_t client, uint8_t seq, uint8_t field, uint16_t value) {
+    uint8_t payload[3] = { field, value & 0xff, value >> 8 };
+    send_frame(TEA5767_CMD_SET, client, seq, payload, sizeof(payload));
+}
+
+static void setup(void) {
+    radio = tea5767_init();
+    radio.frequency = 100.0f;
+    tea5767_write_registers(radio);
+    tea5767_stations_init(&db);
+    tea5767_broker_init(&broker, &radio, &db, on_reply, 0);
+    reply_count = 0;
+}
+
+static void test_frames(void) {
+    uint8_t frame[TEA5767_CMD_FRAME_MAX];
+    uint8_t payload[] = { 1, 2, 3, 4 };
+    const uint8_t *decoded;
+    uint16_t decoded_len;
+
+    size_t size = tea5767_command_encode(frame, TEA5767_CMD_STATIONS, 7, 9, payload, sizeof(payload));
+    TEST_CHECK(size == TEA5767_CMD_HEADER + sizeof(payload) + TEA5767_CMD_TRAILER);
+    TEST_CHECK(tea5767_command_decode(frame, size, &decoded, &decoded_len));
+    TEST_CHECK(decoded_len == sizeof(payload) && memcmp(decoded, payload, sizeof(payload)) == 0);
+    TEST_CHECK(!tea5767_command_decode(frame, size - 1, &decoded, &decoded_len));
+    TEST_CHECK(tea5767_command_encode(frame, TEA5767_CMD_SET, 0, 0, payload, TEA5767_CMD_PAYLOAD_MAX + 1) == 0);
+
+    // A corrupted frame is answered with an error, client and sequence as received
+    setup();
+    frame[TEA5767_CMD_HEADER] ^= 0x40;
+    tea5767_broker_handle(&broker, frame, size);
+    TEST_CHECK(reply_count == 1);
+    TEST_CHECK(replies[0].type == TEA5767_CMD_ERROR && replies[0].payload[0] == TEA5767_ERR_FRAME);
+    TEST_CHECK(replies[0].client == 7 && replies[0].seq == 9);
+
+    send_frame(0x42, 1, 2, 0, 0);
+    TEST_CHECK(reply_count == 2 && replies[1].payload[0] == TEA5767_ERR_TYPE);
+}
+
+static void test_set(void) {
+    uint8_t expected[TEA5767_REGISTERS];
+
+    setup();
+    // Invalid requests are refused whole, a valid field in the same request is not staged
+    uint8_t mixed[6] = { TEA5767_FIELD_MUTE, 1, 0, 0x99, 0, 0 };
+    send_frame(TEA5767_CMD_SET, 1, 1, mixed, sizeof(mixed));
+    send_set(1, 2, TEA5767_FIELD_CHANNEL, 5000);
+    TEST_CHECK(reply_count == 2);
+    TEST_CHECK(replies[0].payload[0] == TEA5767_ERR_FIELD && replies[1].payload[0] == TEA5767_ERR_FIELD);
+    TEST_CHECK(!tea5767_broker_flush(&broker));
+    TEST_CHECK(!broker.staged.mute_mode);
+
+    // Three clients, one write, three acknowledgements after it
+    reply_count = 0;
+    uint32_t writes = host_i2c_stats.writes;
+    send_set(1, 10, TEA5767_FIELD_CHANNEL, 9000);
+    send_set(2, 20, TEA5767_FIELD_MUTE, 1);
+    send_set(3, 30, TEA5767_FIELD_STEREO, 0);
+    TEST_CHECK(reply_count == 0);
+    TEST_CHECK(tea5767_broker_flush(&broker));
+    TEST_CHECK(host_i2c_stats.writes - writes == 1);
+    TEST_CHECK(reply_count == 3);
+    for (uint8_t i = 0; i < 3; i++) {
+        TEST_CHECK(replies[i].type == (TEA5767_CMD_SET | TEA5767_CMD_REPLY));
+        TEST_CHECK(replies[i].client == i + 1 && replies[i].seq == 10 * (i + 1));
+    }
+    TEST_CHECK(radio.frequency == 90.0f && radio.mute_mode);
+    tea5767_encode_registers(radio, expected);
+    TEST_CHECK(memcmp(host_i2c_registers(radio.address), expected, TEA5767_REGISTERS) == 0);
+
+    // Requests that cancel out are acknowledged without touching the bus
+    reply_count = 0;
+    writes = host_i2c_stats.writes;
+    send_set(1, 11, TEA5767_FIELD_MUTE, 0);
+    send_set(2, 21, TEA5767_FIELD_MUTE, 1);
+    TEST_CHECK(!tea5767_broker_flush(&broker));
+    TEST_CHECK(host_i2c_stats.writes == writes);
+    TEST_CHECK(reply_count == 2);
+
+    // A full wait queue forces a write before the next request is staged
+    reply_count = 0;
+    for (uint16_t i = 0; i <= TEA5767_BROKER_WAITING; i++) {
+        send_set(i, i, TEA5767_FIELD_MUTE, i & 1);
+    }
+    TEST_CHECK(reply_count == TEA5767_BROKER_WAITING);
+    TEST_CHECK(broker.waiting_count == 1);
+    tea5767_broker_flush(&broker);
+    TEST_CHECK(reply_count == TEA5767_BROKER_WAITING + 1);
+}
+
+static void test_status(void) {
+    uint8_t registers[TEA5767_REGISTERS];
+    uint8_t age[2] = { 0, 0 };
+
+    setup();
+    send_frame(TEA5767_CMD_STATUS, 1, 1, 0, 0);
+    TEST_CHECK(broker.status_reads == 1);
+    tea5767_encode_registers(radio, registers);
+    TEST_CHECK(replies[0].type == (TEA5767_CMD_STATUS | TEA5767_CMD_REPLY) && replies[0].len == 9);
+    TEST_CHECK(replies[0].payload[0] == 1);
+    TEST_CHECK((replies[0].payload[5] | replies[0].payload[6] << 8) == ((registers[0] & 0x3f) << 8 | registers[1]));
+
+    // Served from the cache within the default age, read again past it or when the client asks for fresh
+    host_advance_us(10000);
+    send_frame(TEA5767_CMD_STATUS, 2, 1, 0, 0);
+    TEST_CHECK(broker.status_reads == 1 && broker.status_hits == 1);
+    TEST_CHECK(replies[1].payload[7] == 10);
+    send_frame(TEA5767_CMD_STATUS, 2, 2, age, sizeof(age));
+    TEST_CHECK(broker.status_reads == 2);
+    host_advance_us(TEA5767_BROKER_STATUS_AGE_MS * 1000 + 1);
+    send_frame(TEA5767_CMD_STATUS, 3, 1, 0, 0);
+    TEST_CHECK(broker.status_reads == 3);
+
+    // A write invalidates the cache
+    send_set(1, 2, TEA5767_FIELD_CHANNEL, 9500);
+    tea5767_broker_flush(&broker);
+    send_frame(TEA5767_CMD_STATUS, 1, 3, 0, 0);
+    TEST_CHECK(broker.status_reads == 4);
+}
+
+static void test_stations(void) {
+    uint8_t since[4] = { 0, 0, 0, 0 };
+    uint8_t expected[TEA5767_CMD_PAYLOAD_MAX];
+
+    setup();
+    tea5767_stations_update(&db, 9470, 12, TEA5767_STATION_STEREO);
+    tea5767_stations_update(&db, 10270, 9, 0);
+    send_frame(TEA5767_CMD_STATIONS, 4, 5, since, sizeof(since));
+    size_t size = tea5767_stations_delta(&db, 0, expected, sizeof(expected));
+    TEST_CHECK(reply_count == 1 && replies[0].type == (TEA5767_CMD_STATIONS | TEA5767_CMD_REPLY));
+    TEST_CHECK(replies[0].len == size && memcmp(replies[0].payload, expected, size) == 0);
+
+    send_frame(TEA5767_CMD_STATIONS, 4, 6, since, 2);
+    TEST_CHECK(replies[1].type == TEA5767_CMD_ERROR && replies[1].payload[0] == TEA5767_ERR_FRAME);
+    broker.db = 0;
+    send_frame(TEA5767_CMD_STATIONS, 4, 7, since, sizeof(since));
+    TEST_CHECK(replies[2].type == TEA5767_CMD_ERROR && replies[2].payload[0] == TEA5767_ERR_TYPE);
+}
+
+static int request_order(const void *a, const void *b) {
+    const request_t *x = a, *y = b;
+    return x->at < y->at ? -1 : x->at > y->at;
+}
+
+static void on_model_reply(uint8_t client, const uint8_t *frame, size_t len, void *user) {
+    uint8_t seq = frame[2];
+    uint64_t latency = time_us_64() - sent_us[client][seq];
+
+    if (!outstanding[client][seq]) {
+        unexpected++;
+        return;
+    }
+    outstanding[client][seq] = false;
+    answered++;
+    latency_sum += latency;
+    if (latency > latency_max) {
+        latency_max = latency;
+    }
+}
+
+// Each client sends every 20 to 80 ms, 30% settings and 70% status. Direct mode writes or reads the tuner
+// for every request, the broker is polled every millisecond with the default status age.
+static uint32_t model_requests(uint16_t clients) {
+    uint32_t count = 0;
+
+    for (uint16_t c = 0; c < clients; c++) {
+        uint64_t at = test_random() % 50000;
+        uint8_t seq = 0;
+        while (at < MODEL_US && count < MODEL_REQUESTS) {
+            request_t *r = &requests[count++];
+            r->at = at;
+            r->client = c;
+            r->seq = seq++;
+            r->type = test_random() % 10 < 3 ? TEA5767_CMD_SET : TEA5767_CMD_STATUS;
+            switch (test_random() % 3) {
+            case 0:
+                r->field = TEA5767_FIELD_MUTE;
+                r->value = test_random() % 2;
+                break;
+            case 1:
+                r->field = TEA5767_FIELD_PROFILE;
+                r->value = test_random() % 2 ? TEA5767_AUDIO_PROFILE_WEAK : TEA5767_AUDIO_PROFILE_HIFI;
+                break;
+            default:
+                r->field = TEA5767_FIELD_CHANNEL;
+                r->value = 9000 + 10 * (test_random() % 5);
+                break;
+            }
+            at += 20000 + test_random() % 60000;
+        }
+    }
+    qsort(requests, count, sizeof(request_t), request_order);
+    return count;
+}
+
+static void model_run(uint16_t clients, bool direct, uint32_t count) {
+    uint8_t fresh[2] = { 0, 0 };
+    uint64_t start = time_us_64();
+    uint32_t reads = host_i2c_stats.reads, writes = host_i2c_stats.writes;
+
+    radio = tea5767_init();
+    tea5767_broker_init(&broker, &radio, 0, on_model_reply, 0);
+    memset(outstanding, 0, sizeof(outstanding));
+    latency_sum = latency_max = 0;
+    answered = unexpected = 0;
+
+    for (uint32_t i = 0; i < count;) {
+        uint64_t now = time_us_64() - start;
+        if (requests[i].at > now) {
+            host_advance_us(direct ? requests[i].at - now : MODEL_POLL_US);
+            continue;
+        }
+        // Everything that has arrived is handed over, then the broker is polled
+        for (; i < count && requests[i].at <= time_us_64() - start; i++) {
+            request_t *r = &requests[i];
+            sent_us[r->client][r->seq] = start + r->at;
+            outstanding[r->client][r->seq] = true;
+            if (r->type == TEA5767_CMD_SET) {
+                uint8_t payload[3] = { r->field, r->value & 0xff, r->value >> 8 };
+                uint8_t frame[TEA5767_CMD_FRAME_MAX];
+                size_t size = tea5767_command_encode(frame, TEA5767_CMD_SET, r->client, r->seq, payload, 3);
+                tea5767_broker_handle(&broker, frame, size);
+            } else {
+                uint8_t frame[TEA5767_CMD_FRAME_MAX];
+                size_t size = tea5767_command_encode(frame, TEA5767_CMD_STATUS, r->client, r->seq, fresh,
+                                                     direct ? sizeof(fresh) : 0);
+                tea5767_broker_handle(&broker, frame, size);
+            }
+            if (direct) {
+                tea5767_broker_flush(&broker);
+            }
+        }
+        if (!direct) {
+            tea5767_broker_flush(&broker);
+        }
+    }
+
+    double seconds = (time_us_64() - start) / 1e6;
+    printf("%7u %-7s %7.0f %10.1f %10.1f %7u %7u\n", clients, direct ? "direct" : "broker", count / seconds,
+           latency_sum / 1000.0 / (answered ? answered : 1), latency_max / 1000.0,
+           host_i2c_stats.writes - writes, host_i2c_stats.reads - reads);
+    TEST_CHECK(answered == count);
+    TEST_CHECK(unexpected == 0);
+}
+
+static void test_model(void) {
+    static const uint16_t clients[] = { 4, 16, 64 };
+
+    printf("%7s %-7s %7s %10s %10s %7s %7s\n", "clients", "mode", "req/s", "mean ms", "max ms", "writes", "reads");
+    for (size_t c = 0; c < sizeof(clients) / sizeof(clients[0]); c++) {
+        uint32_t count = model_requests(clients[c]);
+        uint32_t writes = host_i2c_stats.writes;
+        model_run(clients[c], true, count);
+        uint32_t direct_writes = host_i2c_stats.writes - writes;
+        uint64_t direct_max = latency_max;
+
+        writes = host_i2c_stats.writes;
+        model_run(clients[c], false, count);
+        TEST_CHECK(host_i2c_stats.writes - writes < direct_writes);
+        TEST_CHECK(latency_max < direct_max);
+    }
+}
+
+/************************************
+ * GLOBAL FUNCTIONS
+ ************************************/
+int main() {
+    test_frames();
+    test_set();
+    test_status();
+    test_stations();
+    test_model();
+    printf("command: %u failures\n", test_failures);
+    return TEST_RESULT();
+}
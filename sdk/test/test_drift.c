@@ -0,0 +1,237 @@
+/**
+ ********************************************************************************
+ * @file    test_drift.c
+ * @author  Carlos Egea
+ * @date    18/10/2026
+ * @brief   Host test of the drift tracking. The forgetting least squares fit is checked
+ *          against the same fit in double precision, on exact lines, on a line that moves
+ *          and on the readings it must ignore. The AFC and tea5767_tunePredicted() run on
+ *          a simulated tuner whose oscillator drifts with the temperature.
+ ********************************************************************************
+ */
+
+/************************************
+ * INCLUDES
+ ************************************/
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include "hardware/adc.h"
+#include "tea5767_capture.h"
+#include "tea5767_drift.h"
+#include "test.h"
+
+/************************************
+ * PRIVATE MACROS AND DEFINES
+ ************************************/
+#define DRIFT_HZ_PER_C 1200 // Oscillator drift of the simulated tuner, 12 ppm/C at 100 MHz
+#define DRIFT_ZERO_C 25.0f // Temperature at which it is on frequency
+#define TUNES 400
+
+/************************************
+ * PRIVATE TYPEDEFS
+ ************************************/
+// The fit of tea5767_drift_observe() and tea5767_drift_predict(), in double
+typedef struct {
+double weight;
+double sum_x;
+double sum_y;
+double sum_xx;
+double sum_xy;
+} reference_t;
+
+/************************************
+ * STATIC VARIABLES
+ ************************************/
+static TEA5757_t radio;
+static bool capturing;
+
+/************************************
+ * STATIC FUNCTIONS
+ ************************************/
+// Stands in for the capture engine, which cannot run on the host
+bool tea5767_capture_running(void) {
+    return capturing;
+}
+
+static void reference_observe(reference_t *r, double x, double y) {
+    r->weight = r->weight * TEA5767_DRIFT_DECAY + 1;
+    r->sum_x = r->sum_x * TEA5767_DRIFT_DECAY + x;
+    r->sum_y = r->sum_y * TEA5767_DRIFT_DECAY + y;
+    r->sum_xx = r->sum_xx * TEA5767_DRIFT_DECAY + x * x;
+    r->sum_xy = r->sum_xy * TEA5767_DRIFT_DECAY + x * y;
+}
+
+static double reference_predict(const reference_t *r, double x) {
+    double den = r->weight * r->sum_xx - r->sum_x * r->sum_x;
+    double slope = den > 1e-3 * r->weight * r->weight ? (r->weight * r->sum_xy - r->sum_x * r->sum_y) / den : 0;
+    return (r->sum_y - slope * r->sum_x) / r->weight + slope * x;
+}
+
+// A reading on a strong station with the IF counter off by error counts, taken with the given correction
+static bool observe(TEA5767_drift_t *drift, int16_t pll_offset, int error, float x) {
+    TEA5767_status_t status = { .ready = 1, .level = 12, .ifCounter = TEA5767_IF_CENTER + error };
+
+    radio.pll_offset = pll_offset;
+    return tea5767_drift_observe(drift, radio, &status, x);
+}
+
+static void test_fit(void) {
+    TEA5767_drift_t drift;
+    reference_t reference = { 0 };
+
+    // Nothing learnt, nothing predicted
+    tea5767_drift_init(&drift);
+    TEST_CHECK(tea5767_drift_predict(&drift, 30) == 0);
+
+    // One temperature only: no slope, the mean correction
+    for (int n = 0; n < 20; n++) {
+        TEST_CHECK(observe(&drift, -4, n % 2 ? 2 : 0, 30));
+    }
+    TEST_CHECK(tea5767_drift_predict(&drift, 30) == -5 && tea5767_drift_predict(&drift, 60) == -5);
+
+    // An exact line, y = -0.5 * (x - 30), is found again and extrapolated
+    tea5767_drift_init(&drift);
+    for (int n = 0; n < 200; n++) {
+        int x = 24 + n % 13;
+        TEST_CHECK(observe(&drift, 0, x - 30, x));
+    }
+    TEST_CHECK(tea5767_drift_predict(&drift, 30) == 0);
+    TEST_CHECK(tea5767_drift_predict(&drift, 24) == 3 && tea5767_drift_predict(&drift, 36) == -3);
+    TEST_CHECK(tea5767_drift_predict(&drift, 70) == -20);
+    TEST_CHECK(fabsf(drift.weight - (1 - powf(TEA5767_DRIFT_DECAY, 200)) / (1 - TEA5767_DRIFT_DECAY)) < 0.01f);
+
+    // Noisy readings, and the line moving by 6 steps as the crystal ages. Every prediction follows the
+    // double precision fit, and once the old readings have faded the new line is found.
+    tea5767_drift_init(&drift);
+    for (int n = 0; n < 600; n++) {
+        float x = 15 + (test_random() % 3000) / 100.0f;
+        double line = (n < 300 ? 0 : 6) - 0.4 * (x - 25);
+        // Readings taken near the line, so that the IF counter stays in range
+        int16_t offset = lround(line) + (int)(test_random() % 3) - 1;
+        int error = lround(2 * (offset - line)) + (int)(test_random() % 3) - 1;
+        TEST_CHECK(observe(&drift, offset, error, x));
+        reference_observe(&reference, x, offset - error / 2.0);
+
+        float at = 15 + (test_random() % 3000) / 100.0f;
+        TEST_CHECK(fabs(tea5767_drift_predict(&drift, at) - reference_predict(&reference, at)) <= 0.5 + 1e-3);
+        if (n == 305) {
+            TEST_CHECK(tea5767_drift_predict(&drift, 25) < 3);
+        }
+        if (n >= 500) {
+            TEST_CHECK(labs(tea5767_drift_predict(&drift, at) - lround(6 - 0.4 * (at - 25))) <= 1);
+        }
+    }
+
+    // Weak stations and IF counters out of range are left out
+    TEA5767_drift_t before = drift;
+    TEA5767_status_t weak = { .level = TEA5767_DRIFT_MIN_LEVEL - 1, .ifCounter = TEA5767_IF_CENTER };
+    TEA5767_status_t off = { .level = 15, .ifCounter = TEA5767_IF_MAX + 1 };
+    TEST_CHECK(!tea5767_drift_observe(&drift, radio, &weak, 25));
+    TEST_CHECK(!tea5767_drift_observe(&drift, radio, &off, 25));
+    off.ifCounter = TEA5767_IF_MIN - 1;
+    TEST_CHECK(!tea5767_drift_observe(&drift, radio, &off, 25));
+    TEST_CHECK(memcmp(&before, &drift, sizeof(drift)) == 0);
+}
+
+static int if_error(void) {
+    TEA5767_status_t status;
+
+    tea5767_getStatus(radio, &status);
+    return (int)status.ifCounter - TEA5767_IF_CENTER;
+}
+
+static void test_afc(void) {
+    // Up to 3/4 of the IF counter range, the PLL word is rounded down by up to one more step on top
+    static const int32_t drifts[] = { 0, 8000, -8000, 16000, -16000 };
+
+    radio = tea5767_init();
+    radio.settle_ms = 0;
+    for (uint8_t i = 0; i < sizeof(drifts) / sizeof(drifts[0]); i++) {
+        host_i2c_setDrift(radio.address, drifts[i]);
+        for (float freq = 87.5f; freq < 108.0f; freq += 0.7f) {
+            radio.pll_offset = 0;
+            tea5767_setStation(&radio, freq);
+            uint8_t iterations = tea5767_afc(&radio, 5);
+            TEST_CHECK(iterations <= 3);
+            TEST_CHECK(abs(if_error()) <= TEA5767_AFC_TOLERANCE);
+            // Centred, nothing left to do
+            TEST_CHECK(tea5767_afc(&radio, 5) == 0);
+        }
+    }
+
+    // Stops at the limit given
+    host_i2c_setDrift(radio.address, 16000);
+    radio.pll_offset = 0;
+    tea5767_setStation(&radio, 100.0f);
+    TEST_CHECK(tea5767_afc(&radio, 0) == 0 && radio.pll_offset == 0);
+
+    // With the IF counter out of range there is no station to centre on, and nothing is changed
+    host_i2c_setDrift(radio.address, 40000);
+    tea5767_setStation(&radio, 100.0f);
+    TEST_CHECK(if_error() > TEA5767_IF_MAX - TEA5767_IF_CENTER);
+    TEST_CHECK(tea5767_afc(&radio, 5) == 0 && radio.pll_offset == 0);
+}
+
+// A temperature cycle over a day of tunes, with and without the prediction
+static void test_predicted(void) {
+    TEA5767_drift_t drift;
+    uint32_t plain = 0, plain_late = 0, predicted_late = 0;
+
+    radio = tea5767_init();
+    radio.settle_ms = 0;
+    tea5767_drift_init(&drift);
+    for (uint32_t n = 0; n < TUNES; n++) {
+        float celsius = 30 + 15 * sinf(2 * 3.14159265f * n / (TUNES / 2));
+        float freq = 87.5f + (test_random() % 205) / 10.0f;
+        host_i2c_setDrift(radio.address, (celsius - DRIFT_ZERO_C) * DRIFT_HZ_PER_C);
+
+        uint8_t iterations = tea5767_tunePredicted(&radio, &drift, celsius, freq, 5);
+        TEST_CHECK(abs(if_error()) <= TEA5767_AFC_TOLERANCE);
+        predicted_late += n >= TUNES / 2 ? iterations : 0;
+
+        radio.pll_offset = 0;
+        tea5767_setStation(&radio, freq);
+        iterations = tea5767_afc(&radio, 5);
+        plain += iterations;
+        plain_late += n >= TUNES / 2 ? iterations : 0;
+    }
+    TEST_CHECK(drift.tunes == TUNES);
+    TEST_CHECK(predicted_late * 4 < plain_late);
+    printf("drift %d Hz/C, 15 to 45 C: AFC iterations per tune %.2f predicted (%.2f over the second cycle), "
+           "%.2f without\n", DRIFT_HZ_PER_C, (float)drift.afc_iterations / drift.tunes,
+           (float)predicted_late / (TUNES / 2), (float)plain / TUNES);
+}
+
+static void test_temperature(void) {
+    float celsius = -100;
+
+    host_adc_setTemperature(41.5f);
+    TEST_CHECK(tea5767_drift_readTemperature(&celsius));
+    TEST_CHECK(fabsf(celsius - 41.5f) < 0.5f);
+    host_adc_setTemperature(-10);
+    TEST_CHECK(tea5767_drift_readTemperature(&celsius));
+    TEST_CHECK(fabsf(celsius + 10) < 0.5f);
+    // The block is only reset the first time
+    TEST_CHECK(host_adc_inits == 1);
+
+    // Not while a capture owns the ADC
+    capturing = true;
+    celsius = 100;
+    TEST_CHECK(!tea5767_drift_readTemperature(&celsius));
+    TEST_CHECK(celsius == 100);
+    capturing = false;
+}
+
+/************************************
+ * GLOBAL FUNCTIONS
+ ************************************/
+int main() {
+    radio = tea5767_init();
+    test_fit();
+    test_afc();
+    test_predicted();
+    test_temperature();
+    printf("drift: %u failures\n", test_failures);
+    return TEST_RESULT();
+}
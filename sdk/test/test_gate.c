@@ -0,0 +1,178 @@
+/**
+ ********************************************************************************
+ * @file    test_gate.c
+ * @author  Carlos Egea
+ * @date    18/10/2026
+ * @brief   Host test of the spectral noise gate. Disengaged it has to be an exact delay of
+ *          one hop, engaged with nothing subtracted it has to give the input back 50 dB under
+ *          its level, and on a speech-like programme in white noise it has to raise the SNR by
+ *          a minimum at every input SNR. Built at the default and at the largest frame.
+ ********************************************************************************
+ */
+
+/************************************
+ * INCLUDES
+ ************************************/
+#include <math.h>
+#include <string.h>
+#include "tea5767_audio.h"
+#include "test.h"
+
+/************************************
+ * PRIVATE MACROS AND DEFINES
+ ************************************/
+#define GATE_RATE 16000
+#define GATE_BLOCK (TEA5767_GATE_HOP * 4)
+#define GATE_SECONDS 12
+#define GATE_WARMUP (2 * GATE_RATE) // Samples left out of the SNR, while the noise floor settles
+#define GATE_UNITY_DB 50 // Reconstruction error at unity gain, dB below the input at least
+#define GATE_UNITY_LSB 3 // Or this many LSB rms, the rounding of the windows and twiddles
+// dB the gate has to add at every input SNR below. Longer frames smear the onsets and gain less.
+#define GATE_SNR_GAIN_MIN (TEA5767_GATE_FFT_BITS > 8 ? 5.0 : 8.0)
+
+/************************************
+ * STATIC VARIABLES
+ ************************************/
+static TEA5767_gate_t gate;
+static int16_t block[GATE_BLOCK];
+static int16_t clean[GATE_SECONDS * GATE_RATE];
+static int16_t noise[GATE_SECONDS * GATE_RATE];
+
+/************************************
+ * STATIC FUNCTIONS
+ ************************************/
+// Roughly gaussian, the sum of four uniforms, unit variance
+static float random_normal(void) {
+    float sum = 0;
+
+    for (uint8_t i = 0; i < 4; i++) {
+        sum += (float)test_random() / 4294967296.0f;
+    }
+    return (sum - 2.0f) * 1.7320508f;
+}
+
+// Three tones under a 4 Hz syllable envelope, with a 0.4 s pause every 1.5 s
+static void make_programme(void) {
+    for (uint32_t i = 0; i < GATE_SECONDS * GATE_RATE; i++) {
+        float t = (float)i / GATE_RATE;
+        float envelope = fmodf(t, 1.5f) < 1.1f ? 0.5f - 0.5f * cosf(2 * 3.14159265f * 4 * t) : 0;
+        float tones = sinf(2 * 3.14159265f * 300 * t) + 0.6f * sinf(2 * 3.14159265f * 800 * t)
+                + 0.3f * sinf(2 * 3.14159265f * 1900 * t);
+        clean[i] = lroundf(4000 * envelope * tones);
+        noise[i] = lroundf(1000 * random_normal());
+    }
+}
+
+// Runs the gate over the programme with the noise scaled, and returns the output SNR. The input SNR is
+// returned through in_db. The output is compared to the programme one hop later.
+static double run_snr(float noise_gain, double *in_db) {
+    double signal = 0, in_error = 0, out_error = 0;
+
+    tea5767_audio_gateInit(&gate, 0.1f, 4);
+    tea5767_audio_gateLevel(&gate, 0);
+    for (uint32_t start = 0; start < GATE_SECONDS * GATE_RATE; start += GATE_BLOCK) {
+        for (uint16_t i = 0; i < GATE_BLOCK; i++) {
+            block[i] = lroundf(clean[start + i] + noise_gain * noise[start + i]);
+        }
+        TEST_CHECK(tea5767_audio_gate(&gate, block, GATE_BLOCK, 1));
+        for (uint16_t i = 0; i < GATE_BLOCK; i++) {
+            uint32_t n = start + i;
+            if (n < GATE_WARMUP) {
+                continue;
+            }
+            double s = clean[n - TEA5767_GATE_HOP];
+            signal += s * s;
+            in_error += (double)noise_gain * noise[n] * noise_gain * noise[n];
+            out_error += (block[i] - s) * (block[i] - s);
+        }
+    }
+    *in_db = 10 * log10(signal / in_error);
+    return 10 * log10(signal / out_error);
+}
+
+static void test_delay(void) {
+    int16_t previous[TEA5767_GATE_HOP] = { 0 };
+    uint32_t exact = 0;
+
+    tea5767_audio_gateInit(&gate, 0.1f, 4);
+    for (uint32_t n = 0; n < 200; n++) {
+        int16_t in[GATE_BLOCK];
+        for (uint16_t i = 0; i < GATE_BLOCK; i++) {
+            in[i] = block[i] = test_random();
+        }
+        tea5767_audio_gate(&gate, block, GATE_BLOCK, 1);
+        for (uint16_t i = 0; i < GATE_BLOCK; i++) {
+            int16_t expected = i < TEA5767_GATE_HOP ? previous[i] : in[i - TEA5767_GATE_HOP];
+            exact += block[i] == expected;
+        }
+        memcpy(previous, &in[GATE_BLOCK - TEA5767_GATE_HOP], sizeof(previous));
+    }
+    TEST_CHECK(exact == 200 * GATE_BLOCK);
+    TEST_CHECK(gate.frames == 0);
+
+    // Partial hops are refused and leave the block alone
+    block[0] = 1234;
+    TEST_CHECK(!tea5767_audio_gate(&gate, block, TEA5767_GATE_HOP + 1, 1));
+    TEST_CHECK(block[0] == 1234);
+}
+
+// Engaged with nothing subtracted, every gain stays at one and the frames overlap-add back to the input. The
+// 16 bit transforms lose bits in proportion to the level, so the error is bounded relative to the input.
+static void test_unity(void) {
+    static const uint8_t shifts[] = { 0, 2, 6 }; // Full scale, programme level, quiet
+
+    for (uint8_t s = 0; s < sizeof(shifts) / sizeof(shifts[0]); s++) {
+        int16_t previous[TEA5767_GATE_HOP] = { 0 };
+        double signal = 0, error = 0;
+        int32_t worst = 0;
+
+        tea5767_audio_gateInit(&gate, 0.1f, 0);
+        tea5767_audio_gateLevel(&gate, 0);
+        for (uint32_t n = 0; n < 200; n++) {
+            int16_t in[GATE_BLOCK];
+            for (uint16_t i = 0; i < GATE_BLOCK; i++) {
+                in[i] = block[i] = (int16_t)test_random() >> shifts[s];
+            }
+            tea5767_audio_gate(&gate, block, GATE_BLOCK, 1);
+            for (uint16_t i = 0; n > 0 && i < GATE_BLOCK; i++) {
+                int32_t expected = i < TEA5767_GATE_HOP ? previous[i] : in[i - TEA5767_GATE_HOP];
+                int32_t diff = block[i] - expected;
+                signal += (double)expected * expected;
+                error += (double)diff * diff;
+                worst = diff > worst ? diff : -diff > worst ? -diff : worst;
+            }
+            memcpy(previous, &in[GATE_BLOCK - TEA5767_GATE_HOP], sizeof(previous));
+        }
+        // The first block is left out, it is still mixed with the zeros the gate started with
+        double rms = sqrt(error / (199.0 * GATE_BLOCK));
+        double bound = sqrt(signal / (199.0 * GATE_BLOCK)) * pow(10, -GATE_UNITY_DB / 20.0);
+        TEST_CHECK(gate.frames > 0);
+        TEST_CHECK(rms <= (bound > GATE_UNITY_LSB ? bound : GATE_UNITY_LSB));
+        printf("gate %u points, unity gain, input >> %u: error %.1f LSB rms (%.0f dB), %d LSB worst\n",
+               TEA5767_GATE_FFT, shifts[s], rms, 10 * log10(error / signal), (int)worst);
+    }
+}
+
+static void test_snr(void) {
+    static const float noise_gains[] = { 1.0f, 3.0f, 9.0f };
+
+    make_programme();
+    for (uint8_t i = 0; i < sizeof(noise_gains) / sizeof(noise_gains[0]); i++) {
+        double in_db;
+        double out_db = run_snr(noise_gains[i], &in_db);
+        TEST_CHECK(out_db - in_db >= GATE_SNR_GAIN_MIN);
+        printf("gate %u points, input SNR %5.1f dB: output %5.1f dB (%+.1f)\n", TEA5767_GATE_FFT, in_db, out_db,
+               out_db - in_db);
+    }
+}
+
+/************************************
+ * GLOBAL FUNCTIONS
+ ************************************/
+int main() {
+    test_delay();
+    test_unity();
+    test_snr();
+    printf("gate %u points: %u failures\n", TEA5767_GATE_FFT, test_failures);
+    return TEST_RESULT();
+}
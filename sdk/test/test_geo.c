@@ -0,0 +1,141 @@
+/**
+ ********************************************************************************
+ * @file    test_geo.c
+ * @author  Carlos Egea
+ * @date    18/10/2026
+ * @brief   Host test of the location index. Lookups at the corners of a grid spanning the
+ *          whole world, where offsets pass 2^31, and following across the antimeridian and
+ *          with fixes far apart, where the extrapolation would overflow 32 bits.
+ ********************************************************************************
+ */
+
+/************************************
+ * INCLUDES
+ ************************************/
+#include <string.h>
+#include "tea5767_geo.h"
+#include "test.h"
+
+/************************************
+ * PRIVATE MACROS AND DEFINES
+ ************************************/
+#define DEG_E7 10000000 // One degree
+#define CELLS 100 // Rows and columns of the follow grids
+#define FIRST_CHANNEL 8750
+#define DEFAULT_RANK 1 // 87.5 MHz
+#define TARGET_RANK 11 // 88.5 MHz, only in the cell the extrapolation should land in
+
+/************************************
+ * STATIC VARIABLES
+ ************************************/
+static uint8_t world_cells[18 * 36 * TEA5767_GEO_RANKS];
+static uint8_t cells[CELLS * CELLS * TEA5767_GEO_RANKS];
+static TEA5757_t radio;
+
+/************************************
+ * STATIC FUNCTIONS
+ ************************************/
+// One degree square in 0.01 degree cells, every cell listing the default channel but one
+static TEA5767_geo_t grid(int32_t lat_e7, int32_t lon_e7, uint16_t row, uint16_t col) {
+    TEA5767_geo_t index = {
+        .lat_e7 = lat_e7,
+        .lon_e7 = lon_e7,
+        .cell_e7 = DEG_E7 / CELLS,
+        .rows = CELLS,
+        .cols = CELLS,
+        .first_channel = FIRST_CHANNEL,
+        .cells = cells,
+    };
+
+    memset(cells, 0, sizeof(cells));
+    for (uint32_t i = 0; i < CELLS * CELLS; i++) {
+        cells[i * TEA5767_GEO_RANKS] = DEFAULT_RANK;
+    }
+    cells[(row * CELLS + col) * TEA5767_GEO_RANKS] = TARGET_RANK;
+    return index;
+}
+
+static TEA5767_position_t fix(int32_t lat_e7, int32_t lon_e7) {
+    TEA5767_position_t position = { .lat_e7 = lat_e7, .lon_e7 = lon_e7, .fix = 1 };
+    return position;
+}
+
+static void test_lookup(void) {
+    const TEA5767_geo_t world = {
+        .lat_e7 = -90 * DEG_E7,
+        .lon_e7 = -180 * DEG_E7,
+        .cell_e7 = 10 * DEG_E7,
+        .rows = 18,
+        .cols = 36,
+        .first_channel = FIRST_CHANNEL,
+        .cells = world_cells,
+    };
+
+    TEST_CHECK(tea5767_geo_lookup(&world, -90 * DEG_E7, -180 * DEG_E7) == &world_cells[0]);
+    TEST_CHECK(tea5767_geo_lookup(&world, 0, 0) == &world_cells[(9 * 36 + 18) * TEA5767_GEO_RANKS]);
+    // North east corner, 3.6e9 units from the origin
+    TEST_CHECK(tea5767_geo_lookup(&world, 90 * DEG_E7 - 1, 180 * DEG_E7 - 1)
+               == &world_cells[(17 * 36 + 35) * TEA5767_GEO_RANKS]);
+    TEST_CHECK(tea5767_geo_lookup(&world, 90 * DEG_E7, 0) == NULL);
+    TEST_CHECK(tea5767_geo_lookup(&world, 0, 180 * DEG_E7) == NULL);
+    TEST_CHECK(tea5767_geo_lookup(&world, -90 * DEG_E7 - 1, 0) == NULL);
+    TEST_CHECK(tea5767_geo_lookup(&world, 0, INT32_MIN) == NULL);
+    TEST_CHECK(tea5767_geo_lookup(&world, INT32_MAX, INT32_MAX) == NULL);
+}
+
+static void test_follow(void) {
+    TEA5767_geo_t index;
+    TEA5767_position_t previous, current;
+
+    // Eastbound over the antimeridian, 0.02 degrees per fix, lands 0.04 degrees on at -179.95
+    index = grid(0, -180 * DEG_E7, 50, 5);
+    previous = fix(DEG_E7 / 2 + 50000, 1799900000);
+    current = fix(DEG_E7 / 2 + 50000, -1799900000);
+    radio.frequency = 100.0f;
+    TEST_CHECK(tea5767_geo_follow(&radio, &index, &previous, &current));
+    TEST_CHECK(radio.frequency == 88.5f);
+
+    // Westbound, lands at 179.95
+    index = grid(0, 179 * DEG_E7, 50, 95);
+    radio.frequency = 100.0f;
+    TEST_CHECK(tea5767_geo_follow(&radio, &index, &current, &previous));
+    TEST_CHECK(radio.frequency == 88.5f);
+
+    // Already on a listed frequency, nothing to do
+    TEST_CHECK(!tea5767_geo_follow(&radio, &index, &current, &previous));
+
+    // Plain movement north east inside the grid, lands at 40.04, 3.05
+    index = grid(40 * DEG_E7, 3 * DEG_E7, 4, 5);
+    previous = fix(40 * DEG_E7 + 100000, 3 * DEG_E7 + 200000);
+    current = fix(40 * DEG_E7 + 200000, 3 * DEG_E7 + 300000);
+    radio.frequency = 100.0f;
+    TEST_CHECK(tea5767_geo_follow(&radio, &index, &previous, &current));
+    TEST_CHECK(radio.frequency == 88.5f);
+
+    // Fixes from pole to pole, the latitude is held at the pole. Due north that is just past the top row
+    index = grid(89 * DEG_E7, 0, 99, 50);
+    previous = fix(-90 * DEG_E7 + 1000, DEG_E7 / 2);
+    current = fix(90 * DEG_E7 - 1000, DEG_E7 / 2);
+    radio.frequency = 100.0f;
+    TEST_CHECK(!tea5767_geo_follow(&radio, &index, &previous, &current));
+    TEST_CHECK(radio.frequency == 100.0f);
+    // Due south it is the bottom row of a grid starting at the pole
+    index = grid(-90 * DEG_E7, 0, 0, 50);
+    TEST_CHECK(tea5767_geo_follow(&radio, &index, &current, &previous));
+    TEST_CHECK(radio.frequency == 88.5f);
+
+    // No fix, no retune
+    current.fix = 0;
+    TEST_CHECK(!tea5767_geo_follow(&radio, &index, &previous, &current));
+}
+
+/************************************
+ * GLOBAL FUNCTIONS
+ ************************************/
+int main() {
+    radio = tea5767_init();
+    test_lookup();
+    test_follow();
+    printf("geo: %u failures\n", test_failures);
+    return TEST_RESULT();
+}
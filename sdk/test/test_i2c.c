@@ -0,0 +1,81 @@
+/**
+ ********************************************************************************
+ * @file    test_i2c.c
+ * @author  Carlos Egea
+ * @date    18/10/2026
+ * @brief   Host test of the mux handling of the driver. A simulated tuner address stands in
+ *          for a TCA9548A that acknowledges, an address nobody answers for one that does not.
+ *          A select that was not acknowledged must fail the broadcast, skip the tuner write
+ *          and be retried on the next call instead of being taken as done.
+ ********************************************************************************
+ */
+
+/************************************
+ * INCLUDES
+ ************************************/
+#include "hardware/i2c.h"
+#include "tea5767_i2c.h"
+#include "test.h"
+
+/************************************
+ * PRIVATE MACROS AND DEFINES
+ ************************************/
+#define MUX_ACK (HOST_I2C_TUNER + HOST_I2C_TUNERS - 1) // Answers, so it takes the channel mask
+#define MUX_NACK 0x70 // Nobody there
+
+/************************************
+ * STATIC FUNCTIONS
+ ************************************/
+// Broadcasts to one tuner behind a mux and returns the transfers acknowledged and refused
+static bool broadcast(TEA5757_t *radio, uint8_t mux, uint32_t *writes, uint32_t *nacks) {
+    host_i2c_stats_t before = host_i2c_stats;
+
+    radio->mux_address = mux;
+    bool ok = tea5767_write_broadcast(radio, 1, false);
+    *writes = host_i2c_stats.writes - before.writes;
+    *nacks = host_i2c_stats.nacks - before.nacks;
+    return ok;
+}
+
+static void test_mux(void) {
+    TEA5757_t radio = tea5767_init();
+    uint32_t writes, nacks;
+
+    radio.mux_channel = 2;
+    radio.settle_ms = 0;
+
+    // Refused select, no tuner write, and the next call selects again
+    TEST_CHECK(!broadcast(&radio, MUX_NACK, &writes, &nacks));
+    TEST_CHECK(writes == 0 && nacks == 1);
+    TEST_CHECK(!broadcast(&radio, MUX_NACK, &writes, &nacks));
+    TEST_CHECK(writes == 0 && nacks == 1);
+
+    // Nothing was cached as open, so a working mux is selected straight away
+    TEST_CHECK(broadcast(&radio, MUX_ACK, &writes, &nacks));
+    TEST_CHECK(writes == 2 && nacks == 0);
+    TEST_CHECK(host_i2c_registers(MUX_ACK)[0] == 1 << 2);
+    TEST_CHECK(broadcast(&radio, MUX_ACK, &writes, &nacks));
+    TEST_CHECK(writes == 1 && nacks == 0);
+
+    // Closing the working mux succeeds, opening the other one does not
+    TEST_CHECK(!broadcast(&radio, MUX_NACK, &writes, &nacks));
+    TEST_CHECK(writes == 1 && nacks == 1);
+    // The working mux was closed, it has to be selected again
+    TEST_CHECK(broadcast(&radio, MUX_ACK, &writes, &nacks));
+    TEST_CHECK(writes == 2 && nacks == 0);
+
+    // Plain writes follow the same rule, the mux is closed but the tuner is not written
+    host_i2c_stats_t before = host_i2c_stats;
+    radio.mux_address = MUX_NACK;
+    tea5767_write_registers(radio);
+    TEST_CHECK(host_i2c_stats.writes == before.writes + 1 && host_i2c_stats.nacks == before.nacks + 1);
+}
+
+/************************************
+ * GLOBAL FUNCTIONS
+ ************************************/
+int main() {
+    test_mux();
+    printf("i2c: %u failures\n", test_failures);
+    return TEST_RESULT();
+}
@@ -0,0 +1,183 @@
+/**
+ ********************************************************************************
+ * @file    test_nmea.c
+ * @author  Carlos Egea
+ * @date    18/10/2026
+ * @brief   Host test of the NMEA parser. Sentences are built with their checksum and fed
+ *          in reads of random length, ended by \r\n, \n or \r. Coordinates and times have
+ *          to come out exact, and bad checksums, overlong lines and unfinished sentences
+ *          have to leave the position alone.
+ ********************************************************************************
+ */
+
+/************************************
+ * INCLUDES
+ ************************************/
+#include <stdio.h>
+#include <string.h>
+#include "tea5767_nmea.h"
+#include "test.h"
+
+/************************************
+ * PRIVATE MACROS AND DEFINES
+ ************************************/
+#define STREAM_MAX 4096
+
+/************************************
+ * STATIC VARIABLES
+ ************************************/
+static TEA5767_nmea_t nmea;
+static char stream[STREAM_MAX];
+static size_t stream_len;
+
+/************************************
+ * STATIC FUNCTIONS
+ ************************************/
+// Appends "$body*hh" and the end of line to the stream
+static void append(const char *body, const char *eol) {
+    uint8_t checksum = 0;
+
+    for (const char *p = body; *p; p++) {
+        checksum ^= *p;
+    }
+    stream_len += snprintf(stream + stream_len, STREAM_MAX - stream_len, "$%s*%02X%s", body, checksum, eol);
+}
+
+// Feeds the stream in reads of 1 to 16 characters and returns the sentences that updated the position
+static uint32_t feed_stream(void) {
+    uint32_t updates = 0;
+
+    for (size_t at = 0; at < stream_len;) {
+        size_t read = 1 + test_random() % 16;
+        for (size_t end = at + read; at < end && at < stream_len; at++) {
+            updates += tea5767_nmea_feed(&nmea, stream[at]);
+        }
+    }
+    stream_len = 0;
+    return updates;
+}
+
+static void test_conversion(void) {
+    tea5767_nmea_init(&nmea);
+
+    // 48 07.038' N, 11 31.000' E at 12:35:19.250
+    append("GPRMC,123519.250,A,4807.038,N,01131.000,E,022.4,084.4,230394,003.1,W", "\r\n");
+    TEST_CHECK(feed_stream() == 1);
+    TEST_CHECK(nmea.position.lat_e7 == 481173000);
+    TEST_CHECK(nmea.position.lon_e7 == 115166666);
+    TEST_CHECK(nmea.position.time_ms == (12 * 3600 + 35 * 60) * 1000 + 19250);
+    TEST_CHECK(nmea.position.fix == 1);
+
+    // South and west are negative, a GGA gives the fix quality and the satellites
+    append("GNGGA,235959.999,3356.1234,S,15112.5000,W,2,11,0.9,45.0,M,0.0,M,,", "\r\n");
+    TEST_CHECK(feed_stream() == 1);
+    TEST_CHECK(nmea.position.lat_e7 == -339353900);
+    TEST_CHECK(nmea.position.lon_e7 == -1512083333);
+    TEST_CHECK(nmea.position.time_ms == 86399999);
+    TEST_CHECK(nmea.position.fix == 2 && nmea.position.satellites == 11);
+
+    // Extra decimals are dropped, not rounded, and a void RMC clears the fix but keeps the time
+    append("GPRMC,000000,A,0000.0000099,N,00000.00001,E,,,,,", "\n");
+    TEST_CHECK(feed_stream() == 1);
+    TEST_CHECK(nmea.position.lat_e7 == 0 && nmea.position.lon_e7 == 1);
+    TEST_CHECK(nmea.position.time_ms == 0);
+    append("GPRMC,000001,V,,,,,,,,,", "\n");
+    TEST_CHECK(feed_stream() == 1);
+    TEST_CHECK(nmea.position.fix == 0 && nmea.position.time_ms == 1000);
+    TEST_CHECK(nmea.sentences == 4 && nmea.errors == 0);
+}
+
+static void test_rejected(void) {
+    TEA5767_position_t before;
+
+    tea5767_nmea_init(&nmea);
+    append("GPRMC,101010,A,4000.000,N,00300.000,E,,,,,", "\r\n");
+    TEST_CHECK(feed_stream() == 1);
+    before = nmea.position;
+
+    // Wrong checksum, lowercase or missing digits, no checksum at all
+    const char *bad[] = {
+        "$GPRMC,111111,A,4100.000,N,00400.000,E,,,,,*00\r\n",
+        "$GPRMC,111111,A,4100.000,N,00400.000,E,,,,,*6a\r\n",
+        "$GPRMC,111111,A,4100.000,N,00400.000,E,,,,,*6\r\n",
+        "$GPRMC,111111,A,4100.000,N,00400.000,E,,,,,\r\n",
+    };
+    for (uint8_t i = 0; i < sizeof(bad) / sizeof(bad[0]); i++) {
+        strcpy(stream, bad[i]);
+        stream_len = strlen(stream);
+        TEST_CHECK(feed_stream() == 0);
+    }
+    TEST_CHECK(nmea.errors == 4);
+
+    // One flipped character in a valid sentence
+    append("GPRMC,111111,A,4100.000,N,00400.000,E,,,,,", "\r\n");
+    stream[20] ^= 1;
+    TEST_CHECK(feed_stream() == 0);
+    TEST_CHECK(nmea.errors == 5);
+
+    // A bad hemisphere, and a sentence type that is not used
+    append("GPRMC,111111,A,4100.000,X,00400.000,E,,,,,", "\r\n");
+    append("GPGSV,3,1,11,03,03,111,00,04,15,270,00,06,01,010,00,13,06,292,00", "\r\n");
+    TEST_CHECK(feed_stream() == 0);
+    TEST_CHECK(memcmp(&before, &nmea.position, sizeof(before)) == 0);
+    TEST_CHECK(nmea.sentences == 1 && nmea.errors == 5);
+
+    // Longer than NMEA allows, counted and dropped, and the next sentence is read normally
+    char longer[TEA5767_NMEA_MAX + 16];
+    memset(longer, '0', sizeof(longer) - 1);
+    longer[sizeof(longer) - 1] = '\0';
+    memcpy(longer, "GPRMC,", 6);
+    append(longer, "\r\n");
+    TEST_CHECK(feed_stream() == 0);
+    TEST_CHECK(nmea.errors == 6);
+    append("GPRMC,121212,A,4100.000,N,00400.000,E,,,,,", "\r\n");
+    TEST_CHECK(feed_stream() == 1);
+    TEST_CHECK(nmea.position.lat_e7 == 410000000);
+}
+
+static void test_stream(void) {
+    uint32_t expected = 0;
+
+    tea5767_nmea_init(&nmea);
+
+    // Noise before the first '$', and a sentence cut off by the next one starting
+    memcpy(stream, "\n\r,,*12garbage", 14);
+    stream_len = 14;
+    stream_len += snprintf(stream + stream_len, STREAM_MAX - stream_len, "$GPRMC,0000");
+    append("GPRMC,090000,A,4000.000,N,00300.000,E,,,,,", "\r\n");
+    expected++;
+
+    // Every end of line the receivers send, many sentences per read and one sentence over many
+    for (uint32_t i = 0; i < 40; i++) {
+        char body[TEA5767_NMEA_MAX];
+        snprintf(body, sizeof(body), "GPGGA,09%02u%02u.500,40%02u.000,N,003%02u.000,E,1,%u,0.9,45.0,M,0.0,M,,",
+                 i / 60, i % 60, i % 60, i % 60, 4 + i % 8);
+        append(body, i % 3 == 0 ? "\r\n" : i % 3 == 1 ? "\n" : "\r");
+        expected++;
+    }
+    TEST_CHECK(feed_stream() == expected);
+    TEST_CHECK(nmea.sentences == expected && nmea.errors == 0);
+    TEST_CHECK(nmea.position.time_ms == (9 * 3600) * 1000 + 39 * 1000 + 500);
+    TEST_CHECK(nmea.position.lat_e7 == 400000000 + 39 * 10000000 / 60);
+    TEST_CHECK(nmea.position.satellites == 4 + 39 % 8);
+
+    // Without its end of line a sentence is not used yet
+    append("GPRMC,100000,A,4500.000,N,00300.000,E,,,,,", "");
+    TEST_CHECK(feed_stream() == 0);
+    TEST_CHECK(nmea.position.lat_e7 != 450000000);
+    TEST_CHECK(tea5767_nmea_feed(&nmea, '\r'));
+    TEST_CHECK(!tea5767_nmea_feed(&nmea, '\n'));
+    TEST_CHECK(nmea.position.lat_e7 == 450000000);
+    TEST_CHECK(nmea.sentences == expected + 1 && nmea.errors == 0);
+}
+
+/************************************
+ * GLOBAL FUNCTIONS
+ ************************************/
+int main() {
+    test_conversion();
+    test_rejected();
+    test_stream();
+    printf("nmea: %u failures\n", test_failures);
+    return TEST_RESULT();
+}
@@ -0,0 +1,236 @@
+/**
+ ********************************************************************************
+ * @file    test_ring.c
+ * @author  Carlos Egea
+ * @date    18/10/2026
+ * @brief   Host test of the status ring. A writer thread publishes records whose fields all
+ *          derive from their index while reader threads follow it, so a torn copy that got
+ *          through would show. Laps and a record overwritten while it is read are then forced
+ *          one at a time. Last, the cost of a record with 0 to 64 readers attached.
+ ********************************************************************************
+ */
+
+/************************************
+ * INCLUDES
+ ************************************/
+#include <pthread.h>
+#include <sched.h>
+#include <string.h>
+#include <time.h>
+#include "tea5767_ring.h"
+#include "test.h"
+
+/************************************
+ * PRIVATE MACROS AND DEFINES
+ ************************************/
+#define THREAD_READERS 4
+#define THREAD_RECORDS 2000000
+#define FANOUT_READERS_MAX 64
+#define FANOUT_RECORDS 200000
+
+/************************************
+ * PRIVATE TYPEDEFS
+ ************************************/
+typedef struct {
+TEA5767_reader_t reader;
+uint32_t received;              // Records read whole
+uint32_t torn;                  // Reads refused by tea5767_ring_release()
+uint32_t bad;                   // Records accepted with fields from different writes, or out of order
+} follower_t;
+
+/************************************
+ * STATIC VARIABLES
+ ************************************/
+static TEA5767_ring_t ring;
+static follower_t followers[THREAD_READERS];
+static TEA5767_reader_t fanout[FANOUT_READERS_MAX];
+static volatile bool writing;
+static volatile uint32_t sink; // Keeps the copies alive
+
+/************************************
+ * STATIC FUNCTIONS
+ ************************************/
+static double elapsed_ns(const struct timespec *from, const struct timespec *to) {
+    return (to->tv_sec - from->tv_sec) * 1e9 + (to->tv_nsec - from->tv_nsec);
+}
+
+// Every field from the index, so a copy mixing two writes does not check
+static TEA5767_record_t make_record(uint32_t index) {
+    TEA5767_record_t record;
+
+    memset(&record, 0, sizeof(record));
+    record.time_us = index;
+    record.tuner = index & 0xff;
+    record.status.pll = index * 7;
+    record.status.level = index % 16;
+    record.status.stereo = index & 1;
+    record.status.frequency = 87.5f + (index % 205) / 10.0f;
+    return record;
+}
+
+static bool check_record(const TEA5767_record_t *record) {
+    TEA5767_record_t expected = make_record(record->time_us);
+    return memcmp(record, &expected, sizeof(expected)) == 0;
+}
+
+static void *writer_thread(void *arg) {
+    for (uint32_t i = 0; i < THREAD_RECORDS; i++) {
+        TEA5767_record_t record = make_record(i);
+        tea5767_ring_publish(&ring, &record);
+        // Lets the readers in on a single core host, but now and then runs 8 laps ahead of them
+        if (i % (TEA5767_RING_SIZE / 2) == 0 && i % 4096 >= 8 * TEA5767_RING_SIZE) {
+            sched_yield();
+        }
+    }
+    writing = false;
+    return NULL;
+}
+
+static void *reader_thread(void *arg) {
+    follower_t *follower = arg;
+    TEA5767_record_t copy;
+
+    for (;;) {
+        bool done = !writing;
+        const TEA5767_record_t *record = tea5767_ring_peek(&follower->reader);
+        if (record == NULL) {
+            if (done) {
+                return NULL;
+            }
+            sched_yield();
+            continue;
+        }
+        copy = *record;
+        if (!tea5767_ring_release(&follower->reader)) {
+            follower->torn++;
+            continue;
+        }
+        // The cursor has moved past the record, drops included
+        follower->bad += !check_record(&copy) || copy.time_us != follower->reader.cursor - 1;
+        follower->received++;
+    }
+}
+
+// Readers on other threads: whatever they accept is whole and in order, and accepted plus dropped is everything
+static void test_threads(void) {
+    pthread_t writer, readers[THREAD_READERS];
+
+    TEST_CHECK(tea5767_ring_init(&ring, "status"));
+    writing = true;
+    for (uint8_t i = 0; i < THREAD_READERS; i++) {
+        TEST_CHECK(tea5767_ring_attach(&followers[i].reader, "status"));
+        pthread_create(&readers[i], NULL, reader_thread, &followers[i]);
+    }
+    pthread_create(&writer, NULL, writer_thread, NULL);
+    pthread_join(writer, NULL);
+    for (uint8_t i = 0; i < THREAD_READERS; i++) {
+        follower_t *f = &followers[i];
+        pthread_join(readers[i], NULL);
+        TEST_CHECK(f->bad == 0);
+        TEST_CHECK(f->received + f->reader.dropped == THREAD_RECORDS);
+        printf("ring reader %u: %u read, %u dropped, %u torn and retried\n", i, f->received, f->reader.dropped,
+               f->torn);
+    }
+}
+
+static void test_lapped(void) {
+    TEA5767_reader_t reader;
+    TEA5767_record_t record;
+    const TEA5767_record_t *peeked;
+
+    TEST_CHECK(tea5767_ring_init(&ring, "status"));
+    TEST_CHECK(!tea5767_ring_attach(&reader, "missing"));
+    TEST_CHECK(tea5767_ring_attach(&reader, "status"));
+    TEST_CHECK(tea5767_ring_peek(&reader) == NULL);
+
+    // Lapped before peeking: skips to the oldest record the next publish leaves alone
+    for (uint32_t i = 0; i < TEA5767_RING_SIZE + 10; i++) {
+        record = make_record(i);
+        tea5767_ring_publish(&ring, &record);
+    }
+    peeked = tea5767_ring_peek(&reader);
+    TEST_CHECK(peeked != NULL && peeked->time_us == 11);
+    TEST_CHECK(reader.dropped == 11);
+    TEST_CHECK(tea5767_ring_release(&reader));
+
+    // Overwritten while being read, here by the publish of the record one lap later
+    peeked = tea5767_ring_peek(&reader);
+    TEST_CHECK(peeked != NULL && peeked->time_us == 12);
+    for (uint32_t i = TEA5767_RING_SIZE + 10; i < 2 * TEA5767_RING_SIZE + 12; i++) {
+        record = make_record(i);
+        tea5767_ring_publish(&ring, &record);
+        if (i == TEA5767_RING_SIZE + 12) {
+            TEST_CHECK(peeked->time_us == i);
+        }
+    }
+    TEST_CHECK(!tea5767_ring_release(&reader));
+    // The retry takes the oldest record left and reads it whole
+    peeked = tea5767_ring_peek(&reader);
+    TEST_CHECK(peeked != NULL && peeked->time_us == TEA5767_RING_SIZE + 13 && check_record(peeked));
+    TEST_CHECK(reader.dropped == 11 + TEA5767_RING_SIZE + 1);
+    TEST_CHECK(tea5767_ring_release(&reader));
+
+    // A slot the writer is filling is not handed out, nor accepted back
+    while (tea5767_ring_peek(&reader) != NULL) {
+        tea5767_ring_release(&reader);
+    }
+    TEA5767_slot_t *slot = &ring.slots[ring.head & TEA5767_RING_MASK];
+    slot->seq = 2 * ring.head + 1;
+    TEST_CHECK(tea5767_ring_peek(&reader) == NULL);
+    record = make_record(ring.head);
+    tea5767_ring_publish(&ring, &record);
+    peeked = tea5767_ring_peek(&reader);
+    TEST_CHECK(peeked != NULL && check_record(peeked));
+    slot->seq = 2 * (reader.cursor + TEA5767_RING_SIZE) + 1;
+    TEST_CHECK(!tea5767_ring_release(&reader));
+}
+
+// One publish then every reader reading it, against the publish alone. The writer never looks at the readers,
+// so the figures grow with the readers only by their own reads.
+static void test_fanout(void) {
+    static const uint8_t counts[] = { 0, 1, 8, 32, 64 };
+    struct timespec from, to;
+    double alone_ns = 0;
+
+    printf("%10s %14s %14s %14s\n", "readers", "ns per record", "publish ns", "ns per read");
+    for (uint8_t c = 0; c < sizeof(counts) / sizeof(counts[0]); c++) {
+        uint8_t readers = counts[c];
+        uint32_t read = 0;
+
+        tea5767_ring_init(&ring, "status");
+        for (uint8_t r = 0; r < readers; r++) {
+            tea5767_ring_attach(&fanout[r], "status");
+        }
+        clock_gettime(CLOCK_MONOTONIC, &from);
+        for (uint32_t i = 0; i < FANOUT_RECORDS; i++) {
+            TEA5767_record_t record = make_record(i);
+            tea5767_ring_publish(&ring, &record);
+            for (uint8_t r = 0; r < readers; r++) {
+                const TEA5767_record_t *peeked = tea5767_ring_peek(&fanout[r]);
+                sink += peeked->status.level;
+                read += tea5767_ring_release(&fanout[r]);
+            }
+        }
+        clock_gettime(CLOCK_MONOTONIC, &to);
+        TEST_CHECK(read == (uint32_t)readers * FANOUT_RECORDS);
+
+        double record_ns = elapsed_ns(&from, &to) / FANOUT_RECORDS;
+        if (readers == 0) {
+            alone_ns = record_ns;
+            printf("%10u %14.1f %14.1f %14s\n", readers, record_ns, record_ns, "-");
+        } else {
+            printf("%10u %14.1f %14.1f %14.1f\n", readers, record_ns, alone_ns, (record_ns - alone_ns) / readers);
+        }
+    }
+}
+
+/************************************
+ * GLOBAL FUNCTIONS
+ ************************************/
+int main() {
+    test_lapped();
+    test_threads();
+    test_fanout();
+    printf("ring: %u failures\n", test_failures);
+    return TEST_RESULT();
+}
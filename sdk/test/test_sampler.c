@@ -0,0 +1,125 @@
+/**
+ ********************************************************************************
+ * @file    test_sampler.c
+ * @author  Carlos Egea
+ * @date    18/10/2026
+ * @brief   Host test of the time aligned sampling, 2 to 8 simulated tuners. Each one answers
+ *          at its own address or, as a fixed address TEA5767 has to, behind one mux channel.
+ *          The skew, burst time and common timestamp are checked against the transfers the
+ *          burst makes, and every record has to come back from its own tuner, in order.
+ ********************************************************************************
+ */
+
+/************************************
+ * INCLUDES
+ ************************************/
+#include "hardware/i2c.h"
+#include "tea5767_sampler.h"
+#include "test.h"
+
+/************************************
+ * PRIVATE MACROS AND DEFINES
+ ************************************/
+#define MUX (HOST_I2C_TUNER + HOST_I2C_TUNERS - 1) // Answers, so it takes the channel mask
+#define LEVEL(i) (3 + (i)) // Level given to tuner i, to tell the records apart
+
+/************************************
+ * STATIC VARIABLES
+ ************************************/
+static TEA5757_t radios[TEA5767_SAMPLER_MAX + 1];
+static TEA5767_sample_t sample;
+static TEA5767_ring_t ring;
+
+/************************************
+ * STATIC FUNCTIONS
+ ************************************/
+// One burst of count tuners, with the bus transfers each tuner takes. Returns the skew in ms.
+static float check_burst(uint8_t count, uint8_t transfers, bool shared) {
+    uint64_t start = time_us_64();
+    uint64_t stamps = 0;
+
+    tea5767_sampleAll(radios, count, &sample);
+    TEST_CHECK(sample.count == count);
+    TEST_CHECK(sample.burst_us == count * transfers * HOST_I2C_TRANSFER_US);
+    TEST_CHECK(time_us_64() == start + sample.burst_us);
+    TEST_CHECK(sample.skew_us == (uint32_t)(count - 1) * transfers * HOST_I2C_TRANSFER_US);
+    for (uint8_t i = 0; i < count; i++) {
+        const TEA5767_record_t *record = &sample.records[i];
+        // The midpoint of the tuner's own transfers, the mux select included
+        uint64_t stamp = start + (2 * i + 1) * transfers * HOST_I2C_TRANSFER_US / 2;
+        TEST_CHECK(record->time_us == (uint32_t)stamp);
+        TEST_CHECK(record->tuner == i && record->status.ready);
+        TEST_CHECK(record->status.level == LEVEL(shared ? 0 : i));
+        stamps += stamp;
+    }
+    TEST_CHECK(sample.time_us == stamps / count);
+    return sample.skew_us / 1000.0f;
+}
+
+// A tuner per address, only possible in the simulation: the reads alone
+static void test_direct(float *skew_ms) {
+    for (uint8_t i = 0; i < TEA5767_SAMPLER_MAX; i++) {
+        radios[i] = tea5767_init();
+        radios[i].address = HOST_I2C_TUNER + i;
+        host_i2c_setLevel(radios[i].address, LEVEL(i));
+    }
+    for (uint8_t count = 2; count <= TEA5767_SAMPLER_MAX; count++) {
+        skew_ms[count] = check_burst(count, 1, false);
+    }
+}
+
+// Tuners on the channels of one mux, so every read needs a select first. They all read the one
+// simulated tuner behind it.
+static void test_mux(float *skew_ms) {
+    for (uint8_t i = 0; i < TEA5767_SAMPLER_MAX; i++) {
+        radios[i] = tea5767_init();
+        radios[i].mux_address = MUX;
+        radios[i].mux_channel = i;
+    }
+    host_i2c_setLevel(HOST_I2C_TUNER, LEVEL(0));
+    for (uint8_t count = 2; count <= TEA5767_SAMPLER_MAX; count++) {
+        skew_ms[count] = check_burst(count, 2, true);
+        // The last channel selected is left open, the next burst selects the first one again
+        TEST_CHECK(host_i2c_registers(MUX)[0] == 1 << (count - 1));
+    }
+}
+
+// More tuners than a burst holds are cut to the first ones, and a burst reaches a reader whole
+static void test_publish(void) {
+    TEA5767_reader_t reader;
+
+    for (uint8_t i = 0; i <= TEA5767_SAMPLER_MAX; i++) {
+        radios[i] = tea5767_init();
+        radios[i].address = HOST_I2C_TUNER + i % TEA5767_SAMPLER_MAX;
+    }
+    tea5767_sampleAll(radios, TEA5767_SAMPLER_MAX + 1, &sample);
+    TEST_CHECK(sample.count == TEA5767_SAMPLER_MAX);
+
+    TEST_CHECK(tea5767_ring_init(&ring, "sampler"));
+    TEST_CHECK(tea5767_ring_attach(&reader, "sampler"));
+    tea5767_sample_publish(&ring, &sample);
+    for (uint8_t i = 0; i < sample.count; i++) {
+        const TEA5767_record_t *record = tea5767_ring_peek(&reader);
+        TEST_CHECK(record && record->tuner == i && record->time_us == sample.records[i].time_us);
+        TEST_CHECK(tea5767_ring_release(&reader));
+    }
+    TEST_CHECK(tea5767_ring_peek(&reader) == NULL);
+}
+
+/************************************
+ * GLOBAL FUNCTIONS
+ ************************************/
+int main() {
+    float direct_ms[TEA5767_SAMPLER_MAX + 1], mux_ms[TEA5767_SAMPLER_MAX + 1];
+
+    test_direct(direct_ms);
+    test_mux(mux_ms);
+    test_publish();
+    printf("sampler, %u us per transfer: skew in ms\n", HOST_I2C_TRANSFER_US);
+    printf("%8s %14s %14s\n", "tuners", "own address", "behind a mux");
+    for (uint8_t count = 2; count <= TEA5767_SAMPLER_MAX; count++) {
+        printf("%8u %14.2f %14.2f\n", count, direct_ms[count], mux_ms[count]);
+    }
+    printf("sampler: %u failures\n", test_failures);
+    return TEST_RESULT();
+}
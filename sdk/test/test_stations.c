@@ -0,0 +1,299 @@
+/**
+ ********************************************************************************
+ * @file    test_stations.c
+ * @author  Carlos Egea
+ * @date    18/10/2026
+ * @brief   Host test of the station database. Random updates and removes are mirrored in
+ *          a per-channel model, and after them the columns, the rank and its quality groups
+ *          are checked against it. Receivers kept in sync by deltas, and a saved and loaded
+ *          copy, have to hold the same live stations with a valid rank of their own.
+ ********************************************************************************
+ */
+
+/************************************
+ * INCLUDES
+ ************************************/
+#include <string.h>
+#include "tea5767_stations.h"
+#include "test.h"
+
+/************************************
+ * PRIVATE MACROS AND DEFINES
+ ************************************/
+#define CHANNELS 260 // 87.5 to 113.4 MHz in 100 kHz steps, more than the database holds
+#define FIRST_CHANNEL 8750
+#define OPERATIONS 200000
+#define SYNC_MAX (TEA5767_SYNC_HEADER + TEA5767_STATIONS_MAX * TEA5767_SYNC_ENTRY)
+
+/************************************
+ * PRIVATE TYPEDEFS
+ ************************************/
+typedef struct {
+bool present;                   // In the columns, removed or not
+bool removed;
+uint8_t level;
+uint8_t flags;
+uint32_t version;               // Version of the last change
+} model_t;
+
+/************************************
+ * STATIC VARIABLES
+ ************************************/
+static TEA5767_stations_t db;
+static TEA5767_stations_t receiver;
+static TEA5767_stations_t lagging;      // Synchronised rarely, so it falls behind the floor
+static TEA5767_stations_t loaded;
+static model_t model[CHANNELS];
+static uint8_t message[SYNC_MAX];
+
+/************************************
+ * STATIC FUNCTIONS
+ ************************************/
+static uint16_t channel_of(int c) {
+    return FIRST_CHANNEL + c * 10;
+}
+
+// Invariants any database has to keep, sender or receiver
+static void check_structure(const TEA5767_stations_t *d) {
+    uint8_t live = 0;
+    uint8_t seen[TEA5767_STATIONS_MAX];
+
+    TEST_CHECK(d->count <= TEA5767_STATIONS_MAX);
+    memset(seen, 0, sizeof(seen));
+    for (int i = 0; i < d->count; i++) {
+        TEST_CHECK(i == 0 || d->channel[i - 1] < d->channel[i]);
+        TEST_CHECK(d->quality[i] == TEA5767_STATION_QUALITY(d->level[i], d->flags[i]));
+        if (!(d->flags[i] & TEA5767_STATION_REMOVED)) {
+            live++;
+            TEST_CHECK(d->rank_pos[i] < d->ranked && d->rank[d->rank_pos[i]] == i);
+            TEST_CHECK(tea5767_stations_find(d, d->channel[i]) == i);
+        } else {
+            TEST_CHECK(tea5767_stations_find(d, d->channel[i]) == -1);
+        }
+    }
+    TEST_CHECK(live == d->ranked);
+
+    // The rank lists every live station once, grouped by quality from best to worst
+    for (int r = 0; r < d->ranked; r++) {
+        uint8_t i = d->rank[r];
+        TEST_CHECK(i < d->count && !(d->flags[i] & TEA5767_STATION_REMOVED) && !seen[i]);
+        seen[i] = 1;
+        TEST_CHECK(tea5767_stations_rank(d, r) == i);
+        TEST_CHECK(r == 0 || d->quality[d->rank[r - 1]] >= d->quality[i]);
+    }
+    TEST_CHECK(tea5767_stations_rank(d, d->ranked) == -1);
+
+    // tail[q] counts the ranked stations of quality q or better, so group q sits in [tail[q + 1], tail[q])
+    for (int q = 0; q <= TEA5767_STATION_QUALITIES; q++) {
+        uint8_t better = 0;
+        for (int r = 0; r < d->ranked; r++) {
+            better += d->quality[d->rank[r]] >= q;
+        }
+        TEST_CHECK(d->tail[q] == better);
+    }
+}
+
+// The sender holds exactly the model, removed stations included
+static void check_model(void) {
+    int i = 0;
+
+    for (int c = 0; c < CHANNELS; c++) {
+        if (!model[c].present) {
+            TEST_CHECK(i >= db.count || db.channel[i] != channel_of(c));
+            continue;
+        }
+        TEST_CHECK(i < db.count && db.channel[i] == channel_of(c));
+        if (i >= db.count) {
+            return;
+        }
+        TEST_CHECK(db.level[i] == model[c].level);
+        TEST_CHECK(db.flags[i] == (model[c].flags | (model[c].removed ? TEA5767_STATION_REMOVED : 0)));
+        TEST_CHECK(db.changed[i] == model[c].version);
+        i++;
+    }
+    TEST_CHECK(i == db.count);
+}
+
+// A receiver holds the live stations of the sender and nothing else
+static void check_copy(const TEA5767_stations_t *copy) {
+    TEA5767_station_t station;
+    uint8_t live = 0;
+
+    check_structure(copy);
+    for (int c = 0; c < CHANNELS; c++) {
+        bool expected = model[c].present && !model[c].removed;
+        bool got = tea5767_stations_get(copy, channel_of(c), &station);
+        TEST_CHECK(got == expected);
+        if (got && expected) {
+            TEST_CHECK(station.level == model[c].level && station.flags == model[c].flags);
+        }
+        live += expected;
+    }
+    TEST_CHECK(copy->count == live);
+}
+
+static void op_update(int c, uint8_t level, uint8_t flags) {
+    model_t *m = &model[c];
+    uint32_t version = db.version;
+    bool expected = true;
+    bool change = !m->present || m->removed || m->level != level || m->flags != flags;
+
+    if (!m->present && db.count == TEA5767_STATIONS_MAX) {
+        // The oldest removed station makes room, none means the database is full
+        int oldest = -1;
+        for (int o = 0; o < CHANNELS; o++) {
+            if (model[o].present && model[o].removed && (oldest < 0 || model[o].version < model[oldest].version)) {
+                oldest = o;
+            }
+        }
+        if (oldest < 0) {
+            expected = false;
+            change = false;
+        } else {
+            model[oldest].present = false;
+        }
+    }
+
+    TEST_CHECK(tea5767_stations_update(&db, channel_of(c), level, flags) == expected);
+    if (change) {
+        TEST_CHECK(db.version == version + 1);
+        m->present = true;
+        m->removed = false;
+        m->level = level;
+        m->flags = flags;
+        m->version = db.version;
+    } else {
+        TEST_CHECK(db.version == version);
+    }
+}
+
+static void op_remove(int c) {
+    model_t *m = &model[c];
+    uint32_t version = db.version;
+    bool expected = m->present && !m->removed;
+
+    TEST_CHECK(tea5767_stations_remove(&db, channel_of(c)) == expected);
+    if (expected) {
+        TEST_CHECK(db.version == version + 1);
+        m->removed = true;
+        m->version = db.version;
+    } else {
+        TEST_CHECK(db.version == version);
+    }
+}
+
+static void sync(TEA5767_stations_t *copy) {
+    size_t size = tea5767_stations_delta(&db, copy->version, message, sizeof(message));
+    TEST_CHECK(size > 0);
+    TEST_CHECK(tea5767_stations_apply(copy, message, size));
+    TEST_CHECK(copy->version == db.version);
+}
+
+static void test_random_operations(void) {
+    tea5767_stations_init(&db);
+    tea5767_stations_init(&receiver);
+    tea5767_stations_init(&lagging);
+    memset(model, 0, sizeof(model));
+
+    for (uint32_t n = 0; n < OPERATIONS; n++) {
+        // A few channels get most of the traffic, so levels move by small steps as well as jumps
+        int c = test_random() % 4 ? test_random() % (CHANNELS / 8) : test_random() % CHANNELS;
+        if (test_random() % 10 < 8) {
+            uint8_t level = model[c].present && test_random() % 2 ? (model[c].level + test_random() % 3 + 15) % 16
+                                                                   : test_random() % 16;
+            op_update(c, level, test_random() % 4 == 0 ? TEA5767_STATION_STEREO : model[c].flags);
+        } else {
+            op_remove(c);
+        }
+
+        if (n % 7 == 0 || n % 997 == 0) {
+            sync(&receiver);
+        }
+        if (n % 5000 == 0) {
+            sync(&lagging);
+        }
+        if (n % 997 == 0) {
+            check_structure(&db);
+            check_model();
+            check_copy(&receiver);
+        }
+    }
+    sync(&receiver);
+    sync(&lagging);
+    check_structure(&db);
+    check_model();
+    check_copy(&receiver);
+    check_copy(&lagging);
+    TEST_CHECK(db.floor > 0);
+}
+
+// A delta from another version than the receiver has is refused and changes nothing
+static void test_rejected(void) {
+    TEA5767_stations_t before = receiver;
+
+    tea5767_stations_update(&db, channel_of(0), (model[0].level + 1) % 16, 0);
+    size_t size = tea5767_stations_delta(&db, receiver.version - 1, message, sizeof(message));
+    if (message[0] == TEA5767_SYNC_DELTA) {
+        TEST_CHECK(!tea5767_stations_apply(&receiver, message, size));
+        TEST_CHECK(memcmp(&before, &receiver, sizeof(receiver)) == 0);
+    }
+    TEST_CHECK(!tea5767_stations_apply(&receiver, message, size - 1));
+    TEST_CHECK(memcmp(&before, &receiver, sizeof(receiver)) == 0);
+}
+
+// Levels past 15 would index past the quality groups, from the tuner or from the wire
+static void test_level_range(void) {
+    TEA5767_stations_t before;
+    uint32_t version = db.version;
+    size_t size;
+
+    TEST_CHECK(!tea5767_stations_update(&db, channel_of(1), TEA5767_STATION_LEVEL_MAX + 1, 0));
+    TEST_CHECK(!tea5767_stations_update(&db, channel_of(1), 255, TEA5767_STATION_STEREO));
+    TEST_CHECK(db.version == version);
+    check_structure(&db);
+
+    // One bad entry at the end of a valid delta, then a full dump, refuse the whole message
+    sync(&receiver);
+    before = receiver;
+    // Stations already stored, the database may be full
+    tea5767_stations_update(&db, db.channel[0], (db.level[0] + 1) % 16, 0);
+    tea5767_stations_update(&db, db.channel[1], (db.level[1] + 1) % 16, 0);
+    size = tea5767_stations_delta(&db, receiver.version, message, sizeof(message));
+    TEST_CHECK(message[0] == TEA5767_SYNC_DELTA && message[9] >= 2);
+    message[size - TEA5767_SYNC_ENTRY + 2] = 40;
+    TEST_CHECK(!tea5767_stations_apply(&receiver, message, size));
+    TEST_CHECK(memcmp(&before, &receiver, sizeof(receiver)) == 0);
+
+    size = tea5767_stations_full(&db, message, sizeof(message));
+    message[size - TEA5767_SYNC_ENTRY + 2] = TEA5767_STATION_LEVEL_MAX + 1;
+    TEST_CHECK(!tea5767_stations_apply(&receiver, message, size));
+    TEST_CHECK(memcmp(&before, &receiver, sizeof(receiver)) == 0);
+    TEST_CHECK(!tea5767_stations_load(&loaded, message, size));
+}
+
+static void test_save_load(void) {
+    size_t size = tea5767_stations_save(&db, message, sizeof(message));
+
+    TEST_CHECK(size > 0);
+    TEST_CHECK(tea5767_stations_load(&loaded, message, size));
+    TEST_CHECK(loaded.version == db.version && loaded.floor == db.version);
+    check_copy(&loaded);
+    for (int r = 0; r < loaded.ranked; r++) {
+        TEST_CHECK(loaded.quality[loaded.rank[r]] == db.quality[db.rank[r]]);
+    }
+    message[0] = TEA5767_SYNC_DELTA;
+    TEST_CHECK(!tea5767_stations_load(&loaded, message, size));
+}
+
+/************************************
+ * GLOBAL FUNCTIONS
+ ************************************/
+int main() {
+    test_random_operations();
+    test_save_load();
+    test_rejected();
+    test_level_range();
+    printf("stations (%u max): version %u, %u stored, %u live, %u failures\n", TEA5767_STATIONS_MAX, db.version,
+           db.count, db.ranked, test_failures);
+    return TEST_RESULT();
+}
@@ -0,0 +1,291 @@
+/**
+ ********************************************************************************
+ * @file    test_stats.c
+ * @author  Carlos Egea
+ * @date    18/10/2026
+ * @brief   Host test of the level statistics. Random samples in time order go through a
+ *          1 s rollup stage merged into a 1 min one, and every interval either stage closes
+ *          is checked against aggregates kept per channel and interval, closed once and on
+ *          time. Stations that go quiet have to be closed by the tick and make room. The level
+ *          sketch has to give exact percentiles before and after halving and merging.
+ ********************************************************************************
+ */
+
+/************************************
+ * INCLUDES
+ ************************************/
+#include <string.h>
+#include "tea5767_stats.h"
+#include "test.h"
+
+/************************************
+ * PRIVATE MACROS AND DEFINES
+ ************************************/
+#define SECOND_US 1000000ull
+#define MINUTE_US (60 * SECOND_US)
+#define MODEL_CHANNELS 12 // Fewer than a stage holds, so no sample is refused
+#define MODEL_SECONDS 600
+
+/************************************
+ * PRIVATE TYPEDEFS
+ ************************************/
+typedef struct {
+uint8_t min;
+uint8_t max;
+uint32_t samples;
+uint32_t sum;
+uint32_t stereo;
+uint8_t closed;                 // Times the stage handed the interval over
+} model_t;
+
+/************************************
+ * STATIC VARIABLES
+ ************************************/
+static TEA5767_rollups_t seconds;
+static TEA5767_rollups_t minutes;
+static model_t per_second[MODEL_CHANNELS][MODEL_SECONDS];
+static model_t per_minute[MODEL_CHANNELS][MODEL_SECONDS / 60];
+static uint32_t now_interval; // Second of the sample being added
+static uint32_t closed;
+
+/************************************
+ * STATIC FUNCTIONS
+ ************************************/
+// Channels 88.1, 88.3 ... MHz
+static uint16_t channel_of(int c) {
+    return 8810 + c * 20;
+}
+
+static int channel_index(uint16_t channel) {
+    return (channel - 8810) / 20;
+}
+
+static void model_add(model_t *m, uint8_t min, uint8_t max, uint32_t samples, uint32_t sum, uint32_t stereo) {
+    if (m->samples == 0 || min < m->min) {
+        m->min = min;
+    }
+    if (m->samples == 0 || max > m->max) {
+        m->max = max;
+    }
+    m->samples += samples;
+    m->sum += sum;
+    m->stereo += stereo;
+}
+
+static void check_rollup(const TEA5767_rollup_t *rollup, model_t *m) {
+    TEST_CHECK(m->samples > 0 && m->closed == 0);
+    TEST_CHECK(rollup->min == m->min && rollup->max == m->max);
+    TEST_CHECK(rollup->samples == m->samples && rollup->sum == m->sum && rollup->stereo == m->stereo);
+    m->closed++;
+}
+
+static void on_minute(const TEA5767_rollup_t *rollup, void *user) {
+    check_rollup(rollup, &per_minute[channel_index(rollup->channel)][rollup->interval]);
+}
+
+// Closed seconds are checked, then merged into the minutes
+static void on_second(const TEA5767_rollup_t *rollup, void *user) {
+    // Closed by the first sample after it, not before and not later
+    TEST_CHECK(rollup->interval < now_interval);
+    check_rollup(rollup, &per_second[channel_index(rollup->channel)][rollup->interval]);
+    TEST_CHECK(tea5767_rollup_merge(&minutes, rollup, SECOND_US));
+    closed++;
+}
+
+static void test_cascade(void) {
+    uint64_t time_us = 0;
+    uint32_t expected = 0;
+
+    memset(per_second, 0, sizeof(per_second));
+    memset(per_minute, 0, sizeof(per_minute));
+    tea5767_rollup_init(&seconds, SECOND_US, on_second, NULL);
+    tea5767_rollup_init(&minutes, MINUTE_US, on_minute, NULL);
+
+    while ((time_us += test_random() % 150000) < MODEL_SECONDS * SECOND_US) {
+        int c = test_random() % MODEL_CHANNELS;
+        uint8_t level = test_random() % TEA5767_LEVELS;
+        bool stereo = test_random() % 3 == 0;
+
+        now_interval = time_us / SECOND_US;
+        model_t *m = &per_second[c][now_interval];
+        expected += m->samples == 0;
+        model_add(m, level, level, 1, level, stereo);
+        model_add(&per_minute[c][now_interval / 60], level, level, 1, level, stereo);
+        TEST_CHECK(tea5767_rollup_add(&seconds, channel_of(c), time_us, level, stereo));
+
+        // Only the current second is left open
+        for (uint8_t i = 0; i < seconds.count; i++) {
+            TEST_CHECK(seconds.open[i].interval == now_interval);
+        }
+    }
+    now_interval = UINT32_MAX;
+    tea5767_rollup_flush(&seconds);
+    tea5767_rollup_flush(&minutes);
+    TEST_CHECK(closed == expected && seconds.count == 0 && minutes.count == 0);
+
+    // Every interval with samples was handed over exactly once, by both stages
+    for (int c = 0; c < MODEL_CHANNELS; c++) {
+        for (int s = 0; s < MODEL_SECONDS; s++) {
+            TEST_CHECK(per_second[c][s].closed == (per_second[c][s].samples > 0));
+        }
+        for (int m = 0; m < MODEL_SECONDS / 60; m++) {
+            TEST_CHECK(per_minute[c][m].closed == (per_minute[c][m].samples > 0));
+        }
+    }
+    printf("stats: %u second rollups from %u s of samples on %u channels\n", closed, MODEL_SECONDS,
+           MODEL_CHANNELS);
+}
+
+static void count_closed(const TEA5767_rollup_t *rollup, void *user) {
+    (*(uint32_t *)user)++;
+}
+
+// A full stage refuses new stations until the tick closes the ones that went quiet
+static void test_capacity(void) {
+    uint32_t count = 0;
+
+    tea5767_rollup_init(&seconds, SECOND_US, count_closed, &count);
+    for (int c = 0; c < TEA5767_ROLLUP_STATIONS; c++) {
+        TEST_CHECK(tea5767_rollup_add(&seconds, 8750 + c * 10, 100, 5, false));
+    }
+    TEST_CHECK(!tea5767_rollup_add(&seconds, 10000, 200, 5, false));
+    TEST_CHECK(tea5767_rollup_add(&seconds, 8750, 300, 6, false));
+
+    // Before the intervals end nothing is closed, after it all of them are
+    tea5767_rollup_tick(&seconds, SECOND_US - 1);
+    TEST_CHECK(count == 0 && seconds.count == TEA5767_ROLLUP_STATIONS);
+    tea5767_rollup_tick(&seconds, SECOND_US);
+    TEST_CHECK(count == TEA5767_ROLLUP_STATIONS && seconds.count == 0 && seconds.oldest == UINT32_MAX);
+    TEST_CHECK(tea5767_rollup_add(&seconds, 10000, SECOND_US + 1, 5, false));
+
+    // A sample past the earliest open interval closes it for the other stations too
+    for (int c = 1; c < TEA5767_ROLLUP_STATIONS; c++) {
+        TEST_CHECK(tea5767_rollup_add(&seconds, 8750 + c * 10, SECOND_US + 2, 5, false));
+    }
+    TEST_CHECK(tea5767_rollup_add(&seconds, 8750, 5 * SECOND_US, 5, false));
+    TEST_CHECK(count == 2 * TEA5767_ROLLUP_STATIONS && seconds.count == 1);
+
+    // Both band edges, nothing outside them
+    TEST_CHECK(tea5767_rollup_add(&seconds, TEA5767_STATS_FIRST_CHANNEL, 5 * SECOND_US, 5, false));
+    TEST_CHECK(tea5767_rollup_add(&seconds, TEA5767_STATS_FIRST_CHANNEL + (TEA5767_STATS_CHANNELS - 1) * 10,
+                                  5 * SECOND_US, 5, false));
+    TEST_CHECK(!tea5767_rollup_add(&seconds, TEA5767_STATS_FIRST_CHANNEL - 10, 5 * SECOND_US, 5, false));
+    TEST_CHECK(!tea5767_rollup_add(&seconds, TEA5767_STATS_FIRST_CHANNEL + TEA5767_STATS_CHANNELS * 10,
+                                   5 * SECOND_US, 5, false));
+    TEST_CHECK(seconds.count == 3);
+}
+
+// Percentile straight from counts, as the sorted samples would give it
+static uint8_t model_percentile(const uint32_t *counts, uint8_t percent) {
+    uint64_t total = 0, cumulative = 0;
+
+    for (int l = 0; l < TEA5767_LEVELS; l++) {
+        total += counts[l];
+    }
+    for (int l = 0; l < TEA5767_LEVELS; l++) {
+        cumulative += counts[l];
+        if (total && cumulative * 100 >= total * percent) {
+            return l;
+        }
+    }
+    return 0;
+}
+
+static void check_percentiles(const TEA5767_sketch_t *sketch, const uint32_t *counts) {
+    static const uint8_t percents[] = { 0, 1, 5, 25, 50, 75, 95, 99, 100 };
+
+    for (uint8_t i = 0; i < sizeof(percents) / sizeof(percents[0]); i++) {
+        TEST_CHECK(tea5767_sketch_percentile(sketch, percents[i]) == model_percentile(counts, percents[i]));
+    }
+}
+
+static void test_sketch(void) {
+    TEA5767_sketch_t sketch, other;
+    uint32_t counts[TEA5767_LEVELS] = { 0 };
+    uint32_t other_counts[TEA5767_LEVELS] = { 0 };
+    uint32_t invalid = 0;
+
+    // Exact percentiles, invalid samples left out of them
+    tea5767_sketch_init(&sketch, 9450);
+    TEST_CHECK(tea5767_sketch_total(&sketch) == 0 && tea5767_sketch_percentile(&sketch, 50) == 0);
+    for (uint32_t n = 0; n < 20000; n++) {
+        // Mostly around 9, a tail towards 0
+        uint8_t level = test_random() % 4 ? 7 + test_random() % 5 : test_random() % 16;
+        bool valid = test_random() % 8 != 0;
+        tea5767_sketch_add(&sketch, level, valid);
+        counts[level] += valid;
+        invalid += !valid;
+    }
+    TEST_CHECK(tea5767_sketch_total(&sketch) == 20000 - invalid && sketch.invalid == invalid);
+    check_percentiles(&sketch, counts);
+
+    // A counter about to overflow halves every counter, the invalid one too, and keeps the percentiles
+    for (uint32_t n = sketch.counts[9]; n < UINT16_MAX; n++) {
+        tea5767_sketch_add(&sketch, 9, true);
+    }
+    counts[9] = UINT16_MAX;
+    check_percentiles(&sketch, counts);
+    tea5767_sketch_add(&sketch, 9, true);
+    for (int l = 0; l < TEA5767_LEVELS; l++) {
+        counts[l] = (counts[l] >> 1) + (l == 9);
+        TEST_CHECK(sketch.counts[l] == counts[l]);
+    }
+    TEST_CHECK(sketch.invalid == invalid >> 1);
+    check_percentiles(&sketch, counts);
+    // The invalid counter overflowing halves the levels as well
+    sketch.invalid = UINT16_MAX;
+    tea5767_sketch_add(&sketch, 0, false);
+    TEST_CHECK(sketch.invalid == 32768 && sketch.counts[9] == counts[9] >> 1);
+    for (int l = 0; l < TEA5767_LEVELS; l++) {
+        counts[l] >>= 1;
+    }
+
+    // Merging adds the counts, and halves both sides when a sum would overflow
+    tea5767_sketch_init(&other, 9450);
+    for (uint32_t n = 0; n < 30000; n++) {
+        uint8_t level = test_random() % 16;
+        tea5767_sketch_add(&other, level, true);
+        other_counts[level]++;
+    }
+    TEA5767_sketch_t merged = sketch;
+    TEST_CHECK(tea5767_sketch_merge(&merged, &other));
+    for (int l = 0; l < TEA5767_LEVELS; l++) {
+        TEST_CHECK(merged.counts[l] == counts[l] + other_counts[l]);
+        counts[l] += other_counts[l];
+    }
+    check_percentiles(&merged, counts);
+    // Both invalid counters at 32768
+    TEST_CHECK(tea5767_sketch_merge(&merged, &sketch));
+    for (int l = 0; l < TEA5767_LEVELS; l++) {
+        TEST_CHECK(merged.counts[l] == (counts[l] >> 1) + (sketch.counts[l] >> 1));
+        counts[l] = merged.counts[l];
+    }
+    TEST_CHECK(merged.invalid == 32768);
+    // A level counter past 65535
+    other = merged;
+    other.invalid = 0;
+    other.counts[9] = 50000;
+    TEST_CHECK(tea5767_sketch_merge(&merged, &other));
+    for (int l = 0; l < TEA5767_LEVELS; l++) {
+        TEST_CHECK(merged.counts[l] == (counts[l] >> 1) + ((l == 9 ? 50000 : counts[l]) >> 1));
+    }
+    TEST_CHECK(merged.invalid == 16384);
+
+    // Another station is refused and changes nothing
+    TEA5767_sketch_t before = merged;
+    tea5767_sketch_init(&other, 9460);
+    tea5767_sketch_add(&other, 3, true);
+    TEST_CHECK(!tea5767_sketch_merge(&merged, &other));
+    TEST_CHECK(memcmp(&before, &merged, sizeof(merged)) == 0);
+}
+
+/************************************
+ * GLOBAL FUNCTIONS
+ ************************************/
+int main() {
+    test_cascade();
+    test_capacity();
+    test_sketch();
+    printf("stats: %u failures\n", test_failures);
+    return TEST_RESULT();
+}
@@ -0,0 +1,214 @@
+/**
+ ********************************************************************************
+ * @file    test_wheel.c
+ * @author  Carlos Egea
+ * @date    18/10/2026
+ * @brief   Host test of the timer wheel. Random adds, re-adds and cancels, some of them
+ *          from callbacks, are mirrored in a plain model. Every timer has to fire exactly
+ *          on its tick, once, and the pending count has to match, across a 32-bit tick wrap.
+ ********************************************************************************
+ */
+
+/************************************
+ * INCLUDES
+ ************************************/
+#include "pico/time.h"
+#include "tea5767_wheel.h"
+#include "test.h"
+
+/************************************
+ * PRIVATE MACROS AND DEFINES
+ ************************************/
+#define TIMERS 2048
+#define TICKS 300000 // Ticks of random operations, then the wheel is drained
+#define START (0u - TICKS / 2) // First tick, so the run crosses the wrap
+
+/************************************
+ * PRIVATE TYPEDEFS
+ ************************************/
+typedef struct {
+TEA5767_timer_t timer;          // First field, the callback casts back
+bool pending;                   // Model: added and not fired nor cancelled
+uint32_t due;                   // Model: tick it has to fire on
+uint32_t fired;                 // Times fired
+} model_t;
+
+/************************************
+ * STATIC VARIABLES
+ ************************************/
+static TEA5767_wheel_t wheel;
+static model_t timers[TIMERS];
+static uint32_t pending;
+static bool churn;              // Callbacks add and cancel timers
+
+/************************************
+ * STATIC FUNCTIONS
+ ************************************/
+// Mostly short delays, every level is reached and now and then the clamp
+static uint32_t random_delay(void) {
+    uint32_t r = test_random();
+
+    switch (r % 16) {
+    case 0:
+        return TEA5767_WHEEL_MAX_DELAY + (test_random() & 0xffff);
+    case 1:
+    case 2:
+        return test_random() & 0xfffff;
+    case 3:
+    case 4:
+    case 5:
+        return test_random() & 0x3fff;
+    default:
+        return test_random() & 0xff;
+    }
+}
+
+static void model_add(model_t *m, uint32_t delay) {
+    if (delay > TEA5767_WHEEL_MAX_DELAY) {
+        delay = TEA5767_WHEEL_MAX_DELAY;
+    }
+    if (!m->pending) {
+        pending++;
+    }
+    m->pending = true;
+    m->due = wheel.now + delay;
+    tea5767_wheel_add(&wheel, &m->timer, delay);
+}
+
+static void model_cancel(model_t *m) {
+    if (m->pending) {
+        pending--;
+    }
+    m->pending = false;
+    tea5767_wheel_cancel(&wheel, &m->timer);
+}
+
+static void on_expire(TEA5767_timer_t *timer, void *user) {
+    model_t *m = (model_t *)timer;
+
+    // The tick being fired is the one before wheel.now
+    TEST_CHECK(m->pending);
+    TEST_CHECK(m->due == wheel.now - 1);
+    TEST_CHECK(!tea5767_timer_pending(timer));
+    m->pending = false;
+    m->fired++;
+    pending--;
+
+    // Callbacks may re-arm themselves and cancel or move others, due in the same batch or not
+    switch (churn ? test_random() % 8 : 7) {
+    case 0:
+        model_add(m, random_delay());
+        break;
+    case 1:
+        model_cancel(&timers[test_random() % TIMERS]);
+        break;
+    case 2:
+        model_add(&timers[test_random() % TIMERS], test_random() & 0x3f);
+        break;
+    }
+}
+
+static void check_counts(void) {
+    uint32_t count = 0;
+
+    for (uint32_t i = 0; i < TIMERS; i++) {
+        TEST_CHECK(tea5767_timer_pending(&timers[i].timer) == timers[i].pending);
+        count += timers[i].pending;
+    }
+    TEST_CHECK(count == pending);
+    TEST_CHECK(wheel.count == pending);
+}
+
+static void test_random_operations(void) {
+    uint32_t expected = 0;
+
+    tea5767_wheel_init(&wheel, START);
+    churn = true;
+    for (uint32_t i = 0; i < TIMERS; i++) {
+        tea5767_timer_init(&timers[i].timer, on_expire, 0);
+    }
+
+    for (uint32_t tick = 0; tick < TICKS; tick++) {
+        for (uint8_t op = test_random() % 4; op > 0; op--) {
+            model_t *m = &timers[test_random() % TIMERS];
+            if (test_random() % 4 == 0) {
+                model_cancel(m);
+            } else {
+                model_add(m, random_delay());
+            }
+        }
+        // Mostly one tick at a time, sometimes a jump over several
+        uint32_t to = wheel.now + (test_random() % 16 == 0 ? test_random() % 200 : 0);
+        uint32_t before = wheel.fired;
+        uint32_t fired = tea5767_wheel_advance(&wheel, to);
+        TEST_CHECK(wheel.fired - before == fired);
+        if (tick % 1000 == 0) {
+            check_counts();
+        }
+    }
+    check_counts();
+
+    // Drain, the longest delay is the clamp
+    churn = false;
+    tea5767_wheel_advance(&wheel, wheel.now + TEA5767_WHEEL_MAX_DELAY + 1);
+    check_counts();
+    TEST_CHECK(pending == 0);
+    TEST_CHECK(wheel.count == 0);
+    for (uint32_t i = 0; i < TIMERS; i++) {
+        expected += timers[i].fired;
+    }
+    TEST_CHECK(wheel.fired == expected);
+    TEST_CHECK(wheel.cascaded > 0);
+}
+
+// Delay 0 fires on the next tick, and an empty wheel jumps straight to the target
+static void test_edges(void) {
+    model_t *m = &timers[0];
+
+    tea5767_wheel_init(&wheel, 0xfffffff0u);
+    tea5767_timer_init(&m->timer, on_expire, 0);
+    m->pending = false;
+    m->fired = 0;
+    pending = 0;
+
+    TEST_CHECK(tea5767_wheel_advance(&wheel, 0x10) == 0);
+    TEST_CHECK(wheel.now == 0x11);
+
+    tea5767_wheel_add(&wheel, &m->timer, 0);
+    m->pending = true;
+    m->due = wheel.now;
+    pending = 1;
+    TEST_CHECK(tea5767_wheel_advance(&wheel, wheel.now - 1) == 0);
+    TEST_CHECK(tea5767_wheel_advance(&wheel, wheel.now) == 1);
+    TEST_CHECK(m->fired == 1);
+}
+
+// Polling converts the clock to ticks
+static void test_poll(void) {
+    model_t *m = &timers[0];
+
+    tea5767_wheel_init(&wheel, time_us_64() / TEA5767_WHEEL_TICK_US);
+    tea5767_timer_init(&m->timer, on_expire, 0);
+    m->pending = true;
+    m->fired = 0;
+    m->due = wheel.now + 5;
+    pending = 1;
+    tea5767_wheel_add(&wheel, &m->timer, 5);
+
+    host_advance_us(4 * TEA5767_WHEEL_TICK_US);
+    TEST_CHECK(tea5767_wheel_poll(&wheel) == 0);
+    host_advance_us(TEA5767_WHEEL_TICK_US);
+    TEST_CHECK(tea5767_wheel_poll(&wheel) == 1);
+    TEST_CHECK(m->fired == 1);
+}
+
+/************************************
+ * GLOBAL FUNCTIONS
+ ************************************/
+int main() {
+    test_random_operations();
+    test_edges();
+    test_poll();
+    printf("wheel: %u fired, %u cascaded, %u failures\n", wheel.fired, wheel.cascaded, test_failures);
+    return TEST_RESULT();
+}
@@ -0,0 +1,325 @@
+/**
+ ********************************************************************************
+ * @file    wcet.c
+ * @author  Carlos Egea
+ * @date    18/10/2026
+ * @brief   Worst-case execution time harness for the TEA5767 driver API.
+ ********************************************************************************
+ */
+
+/************************************
+ * INCLUDES
+ ************************************/
+#include <stdio.h>
+#include "pico/stdlib.h"
+#include "hardware/clocks.h"
+#include "hardware/i2c.h"
+#include "hardware/structs/systick.h"
+#include "tea5767_i2c.h"
+#include "tea5767_calib.h"
+#include "tea5767_drift.h"
+#include "tea5767_profile.h"
+
+/************************************
+ * PRIVATE MACROS AND DEFINES
+ ************************************/
+#define WCET_ITERATIONS 20 // Calls per operation and condition
+#define WCET_FAULT_ADDRESS 0x61 // Address with no device behind it, every transfer NACKs
+#define WCET_PROFILE_PERIOD_US 500 // Profiler sample period when built with TEA5767_PROFILE
+#define WCET_AFC_ITERATIONS 4 // AFC corrections allowed per call
+#define WCET_SYSTICK_MAX 0x00ffffff // SysTick is a 24 bit down counter
+
+/************************************
+ * PRIVATE TYPEDEFS
+ ************************************/
+typedef void (*wcet_op_fn)(TEA5757_t *radio, int i);
+
+typedef struct {
+    const char *name;   // Public API name
+    wcet_op_fn fn;      // Wrapper exercising the call
+    uint64_t max_us;    // Worst case over all conditions
+    uint64_t min_us;    // Best case over all conditions
+    uint64_t total_us;  // Sum, for the mean
+    uint64_t max_cycles; // Worst case in processor cycles
+    uint64_t max_bus_us; // Longest time a single call spent in I2C transfers
+    uint64_t total_bus_us; // Sum, for the mean
+    uint32_t calls;     // Number of measured calls
+} wcet_entry_t;
+
+typedef struct {
+    const char *name;           // Condition name
+    uint8_t address;            // I2C address used for the run
+    bool band_edges;            // Alternate between band limits (largest PLL step)
+} wcet_condition_t;
+
+/************************************
+ * STATIC VARIABLES
+ ************************************/
+static const wcet_condition_t conditions[] = {
+    { "nominal", 0x60, false },
+    { "band_edges", 0x60, true },
+    { "bus_fault", WCET_FAULT_ADDRESS, true },
+};
+
+static bool edges;
+static uint64_t systick_us; // Above this the count may have wrapped, cycles come from the timer
+static uint64_t bus_us; // Time spent in I2C transfers so far
+
+/************************************
+ * STATIC FUNCTIONS
+ ************************************/
+/*
+ * The firmware is linked with --wrap for the two blocking I2C transfers the driver uses, so every
+ * transfer is timed on its way through without touching the driver.
+ */
+int __real_i2c_write_blocking(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, bool nostop);
+int __real_i2c_read_blocking(i2c_inst_t *i2c, uint8_t addr, uint8_t *dst, size_t len, bool nostop);
+
+int __wrap_i2c_write_blocking(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, bool nostop) {
+    uint64_t start = time_us_64();
+    int result = __real_i2c_write_blocking(i2c, addr, src, len, nostop);
+    bus_us += time_us_64() - start;
+    return result;
+}
+
+int __wrap_i2c_read_blocking(i2c_inst_t *i2c, uint8_t addr, uint8_t *dst, size_t len, bool nostop) {
+    uint64_t start = time_us_64();
+    int result = __real_i2c_read_blocking(i2c, addr, dst, len, nostop);
+    bus_us += time_us_64() - start;
+    return result;
+}
+
+static float wcet_freq(int i) {
+    if (edges) {
+        return (i & 1) ? MAX_FREQ_EU : MIN_FREQ_EU;
+    }
+    return 100.0 + (i % 10) * 0.1;
+}
+
+static void op_read_raw(TEA5757_t *radio, int i) {
+    uint8_t buf[TEA5767_REGISTERS];
+    tea5767_read_raw(*radio, buf);
+}
+
+static void op_write_registers(TEA5757_t *radio, int i) {
+    radio->frequency = wcet_freq(i);
+    tea5767_write_registers(*radio);
+}
+
+static void op_getStation(TEA5757_t *radio, int i) {
+    tea5767_getStation(radio);
+}
+
+static void op_getReady(TEA5757_t *radio, int i) {
+    tea5767_getReady(radio);
+}
+
+static void op_setSearch(TEA5757_t *radio, int i) {
+    tea5767_setSearch(radio, 0, i & 1);
+}
+
+static void op_checkFreqLimits(TEA5757_t *radio, int i) {
+    tea5767_checkFreqLimits(*radio, (i & 1) ? 120.0 : 60.0);
+}
+
+static void op_setStation(TEA5757_t *radio, int i) {
+    tea5767_setStation(radio, wcet_freq(i));
+}
+
+static void op_setStationInc(TEA5757_t *radio, int i) {
+    // Full band swing in alternating directions
+    tea5767_setStationInc(radio, (i & 1) ? MIN_FREQ_EU - MAX_FREQ_EU : MAX_FREQ_EU - MIN_FREQ_EU);
+    radio->searchMode = false;
+}
+
+static void op_setMute(TEA5757_t *radio, int i) {
+    tea5767_setMute(radio, i & 1);
+}
+
+static void op_setSoftMute(TEA5757_t *radio, int i) {
+    tea5767_setSoftMute(radio, i & 1);
+}
+
+static void op_setAudioProfile(TEA5757_t *radio, int i) {
+    tea5767_setAudioProfile(radio, (i & 1) ? TEA5767_AUDIO_PROFILE_WEAK : TEA5767_AUDIO_PROFILE_HIFI);
+}
+
+static void op_setMuteLeft(TEA5757_t *radio, int i) {
+    tea5767_setMuteLeft(radio, i & 1);
+}
+
+static void op_setMuteRight(TEA5757_t *radio, int i) {
+    tea5767_setMuteRight(radio, i & 1);
+}
+
+static void op_setStandby(TEA5757_t *radio, int i) {
+    tea5767_setStandby(radio, i & 1);
+}
+
+static void op_setStereo(TEA5757_t *radio, int i) {
+    tea5767_setStereo(radio, i & 1);
+}
+
+static void op_encode_registers(TEA5757_t *radio, int i) {
+    uint8_t registers[TEA5767_REGISTERS];
+    radio->frequency = wcet_freq(i);
+    tea5767_encode_registers(*radio, registers);
+}
+
+static void op_decode_status(TEA5757_t *radio, int i) {
+    // Ready, stereo, full level, which walks every field
+    uint8_t buf[TEA5767_REGISTERS] = { 0xb0 | (i & 0x3f), 0x12, 0x80 | (i & 0x7f), 0xf0, 0x00 };
+    TEA5767_status_t status;
+    tea5767_decode_status(buf, radio->pll_offset, &status);
+}
+
+static void op_getStatus(TEA5757_t *radio, int i) {
+    TEA5767_status_t status;
+    tea5767_getStatus(*radio, &status);
+}
+
+static void op_write_broadcast(TEA5757_t *radio, int i) {
+    // Every copy on the same address without a mux, so nothing is grouped: one write and one readback each
+    static TEA5757_t radios[TEA5767_BROADCAST_MAX];
+    for (uint8_t r = 0; r < TEA5767_BROADCAST_MAX; r++) {
+        radios[r] = *radio;
+    }
+    radios[0].frequency = wcet_freq(i);
+    tea5767_write_broadcast(radios, TEA5767_BROADCAST_MAX, true);
+}
+
+static void op_afc(TEA5757_t *radio, int i) {
+    radio->frequency = wcet_freq(i);
+    tea5767_afc(radio, WCET_AFC_ITERATIONS);
+    radio->pll_offset = 0;
+}
+
+static void op_calibrate(TEA5757_t *radio, int i) {
+    // Settings restored so that the other operations keep their conditions
+    TEA5757_t saved = *radio;
+    TEA5767_calibration_t calibration;
+    tea5767_calibrate(radio, wcet_freq(i), &calibration);
+    *radio = saved;
+}
+
+static wcet_entry_t entries[] = {
+    { "tea5767_read_raw", op_read_raw },
+    { "tea5767_write_registers", op_write_registers },
+    { "tea5767_getStation", op_getStation },
+    { "tea5767_getReady", op_getReady },
+    { "tea5767_setSearch", op_setSearch },
+    { "tea5767_checkFreqLimits", op_checkFreqLimits },
+    { "tea5767_setStation", op_setStation },
+    { "tea5767_setStationInc", op_setStationInc },
+    { "tea5767_setMute", op_setMute },
+    { "tea5767_setSoftMute", op_setSoftMute },
+    { "tea5767_setAudioProfile", op_setAudioProfile },
+    { "tea5767_setMuteLeft", op_setMuteLeft },
+    { "tea5767_setMuteRight", op_setMuteRight },
+    { "tea5767_setStandby", op_setStandby },
+    { "tea5767_setStereo", op_setStereo },
+    { "tea5767_encode_registers", op_encode_registers },
+    { "tea5767_decode_status", op_decode_status },
+    { "tea5767_getStatus", op_getStatus },
+    { "tea5767_write_broadcast", op_write_broadcast },
+    { "tea5767_afc", op_afc },
+    { "tea5767_calibrate", op_calibrate },
+};
+
+#define WCET_ENTRIES (sizeof(entries) / sizeof(entries[0]))
+
+static void wcet_measure(wcet_entry_t *entry, TEA5757_t *radio, uint32_t clk_mhz) {
+    for (int i = 0; i < WCET_ITERATIONS; i++) {
+        uint64_t bus_start = bus_us;
+        uint64_t start = time_us_64();
+        uint32_t start_cycles = systick_hw->cvr;
+        entry->fn(radio, i);
+        uint32_t end_cycles = systick_hw->cvr;
+        uint64_t elapsed = time_us_64() - start;
+        uint64_t bus = bus_us - bus_start;
+
+        uint64_t cycles = elapsed < systick_us ? (start_cycles - end_cycles) & WCET_SYSTICK_MAX : elapsed * clk_mhz;
+        if (cycles > entry->max_cycles) {
+            entry->max_cycles = cycles;
+        }
+        if (bus > entry->max_bus_us) {
+            entry->max_bus_us = bus;
+        }
+        entry->total_bus_us += bus;
+        if (elapsed > entry->max_us) {
+            entry->max_us = elapsed;
+        }
+        if (elapsed < entry->min_us) {
+            entry->min_us = elapsed;
+        }
+        entry->total_us += elapsed;
+        entry->calls++;
+    }
+}
+
+static void wcet_print(void) {
+    printf("%-26s %10s %10s %10s %12s %12s %12s\n", "operation", "min_us", "mean_us", "max_us", "max_cycles",
+           "mean_bus_us", "max_bus_us");
+    for (size_t e = 0; e < WCET_ENTRIES; e++) {
+        wcet_entry_t *entry = &entries[e];
+        printf("%-26s %10llu %10llu %10llu %12llu %12llu %12llu\n", entry->name,
+               (unsigned long long)entry->min_us,
+               (unsigned long long)(entry->total_us / entry->calls),
+               (unsigned long long)entry->max_us,
+               (unsigned long long)entry->max_cycles,
+               (unsigned long long)(entry->total_bus_us / entry->calls),
+               (unsigned long long)entry->max_bus_us);
+    }
+}
+
+/************************************
+ * GLOBAL FUNCTIONS
+ ************************************/
+int main() {
+    stdio_init_all();
+    sleep_ms(5000);
+
+    uint64_t start = time_us_64();
+    TEA5757_t radio = tea5767_init();
+    uint64_t init_us = time_us_64() - start;
+
+    for (size_t e = 0; e < WCET_ENTRIES; e++) {
+        entries[e].min_us = UINT64_MAX;
+    }
+
+    // SysTick free running on the processor clock, the M0+ has no cycle counter. It wraps every 2^24 cycles,
+    // 84 ms at 200 MHz: calls longer than half of that, the settling ones, get their cycles from the timer.
+    uint32_t clk_hz = clock_get_hz(clk_sys);
+    uint32_t clk_mhz = clk_hz / 1000000;
+    systick_hw->rvr = WCET_SYSTICK_MAX;
+    systick_hw->cvr = 0;
+    systick_hw->csr = 0x5;
+    systick_us = ((uint64_t)WCET_SYSTICK_MAX + 1) * 1000000 / clk_hz / 2;
+
+#ifdef TEA5767_PROFILE
+    tea5767_profile_start(WCET_PROFILE_PERIOD_US);
+#endif
+
+    for (size_t c = 0; c < sizeof(conditions) / sizeof(conditions[0]); c++) {
+        printf("Running condition %s...\n", conditions[c].name);
+        radio.address = conditions[c].address;
+        edges = conditions[c].band_edges;
+        for (size_t e = 0; e < WCET_ENTRIES; e++) {
+            wcet_measure(&entries[e], &radio, clk_mhz);
+        }
+    }
+
+    printf("\nWCET over %d calls per condition, clk_sys %lu MHz\n", WCET_ITERATIONS, (unsigned long)clk_mhz);
+    printf("%-26s %10llu\n", "tea5767_init", (unsigned long long)init_us);
+    wcet_print();
+
+#ifdef TEA5767_PROFILE
+    tea5767_profile_stop();
+    tea5767_profile_dump();
+#endif
+
+    while (true) {
+        sleep_ms(1000);
+    }
+    return 0;
+}